@@ -0,0 +1,5 @@
+// Подмена operator new/delete для aip_bench_alloc (см. bench/CMakeLists.txt).
+
+#include <aip/profile/alloc_tracking.hpp>
+
+AIP_DEFINE_ALLOCATION_HOOKS();
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/model/flat_evaluator.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+
+namespace aip::bench {
+
+/// Домен-полуинтервал [lo, hi).
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+/// Синтетическая модель a*x^2 + b*x + c: три параметра, дешёвый operator().
+struct Quad final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"a"}> a{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"c"}> c{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override {
+        return (a.value * x + b.value) * x + c.value;
+    }
+
+    /// Пакетное ядро без виртуального вызова на точку (векторизуется компилятором).
+    void evaluate(std::span<const double> xs, std::span<double> out) const override {
+        if (out.size() < xs.size()) throw std::invalid_argument("Quad::evaluate: out is too small");
+        const double ka = a.value, kb = b.value, kc = c.value;
+        for (std::size_t i = 0; i < xs.size(); ++i) out[i] = (ka * xs[i] + kb) * xs[i] + kc;
+    }
+};
+
+using QuadGrid = aip::params::ParamGrid<Quad, aip::params::UniformRange, &Quad::a, &Quad::b, &Quad::c>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+
+/// Решётка примерно из side^3 кандидатов.
+inline QuadGrid makeGrid(std::size_t side) {
+    const double step = side > 1 ? 2.0 / static_cast<double>(side - 1) : 1.0;
+    QuadGrid g;
+    g.get<0>() = {-1.0, 1.0, step};
+    g.get<1>() = {-1.0, 1.0, step};
+    g.get<2>() = {-1.0, 1.0, step};
+    return g;
+}
+
+/// Оркестратор из entries сегментов на [0, entries), у каждого решётка makeGrid(side).
+inline Orch makeOrchestrator(std::size_t entries, std::size_t side) {
+    Orch orch;
+    for (std::size_t e = 0; e < entries; ++e) {
+        orch.add(Seg{static_cast<double>(e), static_cast<double>(e + 1)}, makeGrid(side));
+    }
+    return orch;
+}
+
+/// Равномерный датасет на [0, entries).
+inline std::vector<double> makeInputs(std::size_t points, std::size_t entries) {
+    std::vector<double> xs(points);
+    for (std::size_t i = 0; i < points; ++i) {
+        xs[i] = static_cast<double>(entries) * static_cast<double>(i) / static_cast<double>(points);
+    }
+    return xs;
+}
+
+}  // namespace aip::bench
+
+template <>
+struct aip::model::IntervalDomainTraits<aip::bench::Seg> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const aip::bench::Seg& s) noexcept { return {s.lo, s.hi}; }
+};
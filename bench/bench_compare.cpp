@@ -0,0 +1,346 @@
+// Запуск aip_bench с повторениями, запись базовой линии и сравнение с ней.
+//
+//   aip_bench_compare --bench <path/to/aip_bench> --baseline-dir <dir>
+//                     [--repetitions N] [--threshold 0.10] [--filter REGEX] [--key REGEX] [--update]
+//
+// Базовая линия — JSON-файл в baseline-dir, имя которого зависит от модели CPU и компилятора:
+// на другой машине/компиляторе сравнение начинается с новой базовой линии, а не с ложной регрессии.
+//
+// Для каждого бенчмарка берётся медиана real_time по повторениям и MAD (median absolute deviation).
+// Регрессия — медиана хуже базовой более чем на threshold И разница больше kNoiseFactor * MAD
+// (шум не даёт ложных срабатываний). Для BM_parallelForIndicesAsync дополнительно сравнивается
+// эффективность масштабирования T потоков: time(1) / (T * time(T)).
+//
+// Код возврата: 0 — нет регрессий в ключевых бенчмарках (--key) или базовая линия только что записана;
+// 1 — регрессия; 2 — ошибка запуска/разбора.
+
+#include <map>
+#include <cmath>
+#include <cctype>
+#include <regex>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include "json_lite.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+using aip::bench::json::Value;
+
+constexpr double kNoiseFactor = 3.0;
+constexpr double kMadToSigma = 1.4826;  // MAD -> оценка sigma для нормального распределения
+
+struct Options {
+    std::string bench;
+    fs::path baselineDir;
+    int repetitions{5};
+    double threshold{0.10};
+    std::string filter{"."};
+    std::string key{"BM_Orchestrator_makePiecewise|BM_parallelForIndicesAsync"};
+    bool update{false};
+};
+
+struct Stat {
+    double median{0};
+    double mad{0};
+    std::size_t samples{0};
+};
+
+std::string compilerId() {
+#if defined(__clang__)
+    return "clang-" + std::to_string(__clang_major__) + "." + std::to_string(__clang_minor__);
+#elif defined(__GNUC__)
+    return "gcc-" + std::to_string(__GNUC__) + "." + std::to_string(__GNUC_MINOR__);
+#elif defined(_MSC_VER)
+    return "msvc-" + std::to_string(_MSC_VER);
+#else
+    return "unknown-compiler";
+#endif
+}
+
+std::string cpuModel() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            const auto colon = line.find(':');
+            if (colon != std::string::npos) return line.substr(colon + 1);
+        }
+    }
+    return "unknown-cpu";
+}
+
+std::string sanitize(const std::string& s) {
+    std::string out;
+    for (const char c : s) {
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-')
+            out.push_back(c);
+        else if (!out.empty() && out.back() != '_')
+            out.push_back('_');
+    }
+    while (!out.empty() && out.back() == '_') out.pop_back();
+    return out;
+}
+
+double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const std::size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+Stat summarize(const std::vector<double>& samples) {
+    Stat s;
+    s.samples = samples.size();
+    s.median = median(samples);
+    std::vector<double> dev;
+    dev.reserve(samples.size());
+    for (const double x : samples) dev.push_back(std::abs(x - s.median));
+    s.mad = median(dev);
+    return s;
+}
+
+double toNanoseconds(double t, const std::string& unit) {
+    if (unit == "us") return t * 1e3;
+    if (unit == "ms") return t * 1e6;
+    if (unit == "s") return t * 1e9;
+    return t;
+}
+
+std::string readFile(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + p.string());
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+/// Имя во временном каталоге, уникальное для запуска: параллельные сравнения не перезаписывают файлы друг друга.
+fs::path uniqueTempPath(const std::string& stem, const std::string& ext) {
+    std::random_device rd;
+    std::mt19937_64 gen((static_cast<std::uint64_t>(rd()) << 32) ^ rd() ^
+                        static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    for (;;) {
+        std::ostringstream name;
+        name << stem << '-' << std::hex << gen() << ext;
+        fs::path p = fs::temp_directory_path() / name.str();
+        if (!fs::exists(p)) return p;
+    }
+}
+
+/// Аргумент для std::system: одинарные кавычки для sh, двойные для cmd.exe.
+std::string shellQuote(const std::string& s) {
+#ifdef _WIN32
+    std::string out = "\"";
+    for (const char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + '"';
+#else
+    std::string out = "'";
+    for (const char c : s) {
+        if (c == '\'') {
+            out += "'\\''";
+        } else {
+            out += c;
+        }
+    }
+    return out + '\'';
+#endif
+}
+
+/// Запустить бенчмарк и собрать медиану/MAD real_time (нс) по каждому run_name.
+std::map<std::string, Stat> runSuite(const Options& opt) {
+    // Консольный вывод бенчмарка — в свой файл (перенаправление "> file" понимают и sh, и cmd.exe);
+    // при ошибке он остаётся для разбора.
+    const fs::path out = uniqueTempPath("aip_bench_compare", ".json");
+    const fs::path log = uniqueTempPath("aip_bench_compare", ".log");
+    std::string cmd = shellQuote(opt.bench) + " --benchmark_repetitions=" + std::to_string(opt.repetitions) +
+                      " --benchmark_filter=" + shellQuote(opt.filter) +
+                      " --benchmark_out_format=json --benchmark_out=" + shellQuote(out.string()) + " > " +
+                      shellQuote(log.string());
+#ifdef _WIN32
+    cmd = '"' + cmd + '"';  // cmd /c снимает внешние кавычки
+#endif
+    if (std::system(cmd.c_str()) != 0) {
+        fs::remove(out);
+        throw std::runtime_error("benchmark run failed: " + cmd + " (output: " + log.string() + ")");
+    }
+    fs::remove(log);
+
+    const std::string json = readFile(out);
+    fs::remove(out);
+    if (json.empty()) return {};  // ни один бенчмарк не подошёл под фильтр
+    const Value root = aip::bench::json::Parser(json).parse();
+
+    std::map<std::string, std::vector<double>> samples;
+    const Value* list = root.find("benchmarks");
+    if (!list || !list->isArray()) throw std::runtime_error("no 'benchmarks' array in benchmark output");
+    for (const Value& b : list->array()) {
+        const Value* type = b.find("run_type");
+        if (type && type->isString() && type->string() != "iteration") continue;
+        const Value* name = b.find("run_name");
+        if (!name) name = b.find("name");
+        const Value* t = b.find("real_time");
+        const Value* unit = b.find("time_unit");
+        if (!name || !t || !t->isNumber()) continue;
+        samples[name->string()].push_back(toNanoseconds(t->number(), unit ? unit->string() : "ns"));
+    }
+
+    std::map<std::string, Stat> stats;
+    for (const auto& [name, v] : samples) stats[name] = summarize(v);
+    return stats;
+}
+
+void writeBaseline(const fs::path& p, const std::string& cpu, const std::string& compiler,
+                   const std::map<std::string, Stat>& stats) {
+    fs::create_directories(p.parent_path());
+    std::ofstream out(p);
+    out.precision(17);
+    out << "{\n  \"cpu\": " << aip::bench::json::quote(cpu) << ",\n  \"compiler\": "
+        << aip::bench::json::quote(compiler) << ",\n  \"benchmarks\": {";
+    bool first = true;
+    for (const auto& [name, s] : stats) {
+        out << (first ? "\n" : ",\n") << "    " << aip::bench::json::quote(name) << ": {\"median_ns\": " << s.median
+            << ", \"mad_ns\": " << s.mad << ", \"samples\": " << s.samples << "}";
+        first = false;
+    }
+    out << "\n  }\n}\n";
+    if (!out) throw std::runtime_error("cannot write " + p.string());
+}
+
+std::map<std::string, Stat> readBaseline(const fs::path& p) {
+    const Value root = aip::bench::json::Parser(readFile(p)).parse();
+    std::map<std::string, Stat> stats;
+    const Value* list = root.find("benchmarks");
+    if (!list || !list->isObject()) throw std::runtime_error("malformed baseline " + p.string());
+    for (const auto& [name, v] : list->object()) {
+        Stat s;
+        if (const Value* m = v.find("median_ns")) s.median = m->number();
+        if (const Value* m = v.find("mad_ns")) s.mad = m->number();
+        if (const Value* m = v.find("samples")) s.samples = static_cast<std::size_t>(m->number());
+        stats[name] = s;
+    }
+    return stats;
+}
+
+/// Эффективность масштабирования: name "BM_parallelForIndicesAsync/T/P..." -> time(1,P) / (T * time(T,P)).
+std::map<std::string, double> scalingEfficiency(const std::map<std::string, Stat>& stats) {
+    static const std::regex re(R"(^(BM_parallelForIndicesAsync)/(\d+)/(.*)$)");
+    std::map<std::string, double> eff;
+    for (const auto& [name, s] : stats) {
+        std::smatch m;
+        if (!std::regex_match(name, m, re)) continue;
+        const int threads = std::stoi(m[2]);
+        if (threads <= 1) continue;
+        auto single = stats.find(m[1].str() + "/1/" + m[3].str());
+        if (single == stats.end() || s.median <= 0.0) continue;
+        eff[name + " [efficiency]"] = single->second.median / (threads * s.median);
+    }
+    return eff;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "--bench")
+            opt.bench = next();
+        else if (a == "--baseline-dir")
+            opt.baselineDir = next();
+        else if (a == "--repetitions")
+            opt.repetitions = std::stoi(next());
+        else if (a == "--threshold")
+            opt.threshold = std::stod(next());
+        else if (a == "--filter")
+            opt.filter = next();
+        else if (a == "--key")
+            opt.key = next();
+        else if (a == "--update")
+            opt.update = true;
+        else
+            throw std::runtime_error("unknown argument " + a);
+    }
+    return !opt.bench.empty() && !opt.baselineDir.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        if (!parseArgs(argc, argv, opt)) {
+            std::cerr << "usage: aip_bench_compare --bench <aip_bench> --baseline-dir <dir> [--repetitions N] "
+                         "[--threshold X] [--filter REGEX] [--key REGEX] [--update]\n";
+            return 2;
+        }
+
+        const std::string cpu = cpuModel();
+        const std::string compiler = compilerId();
+        const fs::path baseline = opt.baselineDir / ("baseline-" + sanitize(cpu) + "-" + compiler + ".json");
+
+        const auto current = runSuite(opt);
+        if (current.empty()) throw std::runtime_error("no benchmarks matched the filter");
+
+        if (opt.update || !fs::exists(baseline)) {
+            writeBaseline(baseline, cpu, compiler, current);
+            std::cout << "recorded baseline " << baseline.string() << " (" << current.size() << " benchmarks)\n";
+            return 0;
+        }
+
+        const auto base = readBaseline(baseline);
+        const std::regex key(opt.key);
+        std::size_t regressions = 0;
+
+        std::cout << "baseline: " << baseline.string() << "\n";
+        for (const auto& [name, cur] : current) {
+            auto it = base.find(name);
+            if (it == base.end()) {
+                std::cout << "  [new]       " << name << "\n";
+                continue;
+            }
+            const Stat& b = it->second;
+            const double ratio = b.median > 0.0 ? cur.median / b.median : 1.0;
+            const double noise = kNoiseFactor * kMadToSigma * std::max(b.mad, cur.mad);
+            const bool slower = ratio > 1.0 + opt.threshold && cur.median - b.median > noise;
+            const bool isKey = std::regex_search(name, key);
+
+            std::cout << (slower ? (isKey ? "  [REGRESSED] " : "  [slower]    ") : "  [ok]        ") << name
+                      << "  " << b.median << " -> " << cur.median << " ns (x" << ratio << ")\n";
+            if (slower && isKey) ++regressions;
+        }
+
+        const auto baseEff = scalingEfficiency(base);
+        for (const auto& [name, e] : scalingEfficiency(current)) {
+            auto it = baseEff.find(name);
+            if (it == baseEff.end()) continue;
+            const bool worse = e < it->second * (1.0 - opt.threshold);
+            std::cout << (worse ? "  [REGRESSED] " : "  [ok]        ") << name << "  " << it->second << " -> " << e
+                      << "\n";
+            if (worse) ++regressions;
+        }
+
+        if (regressions > 0) {
+            std::cout << regressions << " regression(s) beyond " << opt.threshold * 100.0 << "%\n";
+            return 1;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "aip_bench_compare: " << e.what() << "\n";
+        return 2;
+    }
+}
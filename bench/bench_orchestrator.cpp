@@ -0,0 +1,185 @@
+#include <benchmark/benchmark.h>
+
+#include <span>
+#include <vector>
+#include <cstddef>
+
+#include <aip/model/tabulated_model.hpp>
+#include <aip/profile/alloc_tracking.hpp>
+
+#include "bench_common.hpp"
+
+namespace {
+
+// allocs/iter и bytes/iter — только в aip_bench_alloc (хуки из bench_alloc_hooks.cpp); aip_bench без хуков.
+void reportAllocations(benchmark::State& state, const aip::profile::AllocScope& scope) {
+    if (!aip::profile::allocationHooksInstalled()) return;
+    const auto iters = static_cast<double>(state.iterations());
+    state.counters["allocs/iter"] = static_cast<double>(scope.allocations()) / iters;
+    state.counters["bytes/iter"] = static_cast<double>(scope.bytes()) / iters;
+}
+
+// Аргументы: {entries, side}; пространство — side^(3 * entries) кандидатов.
+
+void BM_Orchestrator_makePiecewise(benchmark::State& state) {
+    const auto orch = aip::bench::makeOrchestrator(static_cast<std::size_t>(state.range(0)),
+                                                   static_cast<std::size_t>(state.range(1)));
+    const std::size_t total = orch.size();
+    std::size_t g = 0;
+    aip::profile::AllocScope allocs;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(orch.makePiecewise(g));
+        g = (g + 7919) % total;  // шаг взаимно прост с размером — обходит всё пространство
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    reportAllocations(state, allocs);
+}
+BENCHMARK(BM_Orchestrator_makePiecewise)->Args({1, 8})->Args({3, 4})->Args({5, 3});
+
+void BM_Orchestrator_next(benchmark::State& state) {
+    auto orch = aip::bench::makeOrchestrator(static_cast<std::size_t>(state.range(0)),
+                                             static_cast<std::size_t>(state.range(1)));
+    orch.reset();
+    aip::profile::AllocScope allocs;
+    for (auto _ : state) {
+        auto pm = orch.next();
+        if (!pm) {
+            orch.reset();
+            pm = orch.next();
+        }
+        benchmark::DoNotOptimize(pm);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    reportAllocations(state, allocs);
+}
+BENCHMARK(BM_Orchestrator_next)->Args({1, 8})->Args({3, 4})->Args({5, 3});
+
+// Полный проход потока стратегии по одному индексу.
+void BM_Orchestrator_nextGlobal(benchmark::State& state) {
+    auto orch = aip::bench::makeOrchestrator(static_cast<std::size_t>(state.range(0)),
+                                             static_cast<std::size_t>(state.range(1)));
+    for (auto _ : state) {
+        orch.reset();
+        while (auto g = orch.nextGlobal()) benchmark::DoNotOptimize(*g);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * orch.size()));
+}
+BENCHMARK(BM_Orchestrator_nextGlobal)->Args({2, 8})->Args({3, 4});
+
+// То же блоками по 256.
+void BM_Orchestrator_nextGlobals(benchmark::State& state) {
+    auto orch = aip::bench::makeOrchestrator(static_cast<std::size_t>(state.range(0)),
+                                             static_cast<std::size_t>(state.range(1)));
+    std::vector<std::size_t> buf(256);
+    for (auto _ : state) {
+        orch.reset();
+        while (const std::size_t n = orch.nextGlobals(buf)) benchmark::DoNotOptimize(buf[n - 1]);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * orch.size()));
+}
+BENCHMARK(BM_Orchestrator_nextGlobals)->Args({2, 8})->Args({3, 4});
+
+// Аргументы: {entries, points}.
+void BM_PiecewiseModel_eval(benchmark::State& state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(entries, 4);
+    const auto pm = orch.makePiecewise(orch.size() / 2);
+    const auto xs = aip::bench::makeInputs(points, entries);
+
+    for (auto _ : state) {
+        double acc = 0.0;
+        for (const double x : xs) acc += pm(x);
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points));
+}
+BENCHMARK(BM_PiecewiseModel_eval)->Args({1, 1024})->Args({4, 1024})->Args({16, 1024})->Args({4, 1 << 16});
+
+// Пакетный путь PiecewiseModel: серии точек одного сегмента уходят в Quad::evaluate.
+void BM_PiecewiseModel_evalBatch(benchmark::State& state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(entries, 4);
+    const auto pm = orch.makePiecewise(orch.size() / 2);
+    const auto xs = aip::bench::makeInputs(points, entries);
+    std::vector<double> out(points);
+
+    for (auto _ : state) {
+        pm.evaluate(std::span<const double>(xs), std::span<double>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points));
+}
+BENCHMARK(BM_PiecewiseModel_evalBatch)->Args({1, 1024})->Args({4, 1024})->Args({16, 1024})->Args({4, 1 << 16});
+
+// Отсортированный вход: курсор по концам доменов (таблица строится один раз), без поиска сегмента на точку.
+void BM_PiecewiseModel_evalSorted(benchmark::State& state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(entries, 4);
+    const auto pm = orch.makePiecewise(orch.size() / 2);
+    const auto xs = aip::bench::makeInputs(points, entries);
+    const auto cursor = pm.sortedCursor();
+    std::vector<double> out(points);
+
+    for (auto _ : state) {
+        cursor.evaluate(std::span<const double>(xs), std::span<double>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points));
+}
+BENCHMARK(BM_PiecewiseModel_evalSorted)->Args({1, 1024})->Args({4, 1024})->Args({16, 1024})->Args({4, 1 << 16});
+
+// Те же аргументы, что у BM_PiecewiseModel_eval: замороженная модель, скалярные вызовы.
+void BM_FlatEvaluator_eval(benchmark::State& state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(entries, 4);
+    const auto flat = aip::model::freeze<aip::bench::Quad>(orch.makePiecewise(orch.size() / 2));
+    const auto xs = aip::bench::makeInputs(points, entries);
+
+    for (auto _ : state) {
+        double acc = 0.0;
+        for (const double x : xs) acc += flat(x);
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points));
+}
+BENCHMARK(BM_FlatEvaluator_eval)->Args({1, 1024})->Args({4, 1024})->Args({16, 1024})->Args({4, 1 << 16});
+
+void BM_FlatEvaluator_evalBatch(benchmark::State& state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(entries, 4);
+    const auto flat = aip::model::freeze<aip::bench::Quad>(orch.makePiecewise(orch.size() / 2));
+    const auto xs = aip::bench::makeInputs(points, entries);
+    std::vector<double> out(points);
+
+    for (auto _ : state) {
+        flat.evaluate(std::span<const double>(xs), std::span<double>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points));
+}
+BENCHMARK(BM_FlatEvaluator_evalBatch)->Args({1, 1024})->Args({4, 1024})->Args({16, 1024})->Args({4, 1 << 16});
+
+// Та же модель, табулированная с ошибкой 1e-9: поиск ячейки не зависит от числа сегментов.
+void BM_TabulatedModel_evalBatch(benchmark::State& state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(entries, 4);
+    const auto pm = orch.makePiecewise(orch.size() / 2);
+    const auto table = aip::model::tabulate(pm, 0.0, static_cast<double>(entries), {.maxAbsError = 1e-9});
+    const auto xs = aip::bench::makeInputs(points, entries);
+    std::vector<double> out(points);
+
+    for (auto _ : state) {
+        table.evaluate(std::span<const double>(xs), std::span<double>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * points));
+}
+BENCHMARK(BM_TabulatedModel_evalBatch)->Args({1, 1024})->Args({4, 1024})->Args({16, 1024})->Args({4, 1 << 16});
+
+}  // namespace
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <span>
+#include <vector>
+#include <cstddef>
+
+#include <aip/search/parallel_async.hpp>
+#include <aip/search/batch_inference.hpp>
+
+#include "bench_common.hpp"
+
+namespace {
+
+// Аргументы: {threads, points}. Полная оценка SSE каждого кандидата пространства 2 x side^3.
+void BM_parallelForIndicesAsync(benchmark::State& state) {
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    const auto points = static_cast<std::size_t>(state.range(1));
+    const auto orch = aip::bench::makeOrchestrator(2, 4);
+    const auto xs = aip::bench::makeInputs(points, 2);
+    const std::vector<double> ys(points, 0.25);
+
+    for (auto _ : state) {
+        const auto sse = aip::search::parallelForIndicesAsync(
+            0, orch.size(),
+            [&](std::size_t g) {
+                const auto pm = orch.makePiecewise(g);
+                double acc = 0.0;
+                for (std::size_t i = 0; i < xs.size(); ++i) {
+                    const double d = ys[i] - pm(xs[i]);
+                    acc += d * d;
+                }
+                return acc;
+            },
+            threads);
+        benchmark::DoNotOptimize(sse.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * orch.size()));
+}
+BENCHMARK(BM_parallelForIndicesAsync)
+    ->ArgsProduct({{1, 2, 4, 8}, {64, 1024}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Аргументы: {threads}. Пакетный инференс одной модели на 2^22 перемешанных точках.
+void BM_evaluateParallel(benchmark::State& state) {
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    const auto orch = aip::bench::makeOrchestrator(4, 4);
+    const auto pm = orch.makePiecewise(orch.size() / 2);
+    std::vector<double> xs = aip::bench::makeInputs(1 << 22, 4);
+    for (std::size_t i = 0; i < xs.size(); ++i) std::swap(xs[i], xs[(i * 2654435761u) % xs.size()]);
+    std::vector<double> out(xs.size());
+
+    for (auto _ : state) {
+        aip::search::evaluateParallel(pm, std::span<const double>(xs), std::span<double>(out),
+                                      {.threadCount = threads});
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * xs.size()));
+}
+BENCHMARK(BM_evaluateParallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <sstream>
+
+#include <aip/params/uniform_range.hpp>
+#include <aip/search/index_unrank.hpp>
+#include <aip/search/param_export.hpp>
+#include <aip/search/index_space_from_grid.hpp>
+
+#include "bench_common.hpp"
+
+namespace {
+
+void BM_UniformRange_size(benchmark::State& state) {
+    aip::params::UniformRange<double> r{-1.0, 1.0, 2.0 / static_cast<double>(state.range(0))};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(r.size());
+    }
+}
+BENCHMARK(BM_UniformRange_size)->Arg(16)->Arg(1 << 16);
+
+void BM_UniformRange_index(benchmark::State& state) {
+    const aip::params::UniformRange<double> r{-1.0, 1.0, 2.0 / static_cast<double>(state.range(0))};
+    const std::size_t n = r.size();
+    for (auto _ : state) {
+        double acc = 0.0;
+        for (std::size_t i = 0; i < n; ++i) acc += r[i];
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_UniformRange_index)->Arg(16)->Arg(1024)->Arg(1 << 16);
+
+void BM_make_index_space(benchmark::State& state) {
+    const auto grid = aip::bench::makeGrid(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(grid);
+        benchmark::DoNotOptimize(aip::search::make_index_space(grid));
+    }
+}
+BENCHMARK(BM_make_index_space)->Arg(8)->Arg(64);
+
+void BM_linear_to_multi_index(benchmark::State& state) {
+    const auto space = aip::search::make_index_space(aip::bench::makeGrid(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        for (std::size_t g = 0; g < space.total; ++g) {
+            benchmark::DoNotOptimize(aip::search::linear_to_multi_index(space, g));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * space.total));
+}
+BENCHMARK(BM_linear_to_multi_index)->Arg(8)->Arg(32);
+
+void BM_ParamGrid_makeModel(benchmark::State& state) {
+    const auto grid = aip::bench::makeGrid(static_cast<std::size_t>(state.range(0)));
+    const auto space = aip::search::make_index_space(grid);
+    for (auto _ : state) {
+        for (std::size_t g = 0; g < space.total; ++g) {
+            benchmark::DoNotOptimize(grid.makeModel(aip::search::linear_to_multi_index(space, g)));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * space.total));
+}
+BENCHMARK(BM_ParamGrid_makeModel)->Arg(8)->Arg(32);
+
+/// Кандидаты для экспорта: каждый 7-й глобальный индекс, всего n.
+std::vector<aip::search::Scored<double>> exportRows(const aip::bench::Orch& orch, std::size_t n) {
+    std::vector<aip::search::Scored<double>> rows(n);
+    for (std::size_t i = 0; i < n; ++i) rows[i] = {(i * 7) % orch.size(), 1.0 / static_cast<double>(i + 1)};
+    return rows;
+}
+
+// Экспорт строкового визитора: ostringstream на каждое значение.
+void BM_forEachParamAt_export(benchmark::State& state) {
+    const auto orch = aip::bench::makeOrchestrator(4, 16);
+    const auto rows = exportRows(orch, static_cast<std::size_t>(state.range(0)));
+    std::vector<std::size_t> locals(orch.entryCount());
+    for (auto _ : state) {
+        std::string out;
+        for (const auto& r : rows) {
+            orch.decodeLocals(r.global, locals);
+            for (std::size_t e = 0; e < orch.entryCount(); ++e)
+                orch[e].forEachParamAt(locals[e], [&](std::string_view, std::string v) {
+                    out += v;
+                    out += ',';
+                });
+            out += '\n';
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows.size()));
+}
+BENCHMARK(BM_forEachParamAt_export)->Arg(10000);
+
+void BM_writeParamCsv(benchmark::State& state) {
+    const auto orch = aip::bench::makeOrchestrator(4, 16);
+    const auto rows = exportRows(orch, static_cast<std::size_t>(state.range(0)));
+    aip::search::ParamExportOptions opt;
+    opt.threadCount = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state) {
+        std::ostringstream os;
+        aip::search::writeParamCsv(os, orch, rows, opt);
+        benchmark::DoNotOptimize(os.tellp());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows.size()));
+}
+BENCHMARK(BM_writeParamCsv)->Args({10000, 1})->Args({10000, 4})->UseRealTime();
+
+}  // namespace
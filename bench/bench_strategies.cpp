@@ -0,0 +1,27 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include <aip/search/enumeration_strategy.hpp>
+#include <aip/search/reverse_enumeration_strategy.hpp>
+#include <aip/search/index_space_from_grid.hpp>
+
+#include "bench_common.hpp"
+
+namespace {
+
+/// Полный проход стратегии по решётке side^3.
+template <template <std::size_t> class Strategy>
+void BM_Strategy_next(benchmark::State& state) {
+    const auto space = aip::search::make_index_space(aip::bench::makeGrid(static_cast<std::size_t>(state.range(0))));
+    Strategy<aip::bench::QuadGrid::N> strat;
+    for (auto _ : state) {
+        strat.reset(space);
+        while (auto idx = strat.next()) benchmark::DoNotOptimize(*idx);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * space.total));
+}
+BENCHMARK(BM_Strategy_next<aip::search::EnumerationStrategy>)->Arg(8)->Arg(32);
+BENCHMARK(BM_Strategy_next<aip::search::ReverseEnumerationStrategy>)->Arg(8)->Arg(32);
+
+}  // namespace
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <variant>
+#include <stdexcept>
+#include <string_view>
+
+namespace aip::bench::json {
+
+/**
+ * @brief Минимальное JSON-значение: ровно столько, сколько нужно для вывода Google Benchmark и базовых линий.
+ */
+struct Value {
+    using Array = std::vector<Value>;
+    using Object = std::map<std::string, Value, std::less<>>;
+
+    std::variant<std::nullptr_t, bool, double, std::string, std::shared_ptr<Array>, std::shared_ptr<Object>> v{nullptr};
+
+    [[nodiscard]] bool isObject() const noexcept { return std::holds_alternative<std::shared_ptr<Object>>(v); }
+    [[nodiscard]] bool isArray() const noexcept { return std::holds_alternative<std::shared_ptr<Array>>(v); }
+    [[nodiscard]] bool isNumber() const noexcept { return std::holds_alternative<double>(v); }
+    [[nodiscard]] bool isString() const noexcept { return std::holds_alternative<std::string>(v); }
+
+    [[nodiscard]] const Object& object() const { return *std::get<std::shared_ptr<Object>>(v); }
+    [[nodiscard]] const Array& array() const { return *std::get<std::shared_ptr<Array>>(v); }
+    [[nodiscard]] double number() const { return std::get<double>(v); }
+    [[nodiscard]] const std::string& string() const { return std::get<std::string>(v); }
+
+    /// Поле объекта или nullptr.
+    [[nodiscard]] const Value* find(std::string_view key) const {
+        if (!isObject()) return nullptr;
+        const auto& o = object();
+        auto it = o.find(key);
+        return it == o.end() ? nullptr : &it->second;
+    }
+};
+
+/**
+ * @brief Разобрать JSON-текст.
+ *
+ * @throws std::runtime_error при синтаксической ошибке.
+ */
+class Parser {
+   public:
+    explicit Parser(std::string_view text) : s_(text) {}
+
+    Value parse() {
+        Value v = value();
+        ws();
+        if (i_ != s_.size()) fail("trailing characters");
+        return v;
+    }
+
+   private:
+    std::string_view s_;
+    std::size_t i_{0};
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error("json: " + std::string(what) + " at offset " + std::to_string(i_));
+    }
+
+    void ws() {
+        while (i_ < s_.size() && (s_[i_] == ' ' || s_[i_] == '\n' || s_[i_] == '\r' || s_[i_] == '\t')) ++i_;
+    }
+
+    char peek() {
+        ws();
+        if (i_ >= s_.size()) fail("unexpected end");
+        return s_[i_];
+    }
+
+    void expect(char c) {
+        if (peek() != c) fail("unexpected character");
+        ++i_;
+    }
+
+    bool literal(std::string_view word) {
+        if (s_.substr(i_, word.size()) != word) return false;
+        i_ += word.size();
+        return true;
+    }
+
+    Value value() {
+        const char c = peek();
+        if (c == '{') return objectValue();
+        if (c == '[') return arrayValue();
+        if (c == '"') return Value{stringValue()};
+        if (literal("true")) return Value{true};
+        if (literal("false")) return Value{false};
+        if (literal("null")) return Value{nullptr};
+        return numberValue();
+    }
+
+    Value objectValue() {
+        auto obj = std::make_shared<Value::Object>();
+        expect('{');
+        if (peek() == '}') {
+            ++i_;
+            return Value{obj};
+        }
+        for (;;) {
+            if (peek() != '"') fail("expected key");
+            std::string key = stringValue();
+            expect(':');
+            (*obj)[std::move(key)] = value();
+            if (peek() == ',') {
+                ++i_;
+                continue;
+            }
+            expect('}');
+            return Value{obj};
+        }
+    }
+
+    Value arrayValue() {
+        auto arr = std::make_shared<Value::Array>();
+        expect('[');
+        if (peek() == ']') {
+            ++i_;
+            return Value{arr};
+        }
+        for (;;) {
+            arr->push_back(value());
+            if (peek() == ',') {
+                ++i_;
+                continue;
+            }
+            expect(']');
+            return Value{arr};
+        }
+    }
+
+    std::string stringValue() {
+        expect('"');
+        std::string out;
+        while (i_ < s_.size() && s_[i_] != '"') {
+            char c = s_[i_++];
+            if (c == '\\') {
+                if (i_ >= s_.size()) fail("bad escape");
+                const char e = s_[i_++];
+                switch (e) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'u':  // не-ASCII в именах бенчмарков не ожидается: заменяем на '?'
+                        i_ += 4;
+                        c = '?';
+                        break;
+                    default: c = e;
+                }
+            }
+            out.push_back(c);
+        }
+        expect('"');
+        return out;
+    }
+
+    Value numberValue() {
+        const std::string tail(s_.substr(i_, 64));
+        char* end = nullptr;
+        const double d = std::strtod(tail.c_str(), &end);
+        if (end == tail.c_str()) fail("unexpected token");
+        i_ += static_cast<std::size_t>(end - tail.c_str());
+        return Value{d};
+    }
+};
+
+/// Экранировать строку для вывода в JSON.
+inline std::string quote(std::string_view s) {
+    std::string out = "\"";
+    for (const char c : s) {
+        if (c == '"' || c == '\\') out.push_back('\\');
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+    return out;
+}
+
+}  // namespace aip::bench::json
@@ -0,0 +1,285 @@
+// Исследование масштабирования параллельных драйверов поиска.
+//
+//   aip_scaling_study [--max-threads N] [--repetitions R] [--out file.csv]
+//                     [--trace trace.json] [--trace-sample N]
+//
+// Перебирает число потоков (1, 2, 4, ..., N и сам N), форму нагрузки и политику чанков и пишет CSV:
+//
+//   driver,workload,policy,chunk_size,threads,items,seconds,throughput,speedup,efficiency,
+//   chunk_p50_us,chunk_p99_us,chunk_max_us
+//
+// speedup = t(1 поток) / t(T) для той же строки (driver, workload, policy); efficiency = speedup / T.
+// Латентность чанков измеряется только у драйвера chunks (у остальных поля пустые).
+//
+// Драйверы: indices (parallelForIndicesAsync), chunks (parallelForChunksAsync), jobs (JobScheduler),
+// bnb (branchAndBound). Нагрузки: cheap, expensive, constrained, skewed (стоимость сильно различается
+// между global — здесь видна разница Static/Dynamic).
+//
+// --trace записывает Chrome trace (Perfetto) всех прогонов; --trace-sample N трассирует каждый N-й чанк.
+// Точки трассировки есть только в сборке с AIP_ENABLE_TRACING.
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+#include <aip/params/unit_grid.hpp>
+#include <aip/profile/trace.hpp>
+#include <aip/search/job_scheduler.hpp>
+#include <aip/search/parallel_async.hpp>
+#include <aip/search/branch_and_bound.hpp>
+
+#include "bench_common.hpp"
+
+namespace {
+
+using aip::bench::Orch;
+using aip::bench::Seg;
+using Clock = std::chrono::steady_clock;
+
+/// Дорогая модель: сумма гармоник (много трансцендентных вызовов на точку).
+struct Wave final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"amp"}> amp{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"freq"}> freq{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override {
+        double s = 0.0;
+        for (int k = 1; k <= 16; ++k) s += std::sin(freq.value * k * x) / k;
+        return amp.value * s;
+    }
+};
+
+using WaveGrid = aip::params::ParamGrid<Wave, aip::params::UniformRange, &Wave::amp, &Wave::freq>;
+
+struct Line final : aip::model::IModel<double, double> {
+    double k{}, m{};
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k * x + m; }
+};
+
+struct FitLine {
+    double xL{}, xR{};
+    void operator()(Line& l, const double& yL, const double& yR) const noexcept {
+        l.k = (yR - yL) / (xR - xL);
+        l.m = yL - l.k * xL;
+    }
+};
+
+struct Workload {
+    std::string name;
+    Orch orch;
+    std::vector<double> xs, ys;
+    std::function<std::size_t(std::size_t)> repeat;  // во сколько раз дороже оценка данного global
+    bool uniformCost{true};
+};
+
+std::vector<Workload> makeWorkloads() {
+    std::vector<Workload> w;
+
+    auto data = [](Workload& wl, std::size_t points, std::size_t entries) {
+        wl.xs = aip::bench::makeInputs(points, entries);
+        wl.ys.resize(points);
+        for (std::size_t i = 0; i < points; ++i) wl.ys[i] = std::sin(wl.xs[i]);
+    };
+
+    {
+        Workload wl{"cheap", aip::bench::makeOrchestrator(2, 5), {}, {}, [](std::size_t) { return 1; }};
+        data(wl, 64, 2);
+        w.push_back(std::move(wl));
+    }
+    {
+        Workload wl{"expensive", Orch{}, {}, {}, [](std::size_t) { return 1; }};
+        WaveGrid g;
+        g.get<0>() = {-1.0, 1.0, 0.25};
+        g.get<1>() = {0.5, 2.0, 0.25};
+        wl.orch.add(Seg{0.0, 1.0}, g);
+        wl.orch.add(Seg{1.0, 2.0}, g);
+        data(wl, 256, 2);
+        w.push_back(std::move(wl));
+    }
+    {
+        Workload wl{"constrained", Orch{}, {}, {}, [](std::size_t) { return 1; }};
+        wl.orch.add(Seg{0.0, 1.0}, aip::bench::makeGrid(4));
+        wl.orch.addConstrained(Seg{1.0, 2.0}, aip::params::UnitGrid<Line>{}, 1.0, 2.0, FitLine{1.0, 2.0});
+        wl.orch.add(Seg{2.0, 3.0}, aip::bench::makeGrid(4));
+        data(wl, 256, 3);
+        w.push_back(std::move(wl));
+    }
+    {
+        // каждый 16-й global в 32 раза дороже, и дорогие сгруппированы в начале пространства
+        Workload wl{"skewed", aip::bench::makeOrchestrator(2, 5), {}, {},
+                    [](std::size_t g) { return g < 2048 && g % 16 == 0 ? std::size_t{32} : std::size_t{1}; }, false};
+        data(wl, 64, 2);
+        w.push_back(std::move(wl));
+    }
+    return w;
+}
+
+double score(const Workload& wl, std::size_t g) {
+    const auto pm = wl.orch.makePiecewise(g);
+    double sse = 0.0;
+    for (std::size_t r = wl.repeat(g); r-- > 0;) {
+        for (std::size_t i = 0; i < wl.xs.size(); ++i) {
+            const double d = wl.ys[i] - pm(wl.xs[i]);
+            sse += d * d;
+        }
+    }
+    return sse;
+}
+
+struct Sample {
+    double seconds{0};
+    std::vector<double> chunkMicros;
+};
+
+struct Row {
+    std::string driver, workload, policy;
+    std::size_t chunkSize{0}, threads{0}, items{0};
+    Sample sample;
+};
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const auto idx = static_cast<std::size_t>(std::ceil(p * static_cast<double>(v.size()))) - 1;
+    return v[std::min(idx, v.size() - 1)];
+}
+
+template <typename Fn>
+Sample timed(std::size_t repetitions, Fn&& fn) {
+    std::vector<Sample> runs;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        Sample s;
+        const auto t0 = Clock::now();
+        fn(s);
+        s.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        runs.push_back(std::move(s));
+    }
+    std::sort(runs.begin(), runs.end(), [](const Sample& a, const Sample& b) { return a.seconds < b.seconds; });
+    return std::move(runs[runs.size() / 2]);  // медианный прогон
+}
+
+std::string policyName(const aip::search::ChunkPolicy& p) {
+    return p.kind == aip::search::ChunkPolicy::Kind::Static ? "static" : "dynamic";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t repetitions = 3;
+    std::string outPath;
+    std::string tracePath;
+    std::size_t traceSample = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string a = argv[i];
+        if (a == "--max-threads") maxThreads = std::stoul(argv[i + 1]);
+        if (a == "--repetitions") repetitions = std::max<std::size_t>(1, std::stoul(argv[i + 1]));
+        if (a == "--out") outPath = argv[i + 1];
+        if (a == "--trace") tracePath = argv[i + 1];
+        if (a == "--trace-sample") traceSample = std::max<std::size_t>(1, std::stoul(argv[i + 1]));
+    }
+
+    if (!tracePath.empty()) {
+        if (!aip::profile::kTracingEnabled) std::cerr << "warning: built without AIP_ENABLE_TRACING, trace is empty\n";
+        aip::profile::Tracer::instance().start({std::size_t{1} << 16, traceSample});
+    }
+
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    const std::vector<aip::search::ChunkPolicy> policies = {
+        aip::search::ChunkPolicy::staticChunks(),
+        aip::search::ChunkPolicy::staticChunks(64),
+        aip::search::ChunkPolicy::dynamicChunks(),
+        aip::search::ChunkPolicy::dynamicChunks(16),
+    };
+
+    std::vector<Row> rows;
+    for (const auto& wl : makeWorkloads()) {
+        const std::size_t n = wl.orch.size();
+
+        for (const auto& policy : policies) {
+            for (const std::size_t t : threadCounts) {
+                rows.push_back({"indices", wl.name, policyName(policy), policy.chunkSize, t, n,
+                                timed(repetitions, [&](Sample&) {
+                                    auto r = aip::search::parallelForIndicesAsync(
+                                        0, n, [&](std::size_t g) { return score(wl, g); }, policy, t);
+                                    (void)r;
+                                })});
+
+                rows.push_back({"chunks", wl.name, policyName(policy), policy.chunkSize, t, n,
+                                timed(repetitions, [&](Sample& s) {
+                                    s.chunkMicros = aip::search::parallelForChunksAsync(
+                                        0, n,
+                                        [&](std::size_t b, std::size_t e) {
+                                            const auto t0 = Clock::now();
+                                            double acc = 0.0;
+                                            for (std::size_t g = b; g < e; ++g) acc += score(wl, g);
+                                            (void)acc;
+                                            return std::chrono::duration<double, std::micro>(Clock::now() - t0)
+                                                .count();
+                                        },
+                                        policy, t);
+                                })});
+            }
+        }
+
+        for (const std::size_t t : threadCounts) {
+            for (const std::size_t chunk : {std::size_t{16}, std::size_t{256}}) {
+                rows.push_back({"jobs", wl.name, "dynamic", chunk, t, n, timed(repetitions, [&](Sample&) {
+                                    aip::search::JobScheduler<> sched(t);
+                                    aip::search::JobOptions jo;
+                                    jo.chunkSize = chunk;
+                                    sched.submit(0, n, [&](std::size_t g) { return score(wl, g); }, jo).get();
+                                })});
+            }
+
+            if (wl.uniformCost) {
+                rows.push_back({"bnb", wl.name, "dynamic", 1, t, n, timed(repetitions, [&](Sample&) {
+                                    aip::search::BranchAndBoundOptions bo;
+                                    bo.threadCount = t;
+                                    auto r = aip::search::branchAndBound(wl.orch, std::span<const double>(wl.xs),
+                                                                         std::span<const double>(wl.ys), bo);
+                                    (void)r;
+                                })});
+            }
+        }
+    }
+
+    if (!tracePath.empty()) {
+        aip::profile::Tracer::instance().stop();
+        aip::profile::Tracer::instance().writeChromeTrace(tracePath);
+    }
+
+    std::ofstream file;
+    if (!outPath.empty()) file.open(outPath);
+    std::ostream& out = outPath.empty() ? std::cout : file;
+
+    out << "driver,workload,policy,chunk_size,threads,items,seconds,throughput,speedup,efficiency,"
+           "chunk_p50_us,chunk_p99_us,chunk_max_us\n";
+    for (const auto& r : rows) {
+        auto base = std::find_if(rows.begin(), rows.end(), [&](const Row& o) {
+            return o.threads == 1 && o.driver == r.driver && o.workload == r.workload && o.policy == r.policy &&
+                   o.chunkSize == r.chunkSize;
+        });
+        const double speedup = base->sample.seconds / r.sample.seconds;
+
+        out << r.driver << ',' << r.workload << ',' << r.policy << ',' << r.chunkSize << ',' << r.threads << ','
+            << r.items << ',' << r.sample.seconds << ',' << static_cast<double>(r.items) / r.sample.seconds << ','
+            << speedup << ',' << speedup / static_cast<double>(r.threads) << ',';
+        if (r.sample.chunkMicros.empty()) {
+            out << ",,\n";
+        } else {
+            out << percentile(r.sample.chunkMicros, 0.5) << ',' << percentile(r.sample.chunkMicros, 0.99) << ','
+                << *std::max_element(r.sample.chunkMicros.begin(), r.sample.chunkMicros.end()) << '\n';
+        }
+    }
+    return 0;
+}
@@ -10,6 +10,8 @@
 #include <aip/core/orchestrator.hpp>
 #include <aip/search/parallel_async.hpp>
 #include <aip/search/index_space_from_grid.hpp>
+#include <aip/profile/phase_stats.hpp>
+#include <aip/profile/perf_counters.hpp>
 
 #include <atomic>
 #include <mutex>
@@ -295,5 +297,14 @@ int main() {
     print_params_for_grid("Parabola (x1..x2)", gP, localP);
     print_params_for_grid("Hyperbola (x >= x2)", gH, localH);
 
+    if constexpr (aip::profile::kInstrumentationEnabled) {
+        std::cout << "\nPhase stats:\n";
+        aip::profile::printPhaseStats(std::cout);
+    }
+    if constexpr (aip::profile::kPerfCountersEnabled) {
+        std::cout << "\nHardware counters:\n";
+        aip::profile::printPerfStats(std::cout);
+    }
+
     return 0;
 }
\ No newline at end of file
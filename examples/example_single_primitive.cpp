@@ -8,6 +8,7 @@
 #include <aip/params/uniform_range.hpp>
 
 #include <aip/core/orchestrator.hpp>
+#include <aip/profile/phase_stats.hpp>
 #include <aip/search/index_space_from_grid.hpp>
 
 #include <chrono>
@@ -275,5 +276,10 @@ int main() {
     print_params_for_grid("Parabola (x1..x2)", gP, localP);
     print_params_for_grid("Hyperbola (x >= x2)", gH, localH);
 
+    if constexpr (aip::profile::kInstrumentationEnabled) {
+        std::cout << "\nPhase stats:\n";
+        aip::profile::printPhaseStats(std::cout);
+    }
+
     return 0;
 }
\ No newline at end of file
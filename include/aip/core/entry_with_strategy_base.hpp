@@ -1,6 +1,13 @@
 #pragma once
 
+#include <span>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+
 #include <aip/core/ientry.hpp>
+#include <aip/search/index_strategy.hpp>
+#include <aip/search/index_space_from_grid.hpp>
 
 namespace aip::core::detail {
 
@@ -21,10 +28,39 @@ class EntryWithStrategyBase : public IEntry<In, Out, Domain> {
     Domain domain_;
     Grid grid_;
 
+    /// Индексов в блоке, который сегмент забирает у BatchStrategy за один вызов.
+    static constexpr std::size_t kStrategyBlock = 64;
+    static constexpr bool kBatched = aip::search::BatchStrategy<Strategy, N>;
+
+    /// Буфер индексов из nextBatch() и позиция в нём.
+    struct StrategyBlock {
+        std::array<idx_type, kStrategyBlock> idx{};
+        std::size_t pos{0};
+        std::size_t len{0};
+    };
+    /// Заглушка для стратегий без nextBatch(): буфер им не нужен.
+    struct NoStrategyBlock {};
+
     aip::search::IndexSpace<N> space_{};
     Strategy strat_{};
     std::optional<idx_type> current_{};
 
+    [[no_unique_address]] std::conditional_t<kBatched, StrategyBlock, NoStrategyBlock> block_{};
+
+    /// Следующий индекс стратегии: из блока nextBatch(), если стратегия его поддерживает.
+    std::optional<idx_type> pull() {
+        if constexpr (kBatched) {
+            if (block_.pos == block_.len) {
+                block_.len = strat_.nextBatch(std::span<idx_type>(block_.idx));
+                block_.pos = 0;
+                if (block_.len == 0) return std::nullopt;
+            }
+            return block_.idx[block_.pos++];
+        } else {
+            return strat_.next();
+        }
+    }
+
    public:
     EntryWithStrategyBase(Domain d, Grid g, std::string name = {}) : domain_(std::move(d)), grid_(std::move(g)) {
         this->model_name = std::move(name);
@@ -34,40 +70,127 @@ class EntryWithStrategyBase : public IEntry<In, Out, Domain> {
     
     std::size_t size() const noexcept override { return grid_.size(); }
 
+    std::size_t paramCount() const noexcept override { return N; }
+
+    std::size_t paramsAt(std::size_t local, std::span<ParamField> out) const noexcept override {
+        if constexpr (N == 0) {
+            (void)local;
+            (void)out;
+            return 0;
+        } else {
+            const auto space = aip::search::make_index_space(grid_);
+            idx_type idx{};
+            for (std::size_t i = 0; i < N; ++i) {
+                const std::size_t base = space.bases[i];
+                idx[i] = (base > 0) ? (local % base) : 0;
+                local = (base > 0) ? (local / base) : 0;
+            }
+
+            grid_.forEachParam([&](auto meta, const auto& range) {
+                if (meta.index < out.size())
+                    out[meta.index] = ParamField{meta.label, meta.index, toParamValue(range[idx[meta.index]])};
+            });
+            return std::min(N, out.size());
+        }
+    }
+
     void reset() override {
         space_ = aip::search::make_index_space(grid_);
         strat_.reset(space_);
         current_.reset();
+        if constexpr (kBatched) block_.pos = block_.len = 0;
         // важно: “текущий” должен быть установлен
-        current_ = strat_.next();
+        current_ = pull();
     }
 
     bool next() override {
         if (!current_) return false;
-        current_ = strat_.next();
+        current_ = pull();
         return current_.has_value();
     }
 
+    std::size_t nextLocals(std::span<std::size_t> out) override {
+        std::size_t n = 0;
+        while (n < out.size() && current_) {
+            out[n++] = *localOf(space_, current_);
+            current_ = pull();
+        }
+        return n;
+    }
+
     std::optional<std::vector<std::size_t>> currentIdx() const override {
         if (!current_) return std::nullopt;
         return std::vector<std::size_t>(current_->begin(), current_->end());
     }
 
-    std::optional<std::size_t> currentLocal() const noexcept override {
-        if (!current_) return std::nullopt;
+    std::optional<std::size_t> currentLocal() const noexcept override { return localOf(space_, current_); }
+
+    std::unique_ptr<IStrategyCursor> makeCursor() const override { return std::make_unique<Cursor>(grid_); }
+
+    std::size_t streamLength() const override {
+        if constexpr (aip::search::SkippableStrategy<Strategy, N>) {
+            return grid_.size();
+        } else {
+            const auto space = aip::search::make_index_space(grid_);
+            Strategy s{};
+            s.reset(space);
+            std::size_t n = 0;
+            while (s.next()) ++n;
+            return n;
+        }
+    }
+
+   private:
+    static std::optional<std::size_t> localOf(const aip::search::IndexSpace<N>& space,
+                                              const std::optional<idx_type>& idx) noexcept {
+        if (!idx) return std::nullopt;
         if constexpr (N == 0) return 0;
 
         std::size_t local = 0, mul = 1;
         for (std::size_t i = 0; i < N; ++i) {
-            const std::size_t base = space_.bases[i];
+            const std::size_t base = space.bases[i];
             if (base == 0) return std::nullopt;
-            const std::size_t v = (*current_)[i];
+            const std::size_t v = (*idx)[i];
             if (v >= base) return std::nullopt;
             local += v * mul;
             mul *= base;
         }
         return local;
     }
+
+    /// Своя копия пространства и стратегии: стратегия хранит указатель на space_, поэтому курсор не перемещается.
+    class Cursor final : public IStrategyCursor {
+       public:
+        explicit Cursor(const Grid& g) : space_(aip::search::make_index_space(g)) {}
+
+        Cursor(const Cursor&) = delete;
+        Cursor& operator=(const Cursor&) = delete;
+
+        bool seek(std::size_t step) override {
+            strat_.reset(space_);
+            if constexpr (aip::search::SkippableStrategy<Strategy, N>) {
+                strat_.skip(step);
+            } else {
+                for (; step > 0; --step)
+                    if (!strat_.next()) break;
+            }
+            current_ = strat_.next();
+            return current_.has_value();
+        }
+
+        bool next() override {
+            if (!current_) return false;
+            current_ = strat_.next();
+            return current_.has_value();
+        }
+
+        std::optional<std::size_t> currentLocal() const noexcept override { return localOf(space_, current_); }
+
+       private:
+        aip::search::IndexSpace<N> space_;
+        Strategy strat_{};
+        std::optional<idx_type> current_{};
+    };
 };
 
 }  // namespace aip::core::detail
\ No newline at end of file
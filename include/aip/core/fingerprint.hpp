@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <typeinfo>
+#include <string_view>
+#include <type_traits>
+
+namespace aip::core {
+
+/**
+ * @brief 128-битный отпечаток содержимого (content address).
+ */
+struct Fingerprint {
+    std::uint64_t hi{0};
+    std::uint64_t lo{0};
+
+    friend constexpr bool operator==(const Fingerprint&, const Fingerprint&) = default;
+};
+
+class Fingerprinter;
+
+/**
+ * @brief Точка расширения: как хешировать значение типа T.
+ *
+ * Специализация должна содержать `static void hash(Fingerprinter& f, const T& v)`.
+ * Альтернатива — метод `void fingerprint(Fingerprinter& f) const` у самого типа.
+ */
+template <typename T>
+struct FingerprintTraits;
+
+/**
+ * @brief Накопитель отпечатка.
+ *
+ * Две независимые дорожки: FNV-1a (побайтно) и мультипликативное перемешивание 64-битных слов.
+ * Вероятность случайного совпадения отпечатков разных данных пренебрежимо мала.
+ *
+ * add(v) поддерживает:
+ *  - типы с FingerprintTraits<T> или методом fingerprint(Fingerprinter&);
+ *  - строки (string_view-совместимые);
+ *  - floating-point: -0 и +0, а также все NaN хешируются одинаково;
+ *  - целые, enum и прочие типы с уникальным объектным представлением
+ *    (std::has_unique_object_representations_v: без байтов выравнивания и floating-point полей) —
+ *    по байтам объекта.
+ *
+ * Для прочих типов (в том числе указателей и структур с double или байтами выравнивания — равные
+ * значения могут различаться байтами) отпечаток становится недоступным (result() == nullopt):
+ * лучше не кэшировать, чем выдать устаревший результат. Такие типы хешируют поля явно через
+ * FingerprintTraits<T> или метод fingerprint(Fingerprinter&).
+ *
+ * @warning Отпечаток описывает данные, а не код. Если у модели/домена меняется реализация
+ *          при том же типе и тех же полях, объявите в типе `static constexpr std::uint64_t
+ *          kFingerprintVersion` и увеличьте его. Структуры с полями-указателями проходят проверку
+ *          представления, но хешируются по адресу (он меняется между запусками) — для них задайте
+ *          FingerprintTraits.
+ */
+class Fingerprinter {
+   public:
+    Fingerprinter() = default;
+
+    Fingerprinter& bytes(const void* data, std::size_t n) noexcept {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < n; ++i) {
+            fnv_ = (fnv_ ^ p[i]) * 0x100000001b3ull;
+            word_ |= static_cast<std::uint64_t>(p[i]) << (8 * fill_);
+            if (++fill_ == 8) flushWord();
+        }
+        length_ += n;
+        return *this;
+    }
+
+    template <typename T>
+    Fingerprinter& add(const T& v) {
+        if constexpr (requires { FingerprintTraits<T>::hash(*this, v); }) {
+            FingerprintTraits<T>::hash(*this, v);
+        } else if constexpr (requires { v.fingerprint(*this); }) {
+            v.fingerprint(*this);
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            const std::string_view s = v;
+            add(static_cast<std::uint64_t>(s.size()));
+            bytes(s.data(), s.size());
+        } else if constexpr (std::is_floating_point_v<T>) {
+            T c = v;
+            if (c == T{0}) c = T{0};  // -0 -> +0
+            if (std::isnan(c)) c = std::numeric_limits<T>::quiet_NaN();
+            bytes(&c, sizeof(c));
+        } else if constexpr (std::has_unique_object_representations_v<T> && !std::is_pointer_v<T> &&
+                             !std::is_member_pointer_v<T>) {
+            bytes(&v, sizeof(v));
+        } else {
+            invalidate();
+        }
+        return *this;
+    }
+
+    /// Имя типа (стабильно в пределах одного компилятора/ABI) и его версия kFingerprintVersion, если есть.
+    template <typename T>
+    Fingerprinter& addType() {
+        add(std::string_view(typeid(T).name()));
+        if constexpr (requires { T::kFingerprintVersion; }) add(static_cast<std::uint64_t>(T::kFingerprintVersion));
+        return *this;
+    }
+
+    /// Пометить отпечаток как недоступный (данные не поддаются точному хешированию).
+    void invalidate() noexcept { ok_ = false; }
+
+    [[nodiscard]] bool valid() const noexcept { return ok_; }
+
+    [[nodiscard]] std::optional<Fingerprint> result() const noexcept {
+        if (!ok_) return std::nullopt;
+        Fingerprinter tail = *this;
+        if (tail.fill_ > 0) tail.flushWord();
+        Fingerprint fp{mix(tail.acc_ ^ length_), mix(tail.fnv_ ^ (length_ * 0x9e3779b97f4a7c15ull))};
+        if (fp.hi == 0 && fp.lo == 0) fp.lo = 1;  // {0, 0} зарезервирован под "пусто"
+        return fp;
+    }
+
+   private:
+    std::uint64_t fnv_{0xcbf29ce484222325ull};
+    std::uint64_t acc_{0x243f6a8885a308d3ull};
+    std::uint64_t word_{0};
+    std::uint64_t length_{0};
+    unsigned fill_{0};
+    bool ok_{true};
+
+    static constexpr std::uint64_t mix(std::uint64_t z) noexcept {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    void flushWord() noexcept {
+        acc_ = mix(acc_ ^ word_) * 0x9fb21c651e98df25ull;
+        word_ = 0;
+        fill_ = 0;
+    }
+};
+
+/// Отпечаток одного значения.
+template <typename T>
+[[nodiscard]] std::optional<Fingerprint> fingerprintOf(const T& v) {
+    Fingerprinter f;
+    f.add(v);
+    return f.result();
+}
+
+}  // namespace aip::core
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <sstream>
+#include <algorithm>
 
+#include <aip/model/lane_traits.hpp>
 #include <aip/search/index_space.hpp>
 #include <aip/search/index_strategy.hpp>
 #include <aip/search/index_space_from_grid.hpp>
@@ -31,20 +35,61 @@ struct FreeEntry final : EntryWithStrategyBase<In, Out, Domain, Grid, StrategyT>
     std::shared_ptr<const IM<In, Out, Domain>> makeAt(std::size_t local,
                                                       const std::vector<std::shared_ptr<const IM<In, Out, Domain>>>&,
                                                       std::size_t) const override {
-        const auto space = aip::search::make_index_space(this->grid_);
+        return std::make_shared<Model>(modelAtLocal(local));
+    }
 
-        idx_type idx{};
-        for (std::size_t i = 0; i < N; ++i) {
-            const std::size_t base = space.bases[i];
-            idx[i] = (base > 0) ? (local % base) : 0;
-            local = (base > 0) ? (local / base) : 0;
+    bool isConstrained() const noexcept override { return false; }
+
+    std::size_t laneWidth() const noexcept override { return aip::model::LaneTraits<Model>::width; }
+
+    std::size_t evalLanes(std::size_t localBegin, std::span<const In> xs, std::span<Out> out) const override {
+        constexpr std::size_t W = aip::model::LaneTraits<Model>::width;
+        assert(out.size() >= xs.size() * W && "evalLanes: out is too small");
+
+        if constexpr (requires { typename Grid::template Lanes<W>; }) {
+            using LanesT = typename Grid::template Lanes<W>;
+            if constexpr (aip::model::LaneKernel<Model, LanesT, In, Out>) {
+                LanesT lanes{};
+                const std::size_t count = this->grid_.template lanesAt<W>(localBegin, lanes);
+                if (count == 0) return 0;
+                aip::model::LaneTraits<Model>::eval(lanes, xs, out);
+                return count;
+            }
         }
 
-        Model m = this->grid_.makeModel(idx);
-        return std::make_shared<Model>(std::move(m));
+        // Скалярный путь: модели строятся по значению, вызов operator() без shared_ptr.
+        const std::size_t total = this->grid_.size();
+        if (localBegin >= total) return 0;
+        const std::size_t count = std::min(W, total - localBegin);
+
+        for (std::size_t l = 0; l < count; ++l) {
+            const Model m = modelAtLocal(localBegin + l);
+            for (std::size_t i = 0; i < xs.size(); ++i) out[i * W + l] = m(xs[i]);
+        }
+        // хвостовой блок: лишние дорожки повторяют последнюю (как у lane-ядер), без повторной оценки
+        for (std::size_t i = 0; i < xs.size() && count < W; ++i)
+            std::fill(out.begin() + static_cast<std::ptrdiff_t>(i * W + count),
+                      out.begin() + static_cast<std::ptrdiff_t>((i + 1) * W), out[i * W + count - 1]);
+        return count;
     }
 
-    bool isConstrained() const noexcept override { return false; }
+    std::optional<Fingerprint> fingerprint() const override {
+        Fingerprinter f;
+        f.add(std::string_view("aip.FreeEntry"));
+        f.addType<In>();
+        f.addType<Out>();
+        f.addType<Grid>();
+        f.addType<Model>();  // Model::kFingerprintVersion — версия кода модели
+        f.addType<Domain>();
+        f.add(static_cast<std::uint64_t>(aip::model::LaneTraits<Model>::width));
+        f.add(this->domain_);
+        this->grid_.forEachParam([&](auto meta, const auto& range) {
+            f.add(meta.label);
+            f.add(static_cast<std::uint64_t>(range.size()));
+            for (std::size_t i = 0; i < range.size(); ++i) f.add(range[i]);
+        });
+        return f.result();
+    }
 
     void forEachParamAt(std::size_t local,
                         const std::function<void(std::string_view label, std::string value)>& fn) const override {
@@ -74,6 +119,20 @@ struct FreeEntry final : EntryWithStrategyBase<In, Out, Domain, Grid, StrategyT>
         }
     }
 
+    /// @brief Построить модель по локальному индексу (по значению).
+    Model modelAtLocal(std::size_t local) const {
+        const auto space = aip::search::make_index_space(this->grid_);
+
+        idx_type idx{};
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t base = space.bases[i];
+            idx[i] = (base > 0) ? (local % base) : 0;
+            local = (base > 0) ? (local / base) : 0;
+        }
+
+        return this->grid_.makeModel(idx);
+    }
+
     std::optional<std::size_t> localFromIdx(const std::vector<std::size_t>& idx) const noexcept override {
         if constexpr (N == 0) return 0;
 
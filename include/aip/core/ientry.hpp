@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <memory>
 #include <vector>
 #include <cstddef>
@@ -8,6 +9,8 @@
 #include <functional>
 #include <string_view>
 
+#include <aip/core/fingerprint.hpp>
+#include <aip/core/param_field.hpp>
 #include <aip/model/imodel.hpp>
 #include <aip/model/piecewise_model.hpp>
 
@@ -19,6 +22,24 @@ using IM = aip::model::IModel<In, Out>;
 template <class In, class Out, class Domain>
 using PM = aip::model::PiecewiseModel<In, Out, Domain>;
 
+/**
+ * @brief Собственное состояние стратегии сегмента, независимое от состояния самого IEntry.
+ *
+ * Курсоры оркестратора (Orchestrator::Cursor) держат по одному на сегмент, поэтому несколько
+ * потоков могут идти по потоку стратегии одновременно.
+ */
+struct IStrategyCursor {
+    virtual ~IStrategyCursor() = default;
+
+    /// Встать на шаг step потока стратегии (0 — первый вариант). false — поток короче.
+    virtual bool seek(std::size_t step) = 0;
+
+    /// Перейти к следующему варианту. false — поток закончился.
+    virtual bool next() = 0;
+
+    virtual std::optional<std::size_t> currentLocal() const noexcept = 0;
+};
+
 /**
  * @brief Внутренний type-erasure интерфейс для сегмента оркестратора.
  *
@@ -52,8 +73,34 @@ struct IEntry {
 
     virtual std::optional<std::size_t> currentLocal() const noexcept = 0;
 
+    /**
+     * @brief Пакетный вариант currentLocal() + next(): записать в out текущий и следующие локальные
+     *        индексы потока стратегии, сдвинув состояние за них.
+     *
+     * @return Число записанных индексов. Меньше out.size() — поток закончился (currentLocal() == nullopt).
+     */
+    virtual std::size_t nextLocals(std::span<std::size_t> out) {
+        std::size_t n = 0;
+        for (; n < out.size(); ++n) {
+            const auto local = currentLocal();
+            if (!local) break;
+            out[n] = *local;
+            next();
+        }
+        return n;
+    }
+
     virtual const Domain& getDomain() const noexcept = 0;
 
+    /// @brief Новый курсор по потоку стратегии сегмента (до seek() не стоит ни на каком варианте).
+    [[nodiscard]] virtual std::unique_ptr<IStrategyCursor> makeCursor() const = 0;
+
+    /**
+     * @brief Длина потока стратегии после reset(): size() для SkippableStrategy, иначе — подсчёт
+     *        проходом свежей стратегии (O(size())).
+     */
+    [[nodiscard]] virtual std::size_t streamLength() const = 0;
+
     /**
      * @brief Добавить в piecewise-модель вариант сегмента по локальному индексу (stateless).
      *
@@ -80,6 +127,56 @@ struct IEntry {
     virtual void forEachParamAt(std::size_t local,
                                 const std::function<void(std::string_view label, std::string value)>& fn) const = 0;
 
+    /// @brief Число параметров решётки сегмента (размер буфера для paramsAt()).
+    [[nodiscard]] virtual std::size_t paramCount() const noexcept { return 0; }
+
+    /**
+     * @brief Типизированный обход параметров кандидата local без аллокаций и форматирования.
+     *
+     * Пишет min(paramCount(), out.size()) значений в порядке параметров решётки. Для связанных
+     * сегментов, как и forEachParamAt(), — значения решётки до подгонки по соседям.
+     *
+     * @return Число записанных параметров.
+     */
+    virtual std::size_t paramsAt(std::size_t local, std::span<ParamField> out) const noexcept {
+        (void)local;
+        (void)out;
+        return 0;
+    }
+
+    /**
+     * @brief Ширина блока кандидатов для evalLanes() (0 — пакетная оценка не поддерживается).
+     */
+    [[nodiscard]] virtual std::size_t laneWidth() const noexcept { return 0; }
+
+    /**
+     * @brief Пакетно вычислить выходы блока последовательных локальных кандидатов (stateless).
+     *
+     * Блок — кандидаты [localBegin, localBegin + laneWidth()). Результат пишется point-major:
+     * out[i * laneWidth() + l] — выход кандидата localBegin + l в точке xs[i].
+     * Требуется out.size() >= xs.size() * laneWidth().
+     *
+     * @return Число валидных кандидатов в блоке (0 — пакетная оценка не поддерживается
+     *         или localBegin >= size()).
+     */
+    virtual std::size_t evalLanes(std::size_t localBegin, std::span<const In> xs, std::span<Out> out) const {
+        (void)localBegin;
+        (void)xs;
+        (void)out;
+        return 0;
+    }
+
+    /**
+     * @brief Отпечаток содержимого сегмента: типы модели/входа/выхода, диапазоны решётки и домен.
+     *
+     * Два сегмента с равными отпечатками дают одинаковые модели при одинаковых local — по нему
+     * кэшируются оценки между запусками (см. aip::search::ScoreCache).
+     *
+     * @return std::nullopt, если сегмент нельзя описать точно (например, связанный сегмент
+     *         зависит от соседей, или домен не поддаётся хешированию).
+     */
+    [[nodiscard]] virtual std::optional<Fingerprint> fingerprint() const { return std::nullopt; }
+
     /**
      * Для работы со стратегией
      */
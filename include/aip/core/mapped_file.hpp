@@ -0,0 +1,204 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define AIP_HAS_MMAP 1
+#else
+#define AIP_HAS_MMAP 0
+#endif
+
+namespace aip::core {
+
+/**
+ * @brief Файл, отображённый в память.
+ *
+ * На POSIX — mmap(MAP_SHARED): изменения видны другим процессам и попадают на диск без явной записи
+ * (flush() лишь форсирует msync). На прочих платформах содержимое читается в буфер и
+ * записывается обратно в flush()/деструкторе — поведение то же, только без разделяемой памяти.
+ *
+ * @note Объект не потокобезопасен; указатель data() инвалидируется при resize().
+ */
+class MappedFile {
+   public:
+    enum class Mode { ReadOnly, ReadWrite };
+
+    MappedFile() = default;
+
+    /**
+     * @brief Открыть (в ReadWrite — при необходимости создать) файл и отобразить его.
+     *
+     * @param minSize В режиме ReadWrite файл дополняется нулями до этого размера.
+     *
+     * @throws std::system_error при ошибках ОС.
+     */
+    MappedFile(const std::filesystem::path& path, Mode mode, std::size_t minSize = 0) : path_(path), mode_(mode) {
+#if AIP_HAS_MMAP
+        const int flags = mode == Mode::ReadOnly ? O_RDONLY : (O_RDWR | O_CREAT);
+        fd_ = ::open(path.c_str(), flags, 0644);
+        if (fd_ < 0) throwErrno("open");
+
+        try {
+            struct stat st {};
+            if (::fstat(fd_, &st) != 0) throwErrno("fstat");
+            std::size_t size = static_cast<std::size_t>(st.st_size);
+            if (mode == Mode::ReadWrite && size < minSize) {
+                if (::ftruncate(fd_, static_cast<off_t>(minSize)) != 0) throwErrno("ftruncate");
+                size = minSize;
+            }
+            map(size);
+        } catch (...) {
+            close();
+            throw;
+        }
+#else
+        if (mode == Mode::ReadWrite && !std::filesystem::exists(path)) std::ofstream(path, std::ios::binary).flush();
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), path.string());
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (mode == Mode::ReadWrite && buffer_.size() < minSize) buffer_.resize(minSize, 0);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& o) noexcept { swap(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept {
+        if (this != &o) {
+            close();
+            swap(o);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { close(); }
+
+    [[nodiscard]] bool isOpen() const noexcept { return opened(); }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::byte* data() noexcept { return static_cast<std::byte*>(data_); }
+    [[nodiscard]] const std::byte* data() const noexcept { return static_cast<const std::byte*>(data_); }
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+    /**
+     * @brief Изменить размер файла (новые байты — нули) и переотобразить его.
+     *
+     * @throws std::logic_error в режиме ReadOnly.
+     * @throws std::system_error при ошибках ОС.
+     */
+    void resize(std::size_t newSize) {
+        if (mode_ != Mode::ReadWrite) throw std::logic_error("MappedFile: resize() requires ReadWrite mode");
+#if AIP_HAS_MMAP
+        unmap();
+        if (::ftruncate(fd_, static_cast<off_t>(newSize)) != 0) throwErrno("ftruncate");
+        map(newSize);
+#else
+        buffer_.resize(newSize, 0);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    /// Сбросить изменения на диск.
+    void flush() {
+        if (mode_ != Mode::ReadWrite) return;
+#if AIP_HAS_MMAP
+        if (data_ && ::msync(data_, size_, MS_SYNC) != 0) throwErrno("msync");
+#else
+        if (!opened()) return;
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        if (!out) throw std::system_error(std::make_error_code(std::errc::io_error), path_.string());
+#endif
+    }
+
+    void close() noexcept {
+#if AIP_HAS_MMAP
+        unmap();
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#else
+        if (opened()) {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+#endif
+        path_.clear();
+    }
+
+   private:
+    std::filesystem::path path_;
+    Mode mode_{Mode::ReadOnly};
+    void* data_{nullptr};
+    std::size_t size_{0};
+
+#if AIP_HAS_MMAP
+    int fd_{-1};
+
+    bool opened() const noexcept { return fd_ >= 0; }
+
+    [[noreturn]] void throwErrno(const char* what) const {
+        const int err = errno;
+        throw std::system_error(err, std::generic_category(),
+                                std::string("MappedFile: ") + what + " " + path_.string());
+    }
+
+    void map(std::size_t size) {
+        size_ = size;
+        data_ = nullptr;
+        if (size == 0) return;  // mmap нулевой длины недопустим
+        const int prot = mode_ == Mode::ReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void* p = ::mmap(nullptr, size, prot, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) throwErrno("mmap");
+        data_ = p;
+    }
+
+    void unmap() noexcept {
+        if (data_) ::munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    void swap(MappedFile& o) noexcept {
+        std::swap(path_, o.path_);
+        std::swap(mode_, o.mode_);
+        std::swap(data_, o.data_);
+        std::swap(size_, o.size_);
+        std::swap(fd_, o.fd_);
+    }
+#else
+    std::vector<char> buffer_;
+
+    bool opened() const noexcept { return !path_.empty(); }
+
+    void swap(MappedFile& o) noexcept {
+        std::swap(path_, o.path_);
+        std::swap(mode_, o.mode_);
+        std::swap(buffer_, o.buffer_);
+        std::swap(size_, o.size_);
+        data_ = buffer_.data();
+        o.data_ = o.buffer_.data();
+    }
+#endif
+};
+
+}  // namespace aip::core
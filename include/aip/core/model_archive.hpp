@@ -0,0 +1,434 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <typeindex>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include <aip/core/fingerprint.hpp>
+#include <aip/core/mapped_file.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/param_traits.hpp>
+#include <aip/model/piecewise_model.hpp>
+
+namespace aip::core {
+
+/**
+ * @brief Реестр типов моделей, которые можно сохранить в ModelArchive и загрузить обратно.
+ *
+ * Тип регистрируется под строковым тегом вместе со списком сохраняемых полей (pointer-to-member,
+ * как в ParamGrid). Поле-ControlParam сохраняется под своим именем, "голое" поле — по позиции.
+ * Значения хранятся как double (через ParamTraits::ref/set), поэтому тип значения поля должен быть
+ * арифметическим; целые больше 2^53 по модулю теряют точность.
+ *
+ * Для связанных (constrained) сегментов сохраняется уже подогнанная модель: перечислите все поля,
+ * которые меняет binder, — даже если решётка сегмента пустая (UnitGrid).
+ *
+ * @code
+ * aip::core::ModelRegistry<double, double> reg;
+ * reg.add<Line, &Line::k, &Line::b>("line");
+ * @endcode
+ */
+template <typename In, typename Out>
+class ModelRegistry {
+   public:
+    using IM = aip::model::IModel<In, Out>;
+
+    struct Codec {
+        std::string tag;
+        std::uint64_t tagHash{};
+        /// Имя поля (пусто — неименованное поле, сопоставляется по позиции).
+        std::vector<std::string_view> labels;
+        void (*read)(const IM& m, std::span<double> out);
+        std::shared_ptr<const IM> (*make)(std::span<const double> values);
+    };
+
+    /**
+     * @throws std::invalid_argument если тег пуст, тег или тип уже зарегистрированы.
+     */
+    template <typename Model, auto... Members>
+    void add(std::string tag) {
+        static_assert(std::is_base_of_v<IM, Model>, "ModelRegistry::add: Model must derive from IModel<In, Out>");
+        static_assert(std::is_default_constructible_v<Model>,
+                      "ModelRegistry::add: Model must be default-constructible");
+        static_assert((std::is_arithmetic_v<value_type<Model, Members>> && ...),
+                      "ModelRegistry::add: archived fields must hold arithmetic values");
+
+        if (tag.empty()) throw std::invalid_argument("ModelRegistry: tag must not be empty");
+        const std::uint64_t hash = tagHash(tag);
+        if (byTag_.contains(hash)) throw std::invalid_argument("ModelRegistry: tag is already registered");
+        if (byType_.contains(typeid(Model))) throw std::invalid_argument("ModelRegistry: type is already registered");
+
+        Codec c;
+        c.tag = std::move(tag);
+        c.tagHash = hash;
+        c.labels = {labelOf<Model, Members>()...};
+        c.read = [](const IM& m, std::span<double> out) {
+            const auto& model = static_cast<const Model&>(m);
+            std::size_t i = 0;
+            ((out[i++] = static_cast<double>(traits<Model, Members>::ref(model.*Members))), ...);
+        };
+        c.make = [](std::span<const double> values) -> std::shared_ptr<const IM> {
+            Model model{};
+            std::size_t i = 0;
+            (traits<Model, Members>::set(model.*Members, static_cast<value_type<Model, Members>>(values[i++])), ...);
+            (void)values;
+            return std::make_shared<Model>(std::move(model));
+        };
+
+        byTag_.emplace(hash, codecs_.size());
+        byType_.emplace(typeid(Model), codecs_.size());
+        codecs_.push_back(std::move(c));
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return codecs_.size(); }
+
+    /// Кодек для динамического типа модели (nullptr — тип не зарегистрирован).
+    [[nodiscard]] const Codec* find(const IM& m) const noexcept {
+        const auto it = byType_.find(typeid(m));
+        return it == byType_.end() ? nullptr : &codecs_[it->second];
+    }
+
+    /// Кодек по тегу (nullptr — тег не зарегистрирован).
+    [[nodiscard]] const Codec* find(std::string_view tag) const noexcept {
+        const auto it = byTag_.find(tagHash(tag));
+        if (it == byTag_.end() || codecs_[it->second].tag != tag) return nullptr;
+        return &codecs_[it->second];
+    }
+
+    [[nodiscard]] static std::uint64_t tagHash(std::string_view tag) noexcept {
+        Fingerprinter f;
+        f.add(tag);
+        return f.result()->lo;
+    }
+
+   private:
+    template <typename Model, auto M>
+    using field_type = std::remove_reference_t<decltype(std::declval<Model&>().*M)>;
+
+    template <typename Model, auto M>
+    using traits = aip::params::ParamTraits<field_type<Model, M>>;
+
+    template <typename Model, auto M>
+    using value_type = typename traits<Model, M>::range_type;
+
+    template <typename Model, auto M>
+    static constexpr std::string_view labelOf() noexcept {
+        if constexpr (traits<Model, M>::is_named) {
+            return traits<Model, M>::name.sv();
+        } else {
+            return {};
+        }
+    }
+
+    std::vector<Codec> codecs_;
+    std::unordered_map<std::uint64_t, std::size_t> byTag_;
+    std::unordered_map<std::type_index, std::size_t> byType_;
+};
+
+/**
+ * @brief Компактный бинарный снимок выбранной piecewise-конфигурации.
+ *
+ * Глобальный индекс оркестратора имеет смысл только вместе с тем же оркестратором; архив же
+ * самодостаточен: для каждого сегмента хранятся тег типа модели, значения полей (по именам
+ * ControlParam) и домен. Обычный путь — ModelArchive::write(orch.makePiecewise(best), registry, path).
+ *
+ * Формат — записи фиксированного размера, читаемые прямо из отображённого файла (MappedFile),
+ * без разбора текста:
+ *   Header | SegmentRecord x segmentCount | ParamRecord x paramCount | Domain x segmentCount | строки
+ * Строки (теги и имена полей) хранятся один раз в общем пуле. Порядок байт и представление
+ * double — платформенные; заголовок содержит отпечаток типов In/Out/Domain, так что архив,
+ * записанный с другими типами (или другим компилятором — имена типов из typeid), не откроется.
+ *
+ * Domain должен быть trivially copyable и default-constructible: он хранится байтами объекта.
+ *
+ * Строковые значения (tag(), param().label) ссылаются в отображённый файл и живут, пока жив архив.
+ */
+template <typename In, typename Out, typename Domain>
+class ModelArchive {
+   public:
+    static_assert(std::is_trivially_copyable_v<Domain> && std::is_default_constructible_v<Domain>,
+                  "ModelArchive: Domain must be trivially copyable and default-constructible");
+
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    using Registry = ModelRegistry<In, Out>;
+    using PM = aip::model::PiecewiseModel<In, Out, Domain>;
+
+    struct Param {
+        std::string_view label;  // пусто — неименованное поле
+        double value{};
+    };
+
+    /**
+     * @brief Открыть архив только для чтения.
+     *
+     * @throws std::runtime_error если файл не является архивом этой версии с этими In/Out/Domain
+     *         или повреждён.
+     * @throws std::system_error при ошибках ОС.
+     */
+    explicit ModelArchive(const std::filesystem::path& path)
+        : file_(path, aip::core::MappedFile::Mode::ReadOnly) {
+        const auto bad = [] { return std::runtime_error("ModelArchive: not a model archive of a supported version"); };
+        if (file_.size() < sizeof(Header)) throw bad();
+        const Header h = header();
+        const Fingerprint types = typesFingerprint();
+        if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0 || h.version != kFormatVersion ||
+            h.typesHi != types.hi || h.typesLo != types.lo || h.domainBytes != sizeof(Domain))
+            throw bad();
+        // Каждая часть не больше файла — иначе bytesFor() может переполниться и совпасть с размером.
+        const std::uint64_t size = file_.size();
+        if (h.stringBytes > size || h.segmentCount > size / (sizeof(SegmentRecord) + sizeof(Domain)) ||
+            h.paramCount > size / sizeof(ParamRecord) ||
+            size != bytesFor(h.segmentCount, h.paramCount, static_cast<std::size_t>(h.stringBytes)))
+            throw bad();
+
+        layout(h.segmentCount, h.paramCount);
+        stringCount_ = h.stringBytes;
+
+        // Проверка ссылок один раз при открытии — дальше доступ без проверок.
+        std::uint64_t params = 0;
+        for (std::size_t i = 0; i < segmentCount_; ++i) {
+            const SegmentRecord s = segment(i);
+            if (s.firstParam != params || !inPool(s.tagOffset, s.tagLength) || s.tagLength == 0) throw bad();
+            params += s.paramCount;
+        }
+        if (params != h.paramCount) throw bad();
+        for (std::size_t j = 0; j < h.paramCount; ++j) {
+            const ParamRecord p = param(j);
+            if (!inPool(p.labelOffset, p.labelLength)) throw bad();
+        }
+    }
+
+    /**
+     * @brief Записать конфигурацию в файл.
+     *
+     * Файл сначала пишется рядом (path + ".tmp") и затем переименовывается поверх path: процессы,
+     * держащие старую версию отображённой, продолжают видеть её целиком.
+     *
+     * @throws std::invalid_argument если модель сегмента пуста или её тип не зарегистрирован.
+     * @throws std::system_error при ошибках ОС.
+     */
+    static void write(const PM& pm, const Registry& registry, const std::filesystem::path& path) {
+        const std::size_t segments = pm.segmentCount();
+
+        std::vector<SegmentRecord> segs(segments);
+        std::vector<ParamRecord> params;
+        std::string pool;
+        std::unordered_map<std::string_view, std::uint32_t> interned;
+        const auto intern = [&](std::string_view s) {
+            if (const auto it = interned.find(s); it != interned.end()) return it->second;
+            const auto off = static_cast<std::uint32_t>(pool.size());
+            pool.append(s);
+            interned.emplace(s, off);
+            return off;
+        };
+
+        std::vector<double> values;
+        for (std::size_t i = 0; i < segments; ++i) {
+            const auto& m = pm.modelAt(i);
+            if (!m) throw std::invalid_argument("ModelArchive: segment has no model");
+            const auto* codec = registry.find(*m);
+            if (!codec) throw std::invalid_argument("ModelArchive: model type is not registered");
+
+            values.resize(codec->labels.size());
+            codec->read(*m, values);
+
+            segs[i] = SegmentRecord{codec->tagHash, intern(codec->tag), static_cast<std::uint32_t>(codec->tag.size()),
+                                    static_cast<std::uint32_t>(params.size()),
+                                    static_cast<std::uint32_t>(values.size())};
+            for (std::size_t k = 0; k < values.size(); ++k) {
+                const std::string_view label = codec->labels[k];
+                const std::uint32_t labelOffset = label.empty() ? 0 : intern(label);
+                params.push_back(ParamRecord{values[k], labelOffset, static_cast<std::uint32_t>(label.size())});
+            }
+        }
+
+        Header h{};
+        std::memcpy(h.magic, kMagic, sizeof(h.magic));
+        h.version = kFormatVersion;
+        h.segmentCount = static_cast<std::uint32_t>(segments);
+        const Fingerprint types = typesFingerprint();
+        h.typesHi = types.hi;
+        h.typesLo = types.lo;
+        h.domainBytes = sizeof(Domain);
+        h.paramCount = static_cast<std::uint32_t>(params.size());
+        h.stringBytes = pool.size();
+
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        std::filesystem::remove(tmp);
+        {
+            aip::core::MappedFile out(tmp, aip::core::MappedFile::Mode::ReadWrite);
+            out.resize(bytesFor(segments, params.size(), pool.size()));
+            std::byte* p = out.data();
+            const auto put = [&](const void* src, std::size_t n) {
+                if (n == 0) return;
+                std::memcpy(p, src, n);
+                p += n;
+            };
+            put(&h, sizeof(h));
+            put(segs.data(), segs.size() * sizeof(SegmentRecord));
+            put(params.data(), params.size() * sizeof(ParamRecord));
+            for (std::size_t i = 0; i < segments; ++i) put(&pm.domainAt(i), sizeof(Domain));
+            put(pool.data(), pool.size());
+            out.flush();
+        }
+        std::filesystem::rename(tmp, path);
+    }
+
+    [[nodiscard]] std::size_t segmentCount() const noexcept { return segmentCount_; }
+
+    [[nodiscard]] std::string_view tag(std::size_t i) const noexcept {
+        const SegmentRecord s = segment(i);
+        return string(s.tagOffset, s.tagLength);
+    }
+
+    [[nodiscard]] Domain domain(std::size_t i) const noexcept {
+        Domain d;
+        std::memcpy(static_cast<void*>(&d), file_.data() + domainsAt_ + i * sizeof(Domain), sizeof(Domain));
+        return d;
+    }
+
+    [[nodiscard]] std::size_t paramCount(std::size_t i) const noexcept { return segment(i).paramCount; }
+
+    /// j-е сохранённое поле i-го сегмента (в порядке регистрации полей).
+    [[nodiscard]] Param param(std::size_t i, std::size_t j) const noexcept {
+        const ParamRecord p = param(segment(i).firstParam + j);
+        return Param{string(p.labelOffset, p.labelLength), p.value};
+    }
+
+    /**
+     * @brief Собрать piecewise-модель по архиву.
+     *
+     * Поля сопоставляются с регистрацией типа: именованные — по имени, неименованные — по позиции.
+     *
+     * @throws std::runtime_error если тег не зарегистрирован или набор полей не совпадает
+     *         с регистрацией (тип изменился после записи архива).
+     */
+    [[nodiscard]] PM load(const Registry& registry) const {
+        PM pm;
+        std::vector<double> values;
+        for (std::size_t i = 0; i < segmentCount_; ++i) {
+            const SegmentRecord s = segment(i);
+            const auto* codec = registry.find(string(s.tagOffset, s.tagLength));
+            if (!codec) throw std::runtime_error("ModelArchive: model tag is not registered");
+
+            const std::size_t n = codec->labels.size();
+            if (s.paramCount != n) throw std::runtime_error("ModelArchive: stored fields do not match the registry");
+            values.assign(n, 0.0);
+            for (std::size_t j = 0; j < n; ++j) {
+                const Param p = param(i, j);
+                const std::size_t k = p.label.empty() ? j : fieldOf(*codec, p.label);
+                if (k >= n || codec->labels[k] != p.label)
+                    throw std::runtime_error("ModelArchive: stored fields do not match the registry");
+                values[k] = p.value;
+            }
+            pm.add(domain(i), codec->make(values));
+        }
+        return pm;
+    }
+
+   private:
+    static constexpr char kMagic[8] = {'A', 'I', 'P', 'M', 'O', 'D', 'E', 'L'};
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t segmentCount;
+        std::uint64_t typesHi;
+        std::uint64_t typesLo;
+        std::uint32_t domainBytes;
+        std::uint32_t paramCount;
+        std::uint64_t stringBytes;
+    };
+
+    struct SegmentRecord {
+        std::uint64_t tagHash;
+        std::uint32_t tagOffset;
+        std::uint32_t tagLength;
+        std::uint32_t firstParam;
+        std::uint32_t paramCount;
+    };
+
+    struct ParamRecord {
+        double value;
+        std::uint32_t labelOffset;
+        std::uint32_t labelLength;
+    };
+
+    static_assert(sizeof(Header) == 48 && sizeof(SegmentRecord) == 24 && sizeof(ParamRecord) == 16);
+
+    aip::core::MappedFile file_;
+    std::size_t segmentCount_{0};
+    std::size_t paramsAt_{0};
+    std::size_t domainsAt_{0};
+    std::size_t stringsAt_{0};
+    std::size_t stringCount_{0};
+
+    static Fingerprint typesFingerprint() noexcept {
+        Fingerprinter f;
+        f.add(std::string_view("aip.ModelArchive"));
+        f.addType<In>();
+        f.addType<Out>();
+        f.addType<Domain>();
+        return *f.result();
+    }
+
+    static constexpr std::size_t bytesFor(std::size_t segments, std::size_t params, std::size_t strings) noexcept {
+        return sizeof(Header) + segments * (sizeof(SegmentRecord) + sizeof(Domain)) + params * sizeof(ParamRecord) +
+               strings;
+    }
+
+    void layout(std::size_t segments, std::size_t params) noexcept {
+        segmentCount_ = segments;
+        paramsAt_ = sizeof(Header) + segments * sizeof(SegmentRecord);
+        domainsAt_ = paramsAt_ + params * sizeof(ParamRecord);
+        stringsAt_ = domainsAt_ + segments * sizeof(Domain);
+    }
+
+    static std::size_t fieldOf(const typename Registry::Codec& c, std::string_view label) noexcept {
+        return static_cast<std::size_t>(std::find(c.labels.begin(), c.labels.end(), label) - c.labels.begin());
+    }
+
+    // Доступ через memcpy: записи в файле не обязаны быть выровнены.
+    [[nodiscard]] Header header() const noexcept {
+        Header h{};
+        std::memcpy(&h, file_.data(), sizeof(h));
+        return h;
+    }
+
+    [[nodiscard]] SegmentRecord segment(std::size_t i) const noexcept {
+        SegmentRecord s{};
+        std::memcpy(&s, file_.data() + sizeof(Header) + i * sizeof(SegmentRecord), sizeof(s));
+        return s;
+    }
+
+    [[nodiscard]] ParamRecord param(std::size_t j) const noexcept {
+        ParamRecord p{};
+        std::memcpy(&p, file_.data() + paramsAt_ + j * sizeof(ParamRecord), sizeof(p));
+        return p;
+    }
+
+    [[nodiscard]] bool inPool(std::uint64_t offset, std::uint64_t length) const noexcept {
+        return offset <= stringCount_ && length <= stringCount_ - offset;
+    }
+
+    [[nodiscard]] std::string_view string(std::uint32_t offset, std::uint32_t length) const noexcept {
+        if (length == 0) return {};
+        return {reinterpret_cast<const char*>(file_.data() + stringsAt_ + offset), length};
+    }
+};
+
+}  // namespace aip::core
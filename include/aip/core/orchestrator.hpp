@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <array>
 #include <memory>
 #include <vector>
@@ -8,12 +9,16 @@
 #include <utility>
 #include <optional>
 #include <typeindex>
+#include <algorithm>
+#include <stdexcept>
 #include <type_traits>
 
 #include <aip/core/ientry.hpp>
 #include <aip/core/free_entry.hpp>
 #include <aip/core/constrained_entry.hpp>
 #include <aip/params/param_grid.hpp>
+#include <aip/profile/trace.hpp>
+#include <aip/profile/phase_stats.hpp>
 #include <aip/model/piecewise_model.hpp>
 #include <aip/search/index_strategy.hpp>
 #include <aip/search/enumeration_strategy.hpp>
@@ -39,7 +44,53 @@ class Orchestrator final {
     bool iterate_finished = false;
     std::size_t step{0};
 
+    /// locals из текущего состояния стратегий (nullopt — перебор завершён).
+    std::optional<std::vector<std::size_t>> currentLocals() {
+        AIP_PHASE_SCOPE(Decode);
+        if (!iterate_ready) reset();
+        if (iterate_finished) return std::nullopt;
+
+        std::vector<std::size_t> locals;
+        locals.reserve(entries.size());
+        for (const auto& e : entries) {
+            auto cl = e->currentLocal();
+            if (!cl) {
+                iterate_finished = true;
+                return std::nullopt;
+            }
+            locals.push_back(*cl);
+        }
+        return locals;
+    }
+
+    std::vector<std::size_t> streamLengths() const {
+        std::vector<std::size_t> lengths;
+        lengths.reserve(entries.size());
+        for (const auto& e : entries) lengths.push_back(e->streamLength());
+        return lengths;
+    }
+
+    static std::size_t total(const std::vector<std::size_t>& lengths) noexcept {
+        if (lengths.empty()) return 0;
+        std::size_t n = 1;
+        for (const std::size_t l : lengths) n *= l;
+        return n;
+    }
+
+    /// Сдвинуть одометр стратегий на одну комбинацию (сегмент 0 — младший разряд).
+    void advance() {
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i]->next()) return;
+            entries[i]->reset();
+            if (i + 1 == entries.size()) iterate_finished = true;
+        }
+    }
+
    public:
+    using input_type = In;
+    using output_type = Out;
+    using domain_type = Domain;
+
     struct Snapshot {
         /**
          * @brief номер шага стратегии. Не путать с глобальным индексом оркестратора
@@ -158,6 +209,8 @@ class Orchestrator final {
     }
 
     PM buildAtLocals(const std::vector<std::size_t>& locals) const {
+        AIP_PHASE_SCOPE(Build);
+        AIP_TRACE_SCOPE("build", "model");
         const std::size_t K = entries.size();
         PM pm;
         if (K == 0) return pm;
@@ -189,36 +242,85 @@ class Orchestrator final {
      * @return PiecewiseModel или std::nullopt, если перебор завершён.
      */
     [[nodiscard]] std::optional<PM> next() {
-        if (!iterate_ready) reset();
-        if (iterate_finished) return std::nullopt;
+        auto locals = currentLocals();
+        if (!locals) return std::nullopt;
 
-        // 1) locals из текущего состояния стратегии
-        std::vector<std::size_t> locals;
-        locals.reserve(entries.size());
-        for (const auto& e : entries) {
-            auto cl = e->currentLocal();
-            if (!cl) {
-                iterate_finished = true;
-                return std::nullopt;
-            }
-            locals.push_back(*cl);
-        }
+        PM pm = buildAtLocals(*locals);
+        ++step;
+        advance();
+        return pm;
+    }
+
+    /**
+     * @brief Как next(), но вернуть только глобальный индекс текущей комбинации, не строя модель.
+     *
+     * Удобно, когда стратегия лишь предлагает кандидатов, а оценка (и её дедупликация,
+     * см. aip::search::VisitedSet / ScoreMemo) выполняется снаружи по global.
+     *
+     * @return Глобальный индекс или std::nullopt, если перебор завершён.
+     */
+    [[nodiscard]] std::optional<std::size_t> nextGlobal() {
+        auto locals = currentLocals();
+        if (!locals) return std::nullopt;
 
-        PM pm = buildAtLocals(locals);
+        const std::size_t global = encodeLocals(*locals);
         ++step;
+        advance();
+        return global;
+    }
 
-        // 2) двигаем одометр (как было)
-        for (std::size_t i = 0; i < entries.size(); ++i) {
-            if (entries[i]->next()) {
-                return pm;
-            }
-            entries[i]->reset();
-            if (i + 1 == entries.size()) {
+    /**
+     * @brief Пакетный nextGlobal(): записать в out следующие глобальные индексы в порядке StrategyT.
+     *
+     * Сегмент 0 (младший разряд) отдаёт локальные индексы блоком (IEntry::nextLocals), а вклад
+     * старших сегментов пересчитывается только при переносе — вместо виртуальных вызовов
+     * и вектора locals на каждый шаг. Чередуется с next()/nextGlobal() без потери шагов.
+     *
+     * @return Число записанных индексов (меньше out.size() только в конце перебора).
+     */
+    std::size_t nextGlobals(std::span<std::size_t> out) {
+        AIP_PHASE_SCOPE(Decode);
+        if (!iterate_ready) reset();
+        if (entries.empty()) return 0;
+
+        const std::size_t size0 = entries[0]->size();
+        std::size_t n = 0;
+        while (n < out.size() && !iterate_finished) {
+            if (!entries[0]->currentLocal()) {
                 iterate_finished = true;
                 break;
             }
+
+            // вклад старших сегментов: фиксирован, пока сегмент 0 не пройдёт свой поток
+            std::size_t high = 0;
+            std::size_t mul = size0;
+            for (std::size_t i = 1; i < entries.size(); ++i) {
+                const auto cl = entries[i]->currentLocal();
+                if (!cl) {
+                    iterate_finished = true;
+                    return n;
+                }
+                high += *cl * mul;
+                mul *= entries[i]->size();
+            }
+
+            const std::size_t got = entries[0]->nextLocals(out.subspan(n));
+            for (std::size_t j = n; j < n + got; ++j) out[j] += high;
+            n += got;
+            step += got;
+
+            if (!entries[0]->currentLocal()) {
+                // перенос: сегмент 0 начинается заново, старшие сдвигаются на одну комбинацию
+                entries[0]->reset();
+                std::size_t i = 1;
+                for (; i < entries.size(); ++i) {
+                    if (entries[i]->next()) break;
+                    entries[i]->reset();
+                }
+                if (i == entries.size()) iterate_finished = true;
+            }
         }
-        return pm;
+        return n;
     }
 
     /**
@@ -230,15 +332,105 @@ class Orchestrator final {
      * Этот метод не использует reset/next и безопасен для параллельной обработки.
      */
     [[nodiscard]] PM makePiecewise(std::size_t global) const {
-        const std::size_t K = entries.size();
-        std::vector<std::size_t> locals(K, 0);
+        return buildAtLocals(decodeLocals(global));
+    }
 
-        for (std::size_t i = 0; i < K; ++i) {
-            const std::size_t sz = entries[i]->size();
-            locals[i] = (sz > 0) ? (global % sz) : 0;
-            global = (sz > 0) ? (global / sz) : 0;
+    /**
+     * @brief Курсор по отрезку [begin, end) потока шагов StrategyT — того же порядка, что и у next().
+     *
+     * Курсор держит собственное состояние стратегий (IEntry::makeCursor) и не трогает состояние
+     * оркестратора, поэтому разные курсоры можно вести из разных потоков одновременно.
+     * Оркестратор должен жить дольше курсора и не меняться, пока курсор используется.
+     */
+    class Cursor {
+       public:
+        /// Глобальный индекс следующей комбинации (nullopt — отрезок пройден).
+        [[nodiscard]] std::optional<std::size_t> nextGlobal() {
+            if (pos_ >= end_) return std::nullopt;
+            for (std::size_t i = 0; i < cursors_.size(); ++i) locals_[i] = *cursors_[i]->currentLocal();
+            const std::size_t global = orch_->encodeLocals(locals_);
+            if (++pos_ < end_) advance();
+            return global;
         }
-        return buildAtLocals(locals);
+
+        /// Следующая piecewise-модель (nullopt — отрезок пройден).
+        [[nodiscard]] std::optional<PM> next() {
+            auto global = nextGlobal();
+            if (!global) return std::nullopt;
+            return orch_->buildAtLocals(locals_);
+        }
+
+        /// Номер следующего шага в потоке стратегии.
+        [[nodiscard]] std::size_t position() const noexcept { return pos_; }
+        [[nodiscard]] std::size_t end() const noexcept { return end_; }
+        [[nodiscard]] std::size_t remaining() const noexcept { return end_ - pos_; }
+
+       private:
+        friend class Orchestrator;
+
+        const Orchestrator* orch_{nullptr};
+        std::vector<std::unique_ptr<detail::IStrategyCursor>> cursors_;
+        std::vector<std::size_t> locals_;
+        std::size_t pos_{0};
+        std::size_t end_{0};
+
+        Cursor(const Orchestrator& orch, const std::vector<std::size_t>& lengths, std::size_t begin, std::size_t end)
+            : orch_(&orch), locals_(orch.entries.size()), pos_(begin), end_(end) {
+            if (pos_ >= end_) return;
+            // шаг потока — число в смешанной системе по длинам потоков сегментов (сегмент 0 — младший разряд)
+            cursors_.reserve(orch.entries.size());
+            for (std::size_t i = 0; i < orch.entries.size(); ++i) {
+                cursors_.push_back(orch.entries[i]->makeCursor());
+                cursors_.back()->seek(begin % lengths[i]);
+                begin /= lengths[i];
+            }
+        }
+
+        void advance() {
+            for (auto& c : cursors_) {
+                if (c->next()) return;
+                c->seek(0);
+            }
+        }
+    };
+
+    /**
+     * @brief Число шагов потока StrategyT: произведение IEntry::streamLength() (для полных стратегий — size()).
+     */
+    [[nodiscard]] std::size_t streamSize() const { return total(streamLengths()); }
+
+    /**
+     * @brief Курсор по шагам [begin, min(end, streamSize())) потока StrategyT.
+     *
+     * Со SkippableStrategy курсор встаёт на begin за O(entryCount() * N), иначе каждый сегмент
+     * проматывает свою стратегию вызовами next() (не дальше длины своего потока).
+     */
+    [[nodiscard]] Cursor cursor(std::size_t begin, std::size_t end) const {
+        const auto lengths = streamLengths();
+        return Cursor(*this, lengths, begin, std::min(end, total(lengths)));
+    }
+
+    /**
+     * @brief Разрезать поток StrategyT на k смежных непересекающихся курсоров (по одному на поток).
+     *
+     * Конкатенация курсоров по порядку даёт ту же последовательность, что reset() + next() до конца.
+     * Длины частей отличаются не больше чем на 1; при k > streamSize() хвостовые курсоры пусты.
+     *
+     * @throws std::invalid_argument если k == 0.
+     */
+    [[nodiscard]] std::vector<Cursor> split(std::size_t k) const {
+        if (k == 0) throw std::invalid_argument("Orchestrator::split: k must be positive");
+        const auto lengths = streamLengths();
+        const std::size_t n = total(lengths);
+
+        std::vector<Cursor> parts;
+        parts.reserve(k);
+        for (std::size_t p = 0; p < k; ++p) {
+            const std::size_t begin = n / k * p + std::min(p, n % k);
+            const std::size_t end = begin + n / k + (p < n % k ? 1 : 0);
+            parts.push_back(Cursor(*this, lengths, begin, end));
+        }
+        return parts;
     }
 
     [[nodiscard]] Snapshot snapshot() const {
@@ -252,16 +444,42 @@ class Orchestrator final {
     inline const detail::IEntry<In, Out, Domain>& operator[](size_t idx) const { return *entries[idx]; };
 
     [[nodiscard]] std::vector<std::size_t> decodeLocals(std::size_t global) const {
-        std::vector<std::size_t> locals;
-        locals.reserve(entries.size());
+        std::vector<std::size_t> locals(entries.size());
+        decodeLocals(global, locals);
+        return locals;
+    }
 
-        for (const auto& e : entries) {
-            const std::size_t sz = e->size();
-            const std::size_t local = (sz > 0) ? (global % sz) : 0;
+    /**
+     * @brief decodeLocals без аллокаций: записать локальные индексы в out.
+     *
+     * @note Ожидается out.size() == entryCount().
+     */
+    void decodeLocals(std::size_t global, std::span<std::size_t> out) const {
+        AIP_PHASE_SCOPE(Decode);
+        assert(out.size() == entries.size() && "decodeLocals: one slot per entry expected");
+
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const std::size_t sz = entries[i]->size();
+            out[i] = (sz > 0) ? (global % sz) : 0;
             global = (sz > 0) ? (global / sz) : 0;
-            locals.push_back(local);
         }
-        return locals;
+    }
+
+    /**
+     * @brief Обратное к decodeLocals: собрать глобальный индекс из локальных (сегмент 0 — младший разряд).
+     *
+     * @note Ожидается locals.size() == entryCount() и locals[i] < (*this)[i].size().
+     */
+    [[nodiscard]] std::size_t encodeLocals(const std::vector<std::size_t>& locals) const noexcept {
+        assert(locals.size() == entries.size() && "encodeLocals: one local per entry expected");
+
+        std::size_t global = 0;
+        std::size_t mul = 1;
+        for (std::size_t i = 0; i < entries.size() && i < locals.size(); ++i) {
+            global += locals[i] * mul;
+            mul *= entries[i]->size();
+        }
+        return global;
     }
 
     template <class Fn>
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+#include <system_error>
+
+namespace aip::core {
+
+/**
+ * @brief Значение параметра без форматирования в строку.
+ *
+ * Целые (и enum, и bool) хранятся точно как int64/uint64, floating-point — как double.
+ * std::monostate — тип значения не числовой: такой параметр доступен только через
+ * IEntry::forEachParamAt (строкой).
+ */
+using ParamValue = std::variant<std::monostate, std::int64_t, std::uint64_t, double>;
+
+/**
+ * @brief Параметр кандидата для типизированного обхода (IEntry::paramsAt).
+ *
+ * label ссылается на compile-time имя ControlParam (статическое хранилище) и пуст для
+ * неименованных полей; index — позиция параметра в решётке (порядок Members...).
+ */
+struct ParamField {
+    std::string_view label;
+    std::size_t index{};
+    ParamValue value;
+};
+
+/// Перевести значение диапазона в ParamValue.
+template <typename T>
+[[nodiscard]] constexpr ParamValue toParamValue(const T& v) noexcept {
+    if constexpr (std::is_enum_v<T>) {
+        return toParamValue(static_cast<std::underlying_type_t<T>>(v));
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return static_cast<std::int64_t>(v);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return static_cast<std::int64_t>(v);
+    } else if constexpr (std::is_integral_v<T>) {
+        return static_cast<std::uint64_t>(v);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<double>(v);
+    } else {
+        (void)v;
+        return std::monostate{};
+    }
+}
+
+/// Значение как double (NaN для std::monostate).
+[[nodiscard]] inline double asDouble(const ParamValue& v) noexcept {
+    switch (v.index()) {
+        case 1: return static_cast<double>(*std::get_if<std::int64_t>(&v));
+        case 2: return static_cast<double>(*std::get_if<std::uint64_t>(&v));
+        case 3: return *std::get_if<double>(&v);
+        default: return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+/**
+ * @brief Записать значение в [first, last) через std::to_chars (double — кратчайшее точное представление).
+ *
+ * std::monostate ничего не пишет. При нехватке места ec == std::errc::value_too_large.
+ */
+inline std::to_chars_result toChars(char* first, char* last, const ParamValue& v) noexcept {
+    switch (v.index()) {
+        case 1: return std::to_chars(first, last, *std::get_if<std::int64_t>(&v));
+        case 2: return std::to_chars(first, last, *std::get_if<std::uint64_t>(&v));
+        case 3: return std::to_chars(first, last, *std::get_if<double>(&v));
+        default: return {first, std::errc{}};
+    }
+}
+
+}  // namespace aip::core
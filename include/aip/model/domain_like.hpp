@@ -1,6 +1,8 @@
 #pragma once
 
+#include <utility>
 #include <concepts>
+#include <type_traits>
 
 namespace aip::model {
 
@@ -21,4 +23,38 @@ concept DomainLike = requires(const D& d, const In& x) {
     { d(x) } -> std::convertible_to<bool>;
 };
 
+/**
+ * @brief Трейты домена-интервала: позволяют заменить перебор доменов таблицей точек разрыва
+ *        (FlatEvaluator, tabulate, PiecewiseModel::evaluateSorted).
+ *
+ * По умолчанию выключены (домен — произвольный предикат). Домен, который на самом деле является
+ * интервалом числовой оси, подключается специализацией:
+ *
+ * @code
+ * template <>
+ * struct aip::model::IntervalDomainTraits<Seg> {
+ *     static constexpr bool enabled = true;
+ *     // концы интервала (±inf — неограниченная сторона); включённость концов не важна
+ *     static std::pair<double, double> bounds(const Seg& s) noexcept { return {s.lo, s.hi}; }
+ * };
+ * @endcode
+ *
+ * Контракт: внутри (lo, hi) предикат истинен, вне [lo, hi] — ложен. Значение в самих концах
+ * берётся из предиката при построении таблицы, поэтому подходят и [lo, hi), и [lo, hi], и (lo, hi).
+ */
+template <typename Domain>
+struct IntervalDomainTraits {
+    static constexpr bool enabled = false;
+};
+
+/**
+ * @brief Концепт: домен подключил IntervalDomainTraits для числового входа In.
+ */
+template <typename Domain, typename In>
+concept IntervalDomain = IntervalDomainTraits<Domain>::enabled && std::is_arithmetic_v<In> &&
+                         requires(const Domain& d) {
+                             { IntervalDomainTraits<Domain>::bounds(d).first } -> std::convertible_to<In>;
+                             { IntervalDomainTraits<Domain>::bounds(d).second } -> std::convertible_to<In>;
+                         };
+
 }  // namespace aip::model
\ No newline at end of file
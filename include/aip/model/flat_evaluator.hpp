@@ -0,0 +1,341 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <optional>
+#include <typeinfo>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <aip/model/imodel.hpp>
+#include <aip/model/domain_like.hpp>
+#include <aip/model/piecewise_model.hpp>
+
+namespace aip::model {
+
+/**
+ * @brief "Замороженная" кусочная модель для обслуживания запросов.
+ *
+ * Строится из PiecewiseModel функцией freeze<Models...>() и далее не меняется:
+ *  - поиск сегмента — по отсортированной таблице точек разрыва через равномерную сетку корзин
+ *    (O(1) в среднем; при сильно неравномерных точках — бинарный поиск) для IntervalDomain,
+ *    иначе перебор доменов, хранящихся по значению в непрерывном массиве;
+ *  - параметры моделей известных типов Models... хранятся по значению в std::variant, вызов
+ *    статический (без shared_ptr и виртуального вызова); модели прочих типов вызываются через IModel.
+ *
+ * Семантика совпадает с PiecewiseModel: выигрывает первый (в порядке add) сегмент, чей домен содержит x;
+ * вне всех доменов operator() возвращает NaN (или Out{} для не-floating Out).
+ *
+ * Все методы const и без внутреннего состояния: один экземпляр можно разделять между потоками.
+ *
+ * @tparam Models Конкретные (копируемые) типы моделей, для которых строятся статические ядра.
+ */
+template <typename In, typename Out, typename Domain, typename... Models>
+    requires DomainLike<Domain, In>
+class FlatEvaluator final : public IModel<In, Out> {
+   public:
+    using Kernel = std::variant<Models..., std::shared_ptr<const IModel<In, Out>>>;
+
+    /// Есть ли таблица точек разрыва (иначе сегмент ищется перебором доменов).
+    static constexpr bool kHasBreakpoints = IntervalDomain<Domain, In>;
+
+    explicit FlatEvaluator(const PiecewiseModel<In, Out, Domain>& pm) {
+        const std::size_t K = pm.segmentCount();
+        kernels_.reserve(K);
+        for (std::size_t i = 0; i < K; ++i) {
+            if (!pm.modelAt(i)) throw std::invalid_argument("FlatEvaluator: segment without a model");
+            kernels_.push_back(makeKernel(pm.modelAt(i)));
+        }
+
+        if constexpr (kHasBreakpoints) {
+            buildBreakpoints(pm);
+        } else {
+            domains_.reserve(K);
+            for (std::size_t i = 0; i < K; ++i) domains_.push_back(pm.domainAt(i));
+        }
+    }
+
+    [[nodiscard]] std::size_t segmentCount() const noexcept { return kernels_.size(); }
+
+    /// Сколько сегментов получили статическое ядро (тип модели входит в Models...).
+    [[nodiscard]] std::size_t devirtualizedCount() const noexcept {
+        std::size_t n = 0;
+        for (const auto& k : kernels_) n += k.index() < sizeof...(Models);
+        return n;
+    }
+
+    /// Индекс сегмента, которому принадлежит x (nullopt — вне всех доменов).
+    [[nodiscard]] std::optional<std::size_t> segmentOf(const In& x) const noexcept {
+        const std::int32_t s = locate(x);
+        if (s < 0) return std::nullopt;
+        return static_cast<std::size_t>(s);
+    }
+
+    [[nodiscard]] std::optional<Out> evaluate(const In& x) const noexcept {
+        const std::int32_t s = locate(x);
+        if (s < 0) return std::nullopt;
+        return dispatch(static_cast<std::size_t>(s), x);
+    }
+
+    [[nodiscard]] Out operator()(const In& x) const noexcept override {
+        const std::int32_t s = locate(x);
+        if (s < 0) return missing();
+        return dispatch(static_cast<std::size_t>(s), x);
+    }
+
+    /**
+     * @brief Пакетная оценка: out[i] = (*this)(xs[i]).
+     *
+     * Серия подряд идущих точек одной ячейки таблицы разрыва считается одним вызовом ядра
+     * (один std::visit на серию, внутри — плотный цикл без диспетчеризации); для серии проверяется
+     * только попадание в границы текущей ячейки. Выгоднее всего на отсортированных входах.
+     *
+     * @throws std::invalid_argument если out.size() < xs.size().
+     */
+    void evaluate(std::span<const In> xs, std::span<Out> out) const override {
+        if (out.size() < xs.size()) throw std::invalid_argument("FlatEvaluator::evaluate: out is too small");
+
+        const std::size_t n = xs.size();
+        std::size_t i = 0;
+        while (i < n) {
+            if constexpr (kHasBreakpoints) {
+                if constexpr (std::is_floating_point_v<In>) {
+                    if (std::isnan(xs[i])) {
+                        out[i++] = missing();
+                        continue;
+                    }
+                }
+                const std::size_t c = cellOf(xs[i]);
+                i = consume(owner_[c], xs, out, i, cellRange(c));
+            } else {
+                const std::int32_t s = locate(xs[i]);
+                i = consume(s, xs, out, i, [&](const In& x) { return locate(x) == s; });
+            }
+        }
+    }
+
+   private:
+    std::vector<Kernel> kernels_;
+
+    // IntervalDomain: breaks_ — отсортированные уникальные конечные концы интервалов (m штук).
+    // Ячейка c = #{b < x} + #{b <= x} в [0, 2m]: чётная 2k — x строго между breaks_[k-1] и breaks_[k],
+    // нечётная 2k+1 — x == breaks_[k]. owner_[c] — сегмент ячейки, -1 — ни один домен.
+    std::vector<In> breaks_;
+    std::vector<std::int32_t> owner_;
+
+    // Равномерная сетка корзин над [breaks_.front(), breaks_.back()]: bucketStart_[b] — индекс первой
+    // точки разрыва, не меньшей левого края корзины b. Поиск ячейки — O(1) в среднем.
+    std::vector<std::uint32_t> bucketStart_;
+    double bucketOrigin_{0};
+    double bucketScale_{0};
+    /// Точки разрыва сгруппированы неравномерно — корзины бесполезны, используется бинарный поиск.
+    bool bisect_{false};
+
+    /// До стольких точек разрыва ячейка ищется прямым проходом по таблице (дешевле корзин).
+    static constexpr std::size_t kShortTable = 8;
+    /// Больше стольких точек разрыва в одной корзине — переход на бинарный поиск.
+    static constexpr std::size_t kMaxBucketLoad = 8;
+
+    // Иначе — домены по значению, перебор в порядке добавления.
+    std::vector<Domain> domains_;
+
+    static Kernel makeKernel(const std::shared_ptr<const IModel<In, Out>>& m) {
+        Kernel k{m};
+        // точное совпадение динамического типа: наследник M не должен "срезаться" до M
+        (void)((typeid(*m) == typeid(Models) ? (k.template emplace<Models>(static_cast<const Models&>(*m)), true)
+                                             : false) ||
+               ...);
+        return k;
+    }
+
+    template <typename K>
+    static Out call(const K& k, const In& x) noexcept {
+        if constexpr (std::is_same_v<K, std::shared_ptr<const IModel<In, Out>>>) {
+            return (*k)(x);
+        } else {
+            return k.K::operator()(x);  // квалифицированный вызов — без виртуальной диспетчеризации
+        }
+    }
+
+    Out dispatch(std::size_t s, const In& x) const noexcept {
+        return std::visit([&](const auto& k) { return call(k, x); }, kernels_[s]);
+    }
+
+    static Out missing() noexcept {
+        if constexpr (std::is_floating_point_v<Out>) {
+            return std::numeric_limits<Out>::quiet_NaN();
+        } else {
+            return Out{};
+        }
+    }
+
+    /// Посчитать сегмент s для xs[i], xs[i+1], ... пока inRun(x); вернуть индекс первой точки вне серии.
+    template <typename InRun>
+    std::size_t consume(std::int32_t s, std::span<const In> xs, std::span<Out> out, std::size_t i,
+                        const InRun& inRun) const {
+        const std::size_t n = xs.size();
+        if (s < 0) {
+            do {
+                out[i] = missing();
+            } while (++i < n && inRun(xs[i]));
+            return i;
+        }
+        return std::visit(
+            [&](const auto& k) {
+                do {
+                    out[i] = call(k, xs[i]);
+                } while (++i < n && inRun(xs[i]));
+                return i;
+            },
+            kernels_[static_cast<std::size_t>(s)]);
+    }
+
+    /// Предикат "x в ячейке c" (NaN не принадлежит ни одной ячейке).
+    auto cellRange(std::size_t c) const noexcept {
+        const std::size_t k = c / 2, m = breaks_.size();
+        const bool point = c % 2 == 1, hasLo = k > 0, hasHi = k < m;
+        const In lo = point ? breaks_[k] : (hasLo ? breaks_[k - 1] : In{});
+        const In hi = hasHi ? breaks_[k] : In{};
+        return [=](const In& x) noexcept {
+            if (point) return x == lo;
+            return (!hasLo || lo < x) && (!hasHi || x < hi);
+        };
+    }
+
+    std::int32_t locate(const In& x) const noexcept {
+        if constexpr (kHasBreakpoints) {
+            if constexpr (std::is_floating_point_v<In>) {
+                if (std::isnan(x)) return -1;
+            }
+            return owner_[cellOf(x)];
+        } else {
+            for (std::size_t i = 0; i < domains_.size(); ++i)
+                if (domains_[i](x)) return static_cast<std::int32_t>(i);
+            return -1;
+        }
+    }
+
+    std::size_t cellOf(const In& x) const noexcept {
+        const std::size_t m = breaks_.size();
+        std::size_t k = 0;  // k = #{b < x}
+        if (m <= kShortTable) {
+            while (k < m && breaks_[k] < x) ++k;
+        } else {
+            k = countBelow(x);
+        }
+        return 2 * k + static_cast<std::size_t>(k < m && breaks_[k] == x);
+    }
+
+    /// #{b < x} для длинной таблицы (вынесено, чтобы короткий путь cellOf встраивался).
+    std::size_t countBelow(const In& x) const noexcept {
+        if (bisect_)
+            return static_cast<std::size_t>(std::lower_bound(breaks_.begin(), breaks_.end(), x) - breaks_.begin());
+
+        // стартовая точка из корзины; шаги назад/вперёд делают результат точным при любом округлении
+        const std::size_t m = breaks_.size();
+        const double t = (static_cast<double>(x) - bucketOrigin_) * bucketScale_;
+        const double last = static_cast<double>(bucketStart_.size() - 1);
+        std::size_t k = bucketStart_[static_cast<std::size_t>(t > 0 ? (t < last ? t : last) : 0.0)];
+        while (k > 0 && !(breaks_[k - 1] < x)) --k;
+        while (k < m && breaks_[k] < x) ++k;
+        return k;
+    }
+
+    void buildBreakpoints(const PiecewiseModel<In, Out, Domain>& pm) {
+        const std::size_t K = pm.segmentCount();
+        for (std::size_t i = 0; i < K; ++i) {
+            const auto [lo, hi] = IntervalDomainTraits<Domain>::bounds(pm.domainAt(i));
+            for (const In b : {static_cast<In>(lo), static_cast<In>(hi)}) {
+                if constexpr (std::is_floating_point_v<In>) {
+                    if (!std::isfinite(b)) continue;
+                }
+                breaks_.push_back(b);
+            }
+        }
+        std::sort(breaks_.begin(), breaks_.end());
+        breaks_.erase(std::unique(breaks_.begin(), breaks_.end()), breaks_.end());
+
+        const auto firstMatch = [&](const In& x) -> std::int32_t {
+            for (std::size_t i = 0; i < K; ++i)
+                if (pm.domainAt(i)(x)) return static_cast<std::int32_t>(i);
+            return -1;
+        };
+
+        const std::size_t m = breaks_.size();
+        owner_.assign(2 * m + 1, -1);
+        for (std::size_t k = 0; k < m; ++k) owner_[2 * k + 1] = firstMatch(breaks_[k]);
+
+        if (m == 0) {
+            // только неограниченные интервалы: предикат постоянен на всей оси
+            owner_[0] = firstMatch(In{});
+            bisect_ = true;
+            return;
+        }
+        owner_[0] = firstMatch(outside(breaks_.front(), -1));
+        owner_[2 * m] = firstMatch(outside(breaks_.back(), +1));
+        for (std::size_t k = 1; k < m; ++k) {
+            const In a = breaks_[k - 1], b = breaks_[k];
+            const In mid = static_cast<In>(a + (b - a) / 2);
+            // у целых соседних концов внутренних точек нет: ячейка не используется
+            if (a < mid && mid < b) owner_[2 * k] = firstMatch(mid);
+        }
+        buildBuckets();
+    }
+
+    void buildBuckets() {
+        const std::size_t m = breaks_.size();
+        const double lo = static_cast<double>(breaks_.front()), hi = static_cast<double>(breaks_.back());
+        const std::size_t B = 2 * m;
+        bucketOrigin_ = lo;
+        bucketScale_ = static_cast<double>(B) / (hi - lo);
+        if (!(hi > lo) || !std::isfinite(bucketScale_) || bucketScale_ <= 0) {
+            bisect_ = true;
+            return;
+        }
+        bucketStart_.assign(B + 1, 0);
+        std::size_t k = 0, maxLoad = 0;
+        for (std::size_t b = 0; b <= B; ++b) {
+            const std::size_t first = k;
+            const double edge = lo + static_cast<double>(b) / bucketScale_;
+            while (k < m && static_cast<double>(breaks_[k]) < edge) ++k;
+            bucketStart_[b] = static_cast<std::uint32_t>(k);
+            maxLoad = std::max(maxLoad, k - first);
+        }
+        bisect_ = maxLoad > kMaxBucketLoad;
+    }
+
+    /// Точка строго левее (dir < 0) или правее (dir > 0) b.
+    static In outside(const In& b, int dir) noexcept {
+        if constexpr (std::is_floating_point_v<In>) {
+            return b + static_cast<In>(dir) * (std::abs(b) + In{1});
+        } else {
+            return dir < 0 ? static_cast<In>(b - 1) : static_cast<In>(b + 1);
+        }
+    }
+};
+
+/**
+ * @brief Скомпилировать PiecewiseModel в FlatEvaluator.
+ *
+ * @tparam Models Типы моделей, для которых нужны статические ядра (обычно — типы моделей решёток
+ *                оркестратора). Порядок не важен; модели других типов остаются виртуальными.
+ *
+ * @code
+ * const auto flat = aip::model::freeze<Line, Parabola>(orch.makePiecewise(bestGlobal));
+ * flat.evaluate(std::span<const double>(xs), std::span<double>(ys));
+ * @endcode
+ */
+template <typename... Models, typename In, typename Out, typename Domain>
+[[nodiscard]] FlatEvaluator<In, Out, Domain, Models...> freeze(const PiecewiseModel<In, Out, Domain>& pm) {
+    return FlatEvaluator<In, Out, Domain, Models...>(pm);
+}
+
+}  // namespace aip::model
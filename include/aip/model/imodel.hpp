@@ -1,5 +1,9 @@
 #pragma once
 
+#include <span>
+#include <cstddef>
+#include <stdexcept>
+
 namespace aip::model {
 
 /**
@@ -35,6 +39,19 @@ class IModel {
      * @note Эта функция не должна изменять внутреннее состояние модели.
      */
     [[nodiscard]] virtual Out operator()(const In& x) const noexcept = 0;
+
+    /**
+     * @brief Просчитать модель на массиве входов: out[i] = (*this)(xs[i]).
+     *
+     * Реализация по умолчанию — цикл по operator(). Модели с векторизуемым ядром переопределяют метод,
+     * и пакетный инференс (PiecewiseModel, aip::search::evaluateParallel) вызывает его на целых сериях точек.
+     *
+     * @throws std::invalid_argument если out.size() < xs.size().
+     */
+    virtual void evaluate(std::span<const In> xs, std::span<Out> out) const {
+        if (out.size() < xs.size()) throw std::invalid_argument("IModel::evaluate: out is too small");
+        for (std::size_t i = 0; i < xs.size(); ++i) out[i] = (*this)(xs[i]);
+    }
 };
 
 }  // namespace aip::model
\ No newline at end of file
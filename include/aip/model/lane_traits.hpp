@@ -0,0 +1,55 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+
+namespace aip::model {
+
+/// Ширина блока кандидатов по умолчанию (число "дорожек" SIMD при пакетной оценке).
+inline constexpr std::size_t kDefaultLaneWidth = 8;
+
+/**
+ * @brief Трейты пакетной (по кандидатам) оценки модели.
+ *
+ * По умолчанию выключены: кандидаты оцениваются по одному (скалярный путь).
+ *
+ * Модель может подключить lane-parallel ядро специализацией:
+ *
+ * @code
+ * template <>
+ * struct aip::model::LaneTraits<Line> {
+ *     static constexpr bool enabled = true;
+ *     static constexpr std::size_t width = 8;
+ *
+ *     // lanes — ParamGrid::Lanes<width>: std::tuple<std::array<T_i, width>...> в порядке Members.
+ *     // out[i * width + l] — выход кандидата l в точке xs[i].
+ *     template <class Lanes>
+ *     static void eval(const Lanes& lanes, std::span<const double> xs, std::span<double> out) noexcept {
+ *         const auto& [m, c] = lanes;
+ *         for (std::size_t i = 0; i < xs.size(); ++i)
+ *             for (std::size_t l = 0; l < width; ++l) out[i * width + l] = m[l] * xs[i] + c[l];
+ *     }
+ * };
+ * @endcode
+ *
+ * Ядро всегда получает полный блок из width кандидатов: незаполненные дорожки продублированы
+ * последним валидным кандидатом, их выходы игнорируются.
+ *
+ * @tparam Model Тип модели.
+ */
+template <typename Model>
+struct LaneTraits {
+    static constexpr bool enabled = false;
+    static constexpr std::size_t width = kDefaultLaneWidth;
+};
+
+/**
+ * @brief Концепт: модель подключила lane-parallel ядро для данного типа дорожек.
+ */
+template <typename Model, typename Lanes, typename In, typename Out>
+concept LaneKernel = LaneTraits<Model>::enabled &&
+                     requires(const Lanes& lanes, std::span<const In> xs, std::span<Out> out) {
+                         LaneTraits<Model>::eval(lanes, xs, out);
+                     };
+
+}  // namespace aip::model
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <span>
+#include <array>
+#include <cmath>
 #include <vector>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <optional>
+#include <algorithm>
 #include <stdexcept>
 #include <type_traits>
 
@@ -43,6 +49,15 @@ class PiecewiseModel final : public IModel<In, Out> {
      */
     void add(Domain d, std::shared_ptr<const IModel<In, Out>> m) { entries.push_back({std::move(d), std::move(m)}); }
 
+    /// Число сегментов (в порядке добавления).
+    [[nodiscard]] std::size_t segmentCount() const noexcept { return entries.size(); }
+
+    [[nodiscard]] const Domain& domainAt(std::size_t i) const { return entries.at(i).domain; }
+
+    [[nodiscard]] const std::shared_ptr<const IModel<In, Out>>& modelAt(std::size_t i) const {
+        return entries.at(i).model;
+    }
+
     [[nodiscard]] std::optional<Out> evaluate(const In& x) const noexcept {
         for (const auto& e : entries) {
             if (e.domain(x)) {
@@ -63,13 +78,248 @@ class PiecewiseModel final : public IModel<In, Out> {
         if (auto r = evaluate(x)) {
             return *r;
         }
+        return missing();
+    }
+
+    /**
+     * @brief Пакетная оценка: out[i] = (*this)(xs[i]).
+     *
+     * Точки идут блоками по kBatchBlock: для каждой находится сегмент, затем модель сегмента получает
+     * целую серию точек через IModel::evaluate (векторизованное ядро, если модель его переопределила).
+     * Отсортированные или сгруппированные по доменам входы дают длинные серии как есть; перемешанный
+     * блок сначала упорядочивается по сегментам, а результаты разносятся обратно на исходные места.
+     * Буферы блока — на стеке, без аллокаций.
+     *
+     * @throws std::invalid_argument если out.size() < xs.size().
+     */
+    void evaluate(std::span<const In> xs, std::span<Out> out) const override {
+        if (out.size() < xs.size()) throw std::invalid_argument("PiecewiseModel::evaluate: out is too small");
+        for (std::size_t b = 0; b < xs.size(); b += kBatchBlock) {
+            const std::size_t n = std::min(kBatchBlock, xs.size() - b);
+            evaluateBlock(xs.subspan(b, n), out.subspan(b, n));
+        }
+    }
+
+    class SortedCursor;
+
+    /**
+     * @brief Курсор evaluateSorted, построенный один раз (для повторных вызовов на той же модели).
+     * @note Курсор ссылается на модель: после add() его нужно построить заново.
+     */
+    [[nodiscard]] SortedCursor sortedCursor() const
+        requires IntervalDomain<Domain, In>
+    {
+        return SortedCursor(*this);
+    }
+
+    /**
+     * @brief Оценка входов, отсортированных по возрастанию, курсором по точкам разрыва доменов.
+     *
+     * Строит SortedCursor на время вызова: O(S log S + cells * S) на таблицу и O(points) на проход.
+     * При повторных вызовах на той же модели выгоднее один раз взять sortedCursor().
+     *
+     * @throws std::invalid_argument если out.size() < xs.size().
+     */
+    void evaluateSorted(std::span<const In> xs, std::span<Out> out) const
+        requires IntervalDomain<Domain, In>
+    {
+        SortedCursor(*this).evaluate(xs, out);
+    }
+
+    /**
+     * @brief Таблица концов доменов и владельцев ячеек между ними для оценки отсортированных входов.
+     *
+     * Концы доменов сортируются, а владелец каждой ячейки (первый сегмент, чей домен её содержит)
+     * определяется один раз при построении, как в FlatEvaluator. Дальше курсор по ячейкам только движется
+     * вперёд, и каждая максимальная серия точек одного сегмента уходит одним вызовом IModel::evaluate:
+     * O(points + cells) на вызов, домены не опрашиваются.
+     *
+     * Неотсортированный вход обрабатывается корректно: при шаге назад курсор переставляется
+     * бинарным поиском. NaN даёт NaN (или Out{}) и курсор не сдвигает.
+     */
+    class SortedCursor {
+       public:
+        explicit SortedCursor(const PiecewiseModel& pm)
+            requires IntervalDomain<Domain, In>
+            : pm_(&pm) {
+            for (const auto& e : pm.entries) {
+                const auto [lo, hi] = IntervalDomainTraits<Domain>::bounds(e.domain);
+                for (const In b : {static_cast<In>(lo), static_cast<In>(hi)}) {
+                    if constexpr (std::is_floating_point_v<In>) {
+                        if (!std::isfinite(b)) continue;
+                    }
+                    breaks_.push_back(b);
+                }
+            }
+            std::sort(breaks_.begin(), breaks_.end());
+            breaks_.erase(std::unique(breaks_.begin(), breaks_.end()), breaks_.end());
+
+            // ячейка c: чётная 2k — строго между breaks_[k-1] и breaks_[k], нечётная 2k+1 — точка breaks_[k]
+            const std::size_t m = breaks_.size();
+            owner_.assign(2 * m + 1, -1);
+            for (std::size_t k = 0; k < m; ++k) owner_[2 * k + 1] = pm.segmentIndex(breaks_[k]);
+            if (m == 0) {
+                owner_[0] = pm.segmentIndex(In{});  // только неограниченные интервалы
+                return;
+            }
+            owner_[0] = pm.segmentIndex(outside(breaks_.front(), -1));
+            owner_[2 * m] = pm.segmentIndex(outside(breaks_.back(), +1));
+            for (std::size_t k = 1; k < m; ++k) {
+                const In a = breaks_[k - 1], b = breaks_[k];
+                const In mid = static_cast<In>(a + (b - a) / 2);
+                // у целых соседних концов внутренних точек нет: ячейка не используется
+                if (a < mid && mid < b) owner_[2 * k] = pm.segmentIndex(mid);
+            }
+        }
+
+        /// @throws std::invalid_argument если out.size() < xs.size().
+        void evaluate(std::span<const In> xs, std::span<Out> out) const {
+            if (out.size() < xs.size())
+                throw std::invalid_argument("PiecewiseModel::evaluateSorted: out is too small");
+
+            std::size_t c = 0;
+            for (std::size_t i = 0; i < xs.size();) {
+                const In& x = xs[i];
+                if constexpr (std::is_floating_point_v<In>) {
+                    if (std::isnan(x)) {
+                        out[i++] = missing();
+                        continue;
+                    }
+                }
+                if (belowCell(c, x)) {
+                    const auto k =
+                        static_cast<std::size_t>(std::lower_bound(breaks_.begin(), breaks_.end(), x) - breaks_.begin());
+                    c = 2 * k + static_cast<std::size_t>(k < breaks_.size() && breaks_[k] == x);
+                } else {
+                    while (!inCell(c, x)) ++c;
+                }
 
+                // серия продолжается через соседние ячейки того же сегмента
+                const std::int32_t s = owner_[c];
+                std::size_t j = i + 1;
+                for (; j < xs.size(); ++j) {
+                    const In& y = xs[j];
+                    if (inCell(c, y)) continue;
+                    if constexpr (std::is_floating_point_v<In>) {
+                        if (std::isnan(y)) break;
+                    }
+                    if (belowCell(c, y)) break;
+                    while (!inCell(c, y)) ++c;
+                    if (owner_[c] != s) break;
+                }
+                pm_->evaluateRun(s, xs.subspan(i, j - i), out.subspan(i, j - i));
+                i = j;
+            }
+        }
+
+       private:
+        const PiecewiseModel* pm_;
+        std::vector<In> breaks_;
+        std::vector<std::int32_t> owner_;
+
+        bool inCell(std::size_t c, const In& x) const noexcept {
+            const std::size_t k = c / 2;
+            if (c % 2 == 1) return x == breaks_[k];
+            return (k == 0 || breaks_[k - 1] < x) && (k == breaks_.size() || x < breaks_[k]);
+        }
+
+        bool belowCell(std::size_t c, const In& x) const noexcept {
+            const std::size_t k = c / 2;
+            return c % 2 == 1 ? x < breaks_[k] : k > 0 && !(breaks_[k - 1] < x);
+        }
+
+        /// Точка строго левее (dir < 0) или правее (dir > 0) b.
+        static In outside(const In& b, int dir) noexcept {
+            if constexpr (std::is_floating_point_v<In>) {
+                return b + static_cast<In>(dir) * (std::abs(b) + In{1});
+            } else {
+                return dir < 0 ? static_cast<In>(b - 1) : static_cast<In>(b + 1);
+            }
+        }
+    };
+
+   private:
+    static constexpr std::size_t kBatchBlock = 256;
+    /// Средняя длина серии, ниже которой блок переупорядочивается по сегментам.
+    static constexpr std::size_t kMinAverageRun = 8;
+    /// До стольких сегментов блок переупорядочивается сортировкой подсчётом (иначе — сериями как есть).
+    static constexpr std::size_t kMaxGatherSegments = 64;
+
+    static Out missing() noexcept {
         if constexpr (std::is_floating_point_v<Out>) {
             return std::numeric_limits<Out>::quiet_NaN();
         } else {
             return Out{};
         }
     }
+
+    /// Индекс первого сегмента, чей домен содержит x; -1 — ни одного.
+    std::int32_t segmentIndex(const In& x) const noexcept {
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            if (entries[i].domain(x)) return static_cast<std::int32_t>(i);
+        return -1;
+    }
+
+    void evaluateRun(std::int32_t seg, std::span<const In> xs, std::span<Out> out) const {
+        if (seg < 0) {
+            std::fill(out.begin(), out.end(), missing());
+        } else {
+            entries[static_cast<std::size_t>(seg)].model->evaluate(xs, out);
+        }
+    }
+
+    void evaluateBlock(std::span<const In> xs, std::span<Out> out) const {
+        const std::size_t n = xs.size();
+        std::array<std::int32_t, kBatchBlock> seg;
+        std::size_t runs = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            seg[i] = segmentIndex(xs[i]);
+            runs += static_cast<std::size_t>(i == 0 || seg[i] != seg[i - 1]);
+        }
+
+        constexpr bool kCanGather = std::is_trivially_copyable_v<In> && std::is_trivially_copyable_v<Out> &&
+                                    std::is_default_constructible_v<In> && std::is_default_constructible_v<Out>;
+        if constexpr (kCanGather) {
+            if (runs * kMinAverageRun > n && entries.size() <= kMaxGatherSegments) {
+                gatherBlock(xs, out, std::span<const std::int32_t>(seg).first(n));
+                return;
+            }
+        }
+
+        for (std::size_t i = 0; i < n;) {
+            std::size_t j = i + 1;
+            while (j < n && seg[j] == seg[i]) ++j;
+            evaluateRun(seg[i], xs.subspan(i, j - i), out.subspan(i, j - i));
+            i = j;
+        }
+    }
+
+    /// Сортировка блока подсчётом по сегменту (порядок внутри сегмента сохраняется), счёт, разнос обратно.
+    void gatherBlock(std::span<const In> xs, std::span<Out> out, std::span<const std::int32_t> seg) const {
+        const std::size_t n = xs.size();
+        // корзина 0 — точки вне всех доменов, s + 1 — сегмент s
+        std::array<std::size_t, kMaxGatherSegments + 2> start{};
+        for (std::size_t i = 0; i < n; ++i) ++start[static_cast<std::size_t>(seg[i] + 1) + 1];
+        for (std::size_t k = 1; k < start.size(); ++k) start[k] += start[k - 1];
+
+        std::array<std::size_t, kMaxGatherSegments + 2> fill = start;
+        std::array<std::uint16_t, kBatchBlock> pos;
+        std::array<In, kBatchBlock> gx;
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t at = fill[static_cast<std::size_t>(seg[i] + 1)]++;
+            pos[at] = static_cast<std::uint16_t>(i);
+            gx[at] = xs[i];
+        }
+
+        std::array<Out, kBatchBlock> gy;
+        for (std::size_t k = 0; k + 1 < start.size(); ++k) {
+            if (start[k] == start[k + 1]) continue;
+            const std::size_t len = start[k + 1] - start[k];
+            evaluateRun(static_cast<std::int32_t>(k) - 1, std::span<const In>(gx).subspan(start[k], len),
+                        std::span<Out>(gy).subspan(start[k], len));
+        }
+        for (std::size_t i = 0; i < n; ++i) out[pos[i]] = gy[i];
+    }
 };
 
 }  // namespace aip::model
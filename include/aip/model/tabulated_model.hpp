@@ -0,0 +1,365 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <aip/model/imodel.hpp>
+#include <aip/model/lane_traits.hpp>
+#include <aip/model/domain_like.hpp>
+#include <aip/model/piecewise_model.hpp>
+
+namespace aip::model {
+
+/// Интерполяция внутри ячейки таблицы.
+enum class Interpolation : std::uint8_t {
+    Linear,  ///< хорда по концам ячейки
+    Cubic,   ///< кубический многочлен по концам и двум внутренним точкам ячейки
+};
+
+struct TabulationOptions {
+    /// Допустимая абсолютная ошибка |table(x) - model(x)| (проверяется в пробных точках каждой ячейки).
+    double maxAbsError{1e-6};
+    Interpolation interpolation{Interpolation::Cubic};
+    /// Предел размера таблицы; при исчерпании ячейки перестают дробиться (см. TabulatedModel::withinBound()).
+    std::size_t maxCells{1u << 16};
+    /// Пробных точек внутри ячейки при проверке ошибки.
+    std::size_t probesPerCell{8};
+};
+
+/**
+ * @brief Табличная аппроксимация модели на отрезке [lower, upper] для инференса с ограниченной ошибкой.
+ *
+ * Отрезок режется на куски (Piece) с точно соблюдаемыми границами; каждый кусок адаптивно делится пополам,
+ * пока многочлен ячейки (линейный или кубический, см. Interpolation) не уложится в maxAbsError.
+ * Ячейка хранит коэффициенты многочлена по смещению от своего начала, поэтому разрывы между кусками
+ * не размываются. Значение в точке границы по умолчанию берётся из правого куска (полуинтервалы [a, b)),
+ * в точке upper — из последнего; точка с другим владельцем (или без него) задаётся Point и хранится
+ * отдельной ячейкой нулевой ширины с точным значением.
+ *
+ * Поиск ячейки не зависит от сложности исходной модели: равномерная сетка корзин над [lower, upper]
+ * даёт стартовую ячейку, дальше — фиксированное для таблицы число шагов без ветвлений (probeSteps()).
+ * Пакетная оценка идёт блоками по kDefaultLaneWidth точек в форме, которую компилятор векторизует
+ * (в том числе gather-загрузками, если они разрешены целевой архитектурой).
+ *
+ * Вне [lower, upper] и в кусках без модели operator() возвращает NaN.
+ * Объект неизменяем после построения: один экземпляр можно разделять между потоками.
+ */
+template <typename In = double, typename Out = double>
+    requires std::is_floating_point_v<In> && std::is_floating_point_v<Out>
+class TabulatedModel final : public IModel<In, Out> {
+   public:
+    /// Кусок отрезка с собственной моделью; model == nullptr — пробел (NaN).
+    struct Piece {
+        In lower{};
+        In upper{};
+        const IModel<In, Out>* model{nullptr};
+    };
+
+    /// Значение в точке-границе кусков, если оно не из правого (в upper — не из последнего) куска;
+    /// model == nullptr — NaN.
+    struct Point {
+        In x{};
+        const IModel<In, Out>* model{nullptr};
+    };
+
+    /**
+     * @param pieces Смежные куски по возрастанию: pieces[i].upper == pieces[i + 1].lower.
+     * @param points Точки с собственным значением; каждая — конец одного из кусков, без повторов.
+     * @throws std::invalid_argument при пустом/несмежном/вырожденном наборе кусков, точке не на границе
+     *         кусков или maxAbsError <= 0.
+     */
+    TabulatedModel(std::span<const Piece> pieces, const TabulationOptions& opt, std::span<const Point> points = {}) {
+        if (pieces.empty()) throw std::invalid_argument("TabulatedModel: no pieces");
+        if (!(opt.maxAbsError > 0)) throw std::invalid_argument("TabulatedModel: maxAbsError must be positive");
+        for (std::size_t i = 0; i < pieces.size(); ++i) {
+            const Piece& p = pieces[i];
+            if (!(std::isfinite(p.lower) && std::isfinite(p.upper) && p.lower < p.upper))
+                throw std::invalid_argument("TabulatedModel: piece must be a finite non-empty interval");
+            if (i > 0 && pieces[i - 1].upper != p.lower)
+                throw std::invalid_argument("TabulatedModel: pieces must be contiguous and sorted");
+        }
+
+        lower_ = pieces.front().lower;
+        upper_ = pieces.back().upper;
+
+        std::vector<Point> pts(points.begin(), points.end());
+        std::sort(pts.begin(), pts.end(), [](const Point& a, const Point& b) { return a.x < b.x; });
+        for (std::size_t i = 0; i < pts.size(); ++i) {
+            const bool atBoundary = pts[i].x == upper_ ||
+                                    std::any_of(pieces.begin(), pieces.end(),
+                                                [&](const Piece& p) { return p.lower == pts[i].x; });
+            if (!atBoundary || (i > 0 && pts[i - 1].x == pts[i].x))
+                throw std::invalid_argument("TabulatedModel: points must be distinct piece boundaries");
+        }
+
+        std::size_t nextPoint = 0;
+        for (std::size_t i = 0; i < pieces.size(); ++i) {
+            Piece p = pieces[i];
+            if (nextPoint < pts.size() && pts[nextPoint].x == p.lower) {
+                pushPoint(pts[nextPoint++]);
+                // кусок начинается сразу за точкой: ячейка точки покрывает ровно x == lower
+                p.lower = std::nextafter(p.lower, p.upper);
+                if (!(p.lower < p.upper)) continue;
+            }
+            tabulatePiece(p, opt, pieces.size() - 1 - i + (pts.size() - nextPoint));
+        }
+        if (nextPoint < pts.size()) pushPoint(pts[nextPoint]);  // x == upper
+        buildBuckets();
+    }
+
+    [[nodiscard]] In lower() const noexcept { return lower_; }
+    [[nodiscard]] In upper() const noexcept { return upper_; }
+    [[nodiscard]] std::size_t cellCount() const noexcept { return coeffs_.size(); }
+
+    /// Наибольшая ошибка, замеренная в пробных точках при построении.
+    [[nodiscard]] double maxError() const noexcept { return maxError_; }
+
+    /// Уложилась ли таблица в maxAbsError (false — упёрлись в maxCells).
+    [[nodiscard]] bool withinBound() const noexcept { return withinBound_; }
+
+    /// Шагов уточнения ячейки после корзины (одинаково для всех x).
+    [[nodiscard]] std::size_t probeSteps() const noexcept { return steps_; }
+
+    [[nodiscard]] Out operator()(const In& x) const noexcept override {
+        const In xc = clampToRange(x);
+        std::size_t j = bucketStart_[bucketOf(xc)];
+        for (std::size_t s = 0; s < steps_; ++s) j += static_cast<std::size_t>(xc >= knots_[j + 1]);
+        const Out y = horner(j, xc);
+        return inRange(x) ? y : nan();
+    }
+
+    /**
+     * @brief Пакетная оценка: out[i] = (*this)(xs[i]).
+     *
+     * @throws std::invalid_argument если out.size() < xs.size().
+     */
+    void evaluate(std::span<const In> xs, std::span<Out> out) const override {
+        if (out.size() < xs.size()) throw std::invalid_argument("TabulatedModel::evaluate: out is too small");
+
+        constexpr std::size_t W = kDefaultLaneWidth;
+        const std::size_t n = xs.size();
+        std::size_t i = 0;
+        for (; i + W <= n; i += W) {
+            std::array<In, W> xc;
+            std::array<std::size_t, W> j;
+            for (std::size_t l = 0; l < W; ++l) {
+                xc[l] = clampToRange(xs[i + l]);
+                j[l] = bucketStart_[bucketOf(xc[l])];
+            }
+            for (std::size_t s = 0; s < steps_; ++s)
+                for (std::size_t l = 0; l < W; ++l) j[l] += static_cast<std::size_t>(xc[l] >= knots_[j[l] + 1]);
+            for (std::size_t l = 0; l < W; ++l) {
+                const Out y = horner(j[l], xc[l]);
+                out[i + l] = inRange(xs[i + l]) ? y : nan();
+            }
+        }
+        for (; i < n; ++i) out[i] = (*this)(xs[i]);
+    }
+
+   private:
+    // knots_[c] — начало ячейки c; за последней ячейкой — +inf (steps_ + 1 штук), чтобы шаги не выходили за таблицу.
+    std::vector<In> knots_;
+    // Коэффициенты c0..c3 многочлена ячейки по u = x - knots_[c]; у Linear c2 = c3 = 0; у пробела — NaN.
+    std::vector<std::array<Out, 4>> coeffs_;
+
+    // bucketStart_[b] — ячейка, с которой начинается поиск для x из корзины b.
+    std::vector<std::uint32_t> bucketStart_;
+    double bucketScale_{0};
+    double lastBucket_{0};
+    std::size_t steps_{0};
+
+    In lower_{};
+    In upper_{};
+    double maxError_{0};
+    bool withinBound_{true};
+
+    /// До скольких шагов уточнения сгущается сетка корзин (не больше kMaxBucketsPerCell корзин на ячейку).
+    static constexpr std::size_t kTargetSteps = 2;
+    static constexpr std::size_t kMaxBucketsPerCell = 64;
+
+    static constexpr Out nan() noexcept { return std::numeric_limits<Out>::quiet_NaN(); }
+
+    bool inRange(const In& x) const noexcept { return x >= lower_ && x <= upper_; }
+
+    /// NaN и точки вне отрезка прижимаются к lower_ (результат потом заменяется на NaN).
+    In clampToRange(const In& x) const noexcept { return inRange(x) ? x : lower_; }
+
+    std::size_t bucketOf(const In& x) const noexcept {
+        const double t = (static_cast<double>(x) - static_cast<double>(lower_)) * bucketScale_;
+        // через знаковое целое: double -> size_t на x86-64 без AVX-512 компилируется в ветвление
+        return static_cast<std::size_t>(static_cast<std::int64_t>(t < lastBucket_ ? t : lastBucket_));
+    }
+
+    Out horner(std::size_t c, const In& x) const noexcept {
+        const auto& k = coeffs_[c];
+        const Out u = static_cast<Out>(x - knots_[c]);
+        return k[0] + u * (k[1] + u * (k[2] + u * k[3]));
+    }
+
+    /// reserved — сколько ячеек из maxCells нужно оставить кускам правее.
+    void tabulatePiece(const Piece& p, const TabulationOptions& opt, std::size_t reserved) {
+        if (!p.model) {
+            pushCell(p.lower, {nan(), nan(), nan(), nan()});
+            return;
+        }
+        refine(*p.model, p.lower, p.upper, opt, reserved);
+    }
+
+    /// Ячейка [a, b): принять многочлен или поделить пополам (ячейки добавляются по возрастанию x).
+    void refine(const IModel<In, Out>& m, In a, In b, const TabulationOptions& opt, std::size_t reserved) {
+        const auto k = fit(m, a, b, opt.interpolation);
+
+        double err = 0;
+        const std::size_t probes = std::max<std::size_t>(opt.probesPerCell, 1);
+        for (std::size_t i = 0; i < probes; ++i) {
+            const In x = a + (b - a) * (static_cast<In>(i) + In{0.5}) / static_cast<In>(probes);
+            const Out u = static_cast<Out>(x - a);
+            const double d = static_cast<double>(std::abs(k[0] + u * (k[1] + u * (k[2] + u * k[3])) - m(x)));
+            err = std::isnan(d) ? std::numeric_limits<double>::infinity() : std::max(err, d);
+        }
+
+        const In mid = a + (b - a) / 2;
+        const bool splittable = a < mid && mid < b;
+        if (err > opt.maxAbsError && splittable && coeffs_.size() + reserved + 2 <= opt.maxCells) {
+            refine(m, a, mid, opt, reserved + 1);  // правой половине нужна хотя бы одна ячейка
+            refine(m, mid, b, opt, reserved);
+            return;
+        }
+        if (err > opt.maxAbsError) withinBound_ = false;
+        maxError_ = std::max(maxError_, err);
+        pushCell(a, k);
+    }
+
+    static std::array<Out, 4> fit(const IModel<In, Out>& m, In a, In b, Interpolation kind) {
+        const Out h = static_cast<Out>(b - a);
+        if (kind == Interpolation::Linear) {
+            const Out f0 = m(a), f1 = m(b);
+            return {f0, (f1 - f0) / h, 0, 0};
+        }
+        // Ньютон по узлам u = 0, h/3, 2h/3, h, затем переход к степенному базису по u
+        const Out u1 = h / 3, u2 = 2 * h / 3, u3 = h;
+        const Out f0 = m(a), f1 = m(static_cast<In>(a + (b - a) / 3)), f2 = m(static_cast<In>(a + 2 * (b - a) / 3));
+        const Out f3 = m(b);
+        const Out d01 = (f1 - f0) / u1, d12 = (f2 - f1) / (u2 - u1), d23 = (f3 - f2) / (u3 - u2);
+        const Out d012 = (d12 - d01) / u2, d123 = (d23 - d12) / (u3 - u1);
+        const Out d0123 = (d123 - d012) / u3;
+        return {f0, d01 - d012 * u1 + d0123 * u1 * u2, d012 - d0123 * (u1 + u2), d0123};
+    }
+
+    void pushCell(In start, const std::array<Out, 4>& k) {
+        knots_.push_back(start);
+        coeffs_.push_back(k);
+    }
+
+    void pushPoint(const Point& p) {
+        const Out v = p.model ? (*p.model)(p.x) : nan();
+        pushCell(p.x, {v, 0, 0, 0});
+    }
+
+    /**
+     * Сетка из B корзин: bucketStart_[b] = max{c : bucket(knots_[c]) < b} (или 0). Так как bucketOf монотонна,
+     * ячейка любого x из корзины b не меньше bucketStart_[b] и больше её не более чем на число начал ячеек,
+     * попавших в саму корзину b. Максимум этого числа по корзинам — steps_.
+     */
+    void buildBuckets() {
+        const std::size_t cells = coeffs_.size();
+        std::size_t B = std::bit_ceil(cells);
+        std::vector<std::uint32_t> hits;
+        for (;;) {
+            bucketScale_ = static_cast<double>(B) / (static_cast<double>(upper_) - static_cast<double>(lower_));
+            lastBucket_ = static_cast<double>(B - 1);
+            hits.assign(B, 0);
+            for (std::size_t c = 1; c < cells; ++c) ++hits[bucketOf(knots_[c])];
+            steps_ = *std::max_element(hits.begin(), hits.end());
+            if (steps_ <= kTargetSteps || B >= kMaxBucketsPerCell * cells) break;
+            B *= 2;
+        }
+
+        bucketStart_.assign(B, 0);
+        std::size_t c = 0;
+        for (std::size_t b = 0; b < B; ++b) {
+            while (c + 1 < cells && bucketOf(knots_[c + 1]) < b) ++c;
+            bucketStart_[b] = static_cast<std::uint32_t>(c);
+        }
+        knots_.resize(cells + steps_ + 1, std::numeric_limits<In>::infinity());
+    }
+};
+
+/**
+ * @brief Табулировать модель на [lower, upper].
+ *
+ * @param breaks Точки, которые обязаны стать границами ячеек (например, известные разрывы модели);
+ *               точки вне (lower, upper) игнорируются.
+ */
+template <typename In, typename Out>
+[[nodiscard]] TabulatedModel<In, Out> tabulate(const IModel<In, Out>& model, In lower, In upper,
+                                               const TabulationOptions& opt = {}, std::span<const In> breaks = {}) {
+    if (!(lower < upper)) throw std::invalid_argument("tabulate: lower must be less than upper");
+    std::vector<In> cuts{lower};
+    for (const In b : breaks)
+        if (lower < b && b < upper) cuts.push_back(b);
+    cuts.push_back(upper);
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    std::vector<typename TabulatedModel<In, Out>::Piece> pieces;
+    for (std::size_t i = 0; i + 1 < cuts.size(); ++i) pieces.push_back({cuts[i], cuts[i + 1], &model});
+    return TabulatedModel<In, Out>(pieces, opt);
+}
+
+/**
+ * @brief Табулировать кусочную модель на [lower, upper] с точным соблюдением границ сегментов.
+ *
+ * Требует IntervalDomainTraits для домена: концы доменов становятся границами кусков, каждый кусок
+ * аппроксимирует модель первого (в порядке add) сегмента, содержащего его середину; кусок вне всех
+ * доменов — пробел (NaN). Владелец каждой границы (и lower, upper) определяется предикатом домена,
+ * как в FlatEvaluator: у [0, 1] и (1, 2] точка 1 — первого сегмента, у [3, 4) точка 4 — NaN.
+ *
+ * @code
+ * const auto table = aip::model::tabulate(orch.makePiecewise(bestGlobal), 0.0, 10.0, {.maxAbsError = 1e-4});
+ * table.evaluate(std::span<const double>(xs), std::span<double>(ys));
+ * @endcode
+ */
+template <typename In, typename Out, typename Domain>
+    requires IntervalDomain<Domain, In>
+[[nodiscard]] TabulatedModel<In, Out> tabulate(const PiecewiseModel<In, Out, Domain>& pm, In lower, In upper,
+                                               const TabulationOptions& opt = {}) {
+    if (!(lower < upper)) throw std::invalid_argument("tabulate: lower must be less than upper");
+    std::vector<In> cuts{lower, upper};
+    for (std::size_t i = 0; i < pm.segmentCount(); ++i) {
+        const auto [lo, hi] = IntervalDomainTraits<Domain>::bounds(pm.domainAt(i));
+        for (const In b : {static_cast<In>(lo), static_cast<In>(hi)})
+            if (lower < b && b < upper) cuts.push_back(b);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    const auto ownerOf = [&](const In& x) -> const IModel<In, Out>* {
+        for (std::size_t s = 0; s < pm.segmentCount(); ++s)
+            if (pm.domainAt(s)(x)) return pm.modelAt(s).get();
+        return nullptr;
+    };
+
+    std::vector<typename TabulatedModel<In, Out>::Piece> pieces;
+    for (std::size_t i = 0; i + 1 < cuts.size(); ++i)
+        pieces.push_back({cuts[i], cuts[i + 1], ownerOf(cuts[i] + (cuts[i + 1] - cuts[i]) / 2)});
+
+    // граница, владелец которой не совпадает с куском, дающим её значение по умолчанию, — отдельная точка
+    std::vector<typename TabulatedModel<In, Out>::Point> points;
+    for (std::size_t i = 0; i < cuts.size(); ++i) {
+        const auto* owner = ownerOf(cuts[i]);
+        if (owner != pieces[std::min(i, pieces.size() - 1)].model) points.push_back({cuts[i], owner});
+    }
+    return TabulatedModel<In, Out>(pieces, opt, points);
+}
+
+}  // namespace aip::model
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <span>
+#include <tuple>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+namespace aip::params {
+
+namespace detail {
+
+template <typename RangesTuple>
+struct columns_of;
+
+template <typename... R>
+struct columns_of<std::tuple<R...>> {
+    using type = std::tuple<std::vector<typename R::value_type>...>;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Колоночное (SoA) представление параметров блока кандидатов решётки.
+ *
+ * Для каждого управляемого параметра (в порядке Members...) хранится отдельный массив значений,
+ * упорядоченный по локальному индексу: column<I>()[j] — значение I-го параметра у кандидата
+ * localBegin() + j. Модели при этом не конструируются.
+ *
+ * Предназначено для пакетных/SIMD-ядер, экспорта результатов и т.п. Для больших решёток
+ * используйте блочный обход (forEachParamBlock) — буферы переиспользуются, память ограничена
+ * размером блока.
+ *
+ * @tparam Grid Тип решётки (ParamGrid<...>).
+ */
+template <typename Grid>
+class ParamColumns {
+   public:
+    static constexpr std::size_t N = Grid::N;
+    using columns_type = typename detail::columns_of<std::remove_cvref_t<decltype(std::declval<Grid&>().ranges)>>::type;
+
+    ParamColumns() = default;
+
+    /**
+     * @brief Заполнить столбцы параметрами кандидатов [localBegin, localBegin + count).
+     *
+     * Количество обрезается по размеру решётки. Ёмкость буферов сохраняется между вызовами.
+     *
+     * @return Число материализованных кандидатов.
+     */
+    std::size_t materialize(const Grid& grid, std::size_t localBegin, std::size_t count) {
+        const std::size_t total = grid.size();
+        begin_ = localBegin;
+        size_ = (localBegin < total) ? std::min(count, total - localBegin) : 0;
+
+        std::size_t stride = 1;
+        fillColumns(grid, stride, std::make_index_sequence<N>{});
+
+        grid.forEachParam([&](auto meta, const auto&) { labels_[meta.index] = meta.label; });
+        return size_;
+    }
+
+    /// @brief Число кандидатов в блоке.
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /// @brief Локальный индекс первого кандидата блока.
+    [[nodiscard]] std::size_t localBegin() const noexcept { return begin_; }
+
+    /// @brief Столбец значений I-го параметра.
+    template <std::size_t I>
+    [[nodiscard]] auto column() const noexcept {
+        const auto& c = std::get<I>(columns_);
+        return std::span<const typename std::tuple_element_t<I, columns_type>::value_type>(c.data(), size_);
+    }
+
+    /// @brief Имя I-го параметра (пусто для неименованных).
+    [[nodiscard]] std::string_view label(std::size_t i) const noexcept { return labels_[i]; }
+
+    /**
+     * @brief Вызвать fn(index, label, column) для каждого столбца в порядке Members...
+     */
+    template <typename Fn>
+    void forEachColumn(Fn&& fn) const {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (fn(I, labels_[I], column<I>()), ...);
+        }(std::make_index_sequence<N>{});
+    }
+
+   private:
+    columns_type columns_{};
+    std::array<std::string_view, N> labels_{};
+    std::size_t begin_{0};
+    std::size_t size_{0};
+
+    template <std::size_t... I>
+    void fillColumns(const Grid& grid, std::size_t& stride, std::index_sequence<I...>) {
+        (fillColumn<I>(grid, stride), ...);
+    }
+
+    /**
+     * Значение I-го параметра у local равно range[(local / stride_I) % base_I], т.е. оно постоянно
+     * на отрезках длины stride_I. Заполняем столбец такими отрезками (fill_n), без деления на каждый элемент.
+     */
+    template <std::size_t I>
+    void fillColumn(const Grid& grid, std::size_t& stride) {
+        const auto& r = grid.template get<I>();
+        const std::size_t base = r.size();
+        auto& col = std::get<I>(columns_);
+        col.resize(size_);
+
+        if (size_ > 0) {
+            std::size_t local = begin_;
+            std::size_t idx = (local / stride) % base;
+            std::size_t runLeft = stride - local % stride;
+
+            std::size_t j = 0;
+            while (j < size_) {
+                const std::size_t n = std::min(runLeft, size_ - j);
+                std::fill_n(col.begin() + static_cast<std::ptrdiff_t>(j), n, r[idx]);
+                j += n;
+                runLeft = stride;
+                if (++idx == base) idx = 0;
+            }
+        }
+        stride *= base;
+    }
+};
+
+/**
+ * @brief Материализовать параметры всей решётки в столбцы.
+ *
+ * @warning Память O(grid.size() * N). Для больших решёток используйте forEachParamBlock.
+ */
+template <typename Grid>
+[[nodiscard]] ParamColumns<Grid> materializeParams(const Grid& grid) {
+    ParamColumns<Grid> cols;
+    cols.materialize(grid, 0, grid.size());
+    return cols;
+}
+
+/**
+ * @brief Обойти решётку блоками по blockSize кандидатов в колоночном виде.
+ *
+ * fn(const ParamColumns<Grid>&) вызывается для каждого блока по возрастанию локального индекса.
+ * Один и тот же буфер переиспользуется — память ограничена blockSize * N значений.
+ */
+template <typename Grid, typename Fn>
+void forEachParamBlock(const Grid& grid, std::size_t blockSize, Fn&& fn) {
+    if (blockSize == 0) blockSize = 1;
+
+    ParamColumns<Grid> cols;
+    const std::size_t total = grid.size();
+    for (std::size_t begin = 0; begin < total; begin += blockSize) {
+        cols.materialize(grid, begin, blockSize);
+        fn(static_cast<const ParamColumns<Grid>&>(cols));
+    }
+}
+
+}  // namespace aip::params
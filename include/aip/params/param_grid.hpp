@@ -221,6 +221,61 @@ struct ParamGrid {
         return m;
     }
 
+    /**
+     * @brief Значения параметров W кандидатов в SoA-виде ("дорожки").
+     *
+     * Элемент I кортежа — массив из W значений I-го параметра (в порядке Members...).
+     */
+    template <std::size_t W>
+    using Lanes = std::tuple<std::array<range_value_type<Members>, W>...>;
+
+    /**
+     * @brief Заполнить дорожки параметрами W последовательных кандидатов, начиная с localBegin.
+     *
+     * Локальный индекс раскладывается в смешанной системе счисления по размерам диапазонов
+     * (параметр 0 меняется быстрее всего) — так же, как в оркестраторе.
+     *
+     * Если до конца решётки осталось меньше W кандидатов, хвостовые дорожки заполняются
+     * последним валидным кандидатом.
+     *
+     * @return Число валидных дорожек (0, если localBegin >= size()).
+     */
+    template <std::size_t W>
+    constexpr std::size_t lanesAt(std::size_t localBegin, Lanes<W>& lanes) const noexcept {
+        static_assert(W > 0, "ParamGrid::lanesAt: W must be positive");
+
+        const std::size_t total = size();
+        if (localBegin >= total) return 0;
+        const std::size_t count = (total - localBegin < W) ? (total - localBegin) : W;
+
+        std::array<std::size_t, N> bases{};
+        std::array<std::size_t, N> idx{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((bases[I] = static_cast<std::size_t>(std::get<I>(ranges).size())), ...);
+        }(std::make_index_sequence<N>{});
+
+        std::size_t local = localBegin;
+        for (std::size_t i = 0; i < N; ++i) {
+            idx[i] = local % bases[i];
+            local /= bases[i];
+        }
+
+        for (std::size_t l = 0; l < W; ++l) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((std::get<I>(lanes)[l] = std::get<I>(ranges)[idx[I]]), ...);
+            }(std::make_index_sequence<N>{});
+
+            if (l + 1 >= count) continue;  // хвост дублирует последний валидный кандидат
+
+            // инкремент одометра
+            for (std::size_t i = 0; i < N; ++i) {
+                if (++idx[i] < bases[i]) break;
+                idx[i] = 0;
+            }
+        }
+        return count;
+    }
+
     /**
      * @brief Доступ к диапазону по compile-time имени параметра.
      *
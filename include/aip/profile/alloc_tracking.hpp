@@ -0,0 +1,181 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include <aip/profile/phase_stats.hpp>
+
+namespace aip::profile {
+
+/**
+ * @brief Счётчики аллокаций одного потока.
+ */
+struct AllocationCounts {
+    std::uint64_t allocations{0};
+    std::uint64_t deallocations{0};
+    std::uint64_t bytes{0};
+};
+
+namespace detail {
+
+[[nodiscard]] inline AllocationCounts& threadAllocations() noexcept {
+    thread_local AllocationCounts c;
+    return c;
+}
+
+[[nodiscard]] inline std::atomic<bool>& allocationHooksFlag() noexcept {
+    static std::atomic<bool> installed{false};
+    return installed;
+}
+
+/// Вызывается из operator new (AIP_DEFINE_ALLOCATION_HOOKS). Не аллоцирует.
+inline void noteAllocation(std::size_t bytes) noexcept {
+    auto& c = threadAllocations();
+    ++c.allocations;
+    c.bytes += bytes;
+
+    // аллокация относится к самой внутренней активной фазе (только с AIP_ENABLE_INSTRUMENTATION)
+    const auto& ctx = phaseContext();
+    if (ctx.phase >= 0) ctx.recorder->recordAllocation(static_cast<Phase>(ctx.phase), bytes);
+}
+
+inline void noteDeallocation() noexcept { ++threadAllocations().deallocations; }
+
+}  // namespace detail
+
+/// Установлены ли хуки (AIP_DEFINE_ALLOCATION_HOOKS в одной из единиц трансляции программы).
+[[nodiscard]] inline bool allocationHooksInstalled() noexcept {
+    return detail::allocationHooksFlag().load(std::memory_order_relaxed);
+}
+
+/// Аллокации текущего потока с начала его работы (нули без хуков).
+[[nodiscard]] inline AllocationCounts threadAllocationCounts() noexcept { return detail::threadAllocations(); }
+
+/**
+ * @brief Аллокации текущего потока за время жизни объекта.
+ *
+ * Аллокации других потоков (например, async-задач параллельных драйверов) не учитываются.
+ */
+class AllocScope {
+   public:
+    AllocScope() noexcept : start_(detail::threadAllocations()) {}
+
+    [[nodiscard]] std::uint64_t allocations() const noexcept {
+        return detail::threadAllocations().allocations - start_.allocations;
+    }
+    [[nodiscard]] std::uint64_t bytes() const noexcept { return detail::threadAllocations().bytes - start_.bytes; }
+
+   private:
+    AllocationCounts start_;
+};
+
+/**
+ * @brief Проверка "горячий путь не аллоцирует": если за время жизни охранника поток выделил память,
+ *        деструктор печатает what и число аллокаций в stderr и вызывает std::abort().
+ *
+ * Без установленных хуков ничего не проверяет. Предназначен для тестовых и бенчмарк-сборок.
+ */
+class NoAllocGuard {
+   public:
+    explicit NoAllocGuard(const char* what) noexcept : what_(what) {}
+
+    NoAllocGuard(const NoAllocGuard&) = delete;
+    NoAllocGuard& operator=(const NoAllocGuard&) = delete;
+
+    ~NoAllocGuard() {
+        if (!allocationHooksInstalled() || scope_.allocations() == 0) return;
+        std::fprintf(stderr, "aip: hot path '%s' allocated %llu time(s), %llu byte(s)\n", what_,
+                     static_cast<unsigned long long>(scope_.allocations()),
+                     static_cast<unsigned long long>(scope_.bytes()));
+        std::abort();
+    }
+
+   private:
+    const char* what_;
+    AllocScope scope_;
+};
+
+}  // namespace aip::profile
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define AIP_ALLOC_HOOKS_ALIGNED_ALLOC(n, a) _aligned_malloc((n), (a))
+#define AIP_ALLOC_HOOKS_ALIGNED_FREE(p) _aligned_free(p)
+#define AIP_ALLOC_HOOKS_NOINLINE __declspec(noinline)
+#else
+#define AIP_ALLOC_HOOKS_ALIGNED_ALLOC(n, a) std::aligned_alloc((a), ((n) + (a) - 1) / (a) * (a))
+#define AIP_ALLOC_HOOKS_ALIGNED_FREE(p) std::free(p)
+#define AIP_ALLOC_HOOKS_NOINLINE __attribute__((noinline))
+#endif
+
+/**
+ * @brief Заменить глобальные operator new/delete счётчиками aip::profile.
+ *
+ * Раскрывать ровно в одной единице трансляции исполняемого файла (тест, бенчмарк) в глобальном
+ * пространстве имён. Учитываются все формы new (массивы, nothrow, выровненные).
+ *
+ * Функции не встраиваются: иначе после встраивания operator delete компилятор видит std::free
+ * на указателе из new-выражения (-Wmismatched-new-delete), хотя память и выделена malloc.
+ */
+#define AIP_DEFINE_ALLOCATION_HOOKS()                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void* operator new(std::size_t n) {                                         \
+        ::aip::profile::detail::noteAllocation(n);                                                       \
+        if (void* p = std::malloc(n ? n : 1)) return p;                                                  \
+        throw std::bad_alloc();                                                                          \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void* operator new[](std::size_t n) { return ::operator new(n); }           \
+    AIP_ALLOC_HOOKS_NOINLINE void* operator new(std::size_t n, const std::nothrow_t&) noexcept {         \
+        ::aip::profile::detail::noteAllocation(n);                                                       \
+        return std::malloc(n ? n : 1);                                                                   \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void* operator new[](std::size_t n, const std::nothrow_t& t) noexcept {     \
+        return ::operator new(n, t);                                                                     \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void* operator new(std::size_t n, std::align_val_t a) {                     \
+        ::aip::profile::detail::noteAllocation(n);                                                       \
+        if (void* p = AIP_ALLOC_HOOKS_ALIGNED_ALLOC(n ? n : 1, static_cast<std::size_t>(a))) return p;   \
+        throw std::bad_alloc();                                                                          \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void* operator new[](std::size_t n, std::align_val_t a) {                   \
+        return ::operator new(n, a);                                                                     \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete(void* p) noexcept {                                    \
+        if (!p) return;                                                                                  \
+        ::aip::profile::detail::noteDeallocation();                                                      \
+        std::free(p);                                                                                    \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete[](void* p) noexcept { ::operator delete(p); }          \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete(void* p, std::size_t) noexcept {                       \
+        ::operator delete(p);                                                                            \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete[](void* p, std::size_t) noexcept {                     \
+        ::operator delete(p);                                                                            \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete(void* p, const std::nothrow_t&) noexcept {             \
+        ::operator delete(p);                                                                            \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete[](void* p, const std::nothrow_t&) noexcept {           \
+        ::operator delete(p);                                                                            \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete(void* p, std::align_val_t) noexcept {                  \
+        if (!p) return;                                                                                  \
+        ::aip::profile::detail::noteDeallocation();                                                      \
+        AIP_ALLOC_HOOKS_ALIGNED_FREE(p);                                                                 \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete[](void* p, std::align_val_t a) noexcept {              \
+        ::operator delete(p, a);                                                                         \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete(void* p, std::size_t, std::align_val_t a) noexcept {   \
+        ::operator delete(p, a);                                                                         \
+    }                                                                                                    \
+    AIP_ALLOC_HOOKS_NOINLINE void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { \
+        ::operator delete(p, a);                                                                         \
+    }                                                                                                    \
+    static const bool aip_allocation_hooks_registered = [] {                                             \
+        ::aip::profile::detail::allocationHooksFlag().store(true, std::memory_order_relaxed);            \
+        return true;                                                                                     \
+    }()
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <iomanip>
+#include <utility>
+#include <string_view>
+
+#include <aip/profile/phase_stats.hpp>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#include <cerrno>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define AIP_HAS_PERF_EVENT 1
+#else
+#define AIP_HAS_PERF_EVENT 0
+#endif
+
+namespace aip::profile {
+
+/// Счётчики вокруг фаз включены при сборке (макрос AIP_ENABLE_PERF_COUNTERS / CMake-опция).
+#ifdef AIP_ENABLE_PERF_COUNTERS
+inline constexpr bool kPerfCountersEnabled = true;
+#else
+inline constexpr bool kPerfCountersEnabled = false;
+#endif
+
+/**
+ * @brief Аппаратные счётчики, которые снимаются вокруг фаз поиска.
+ *
+ *  - Cycles, Instructions: IPC — общий индикатор (низкий IPC при высоких промахах — память,
+ *    при низких промахах — front-end, например косвенные вызовы IModel::operator()).
+ *  - LlcMisses:    промахи последнего уровня кэша (PERF_COUNT_HW_CACHE_MISSES).
+ *  - BranchMisses: ошибки предсказания переходов (предикаты доменов, ветвления моделей).
+ */
+enum class Counter : std::size_t { Cycles, Instructions, LlcMisses, BranchMisses };
+
+inline constexpr std::size_t kCounterCount = 4;
+
+[[nodiscard]] constexpr std::string_view counterName(Counter c) noexcept {
+    constexpr std::string_view names[kCounterCount] = {"cycles", "instructions", "llc_misses", "branch_misses"};
+    return names[static_cast<std::size_t>(c)];
+}
+
+/**
+ * @brief Значения счётчиков. Бит i в mask — счётчик i действительно измерялся
+ *        (в контейнере или VM часть счётчиков может быть недоступна).
+ */
+struct CounterValues {
+    std::array<std::uint64_t, kCounterCount> values{};
+    std::uint32_t mask{0};
+
+    [[nodiscard]] bool has(Counter c) const noexcept { return mask & (1u << static_cast<std::size_t>(c)); }
+    [[nodiscard]] std::uint64_t operator[](Counter c) const noexcept { return values[static_cast<std::size_t>(c)]; }
+
+    /// Инструкций за такт (0, если cycles/instructions не измерялись).
+    [[nodiscard]] double ipc() const noexcept {
+        if (!has(Counter::Cycles) || !has(Counter::Instructions) || (*this)[Counter::Cycles] == 0) return 0.0;
+        return static_cast<double>((*this)[Counter::Instructions]) / static_cast<double>((*this)[Counter::Cycles]);
+    }
+
+    /// Разность (this - earlier) для общих счётчиков.
+    [[nodiscard]] CounterValues since(const CounterValues& earlier) const noexcept {
+        CounterValues d;
+        d.mask = mask & earlier.mask;
+        for (std::size_t i = 0; i < kCounterCount; ++i)
+            if (d.mask & (1u << i)) d.values[i] = values[i] >= earlier.values[i] ? values[i] - earlier.values[i] : 0;
+        return d;
+    }
+};
+
+/**
+ * @brief Группа счётчиков perf_event_open для вызывающего потока (только user space).
+ *
+ * Счётчики открываются одной группой и читаются одним read() (PERF_FORMAT_GROUP); при мультиплексировании
+ * значения масштабируются по time_enabled / time_running. Счётчик, который не удалось открыть
+ * (нет PMU, perf_event_paranoid, seccomp в контейнере), просто исключается из mask; если не открылся ни один,
+ * available() == false, а error() объясняет причину. Исключений не бросает.
+ *
+ * Move-only; закрывает дескрипторы в деструкторе. Использовать только в потоке, который его создал.
+ */
+class PerfCounterGroup {
+   public:
+    PerfCounterGroup() { open(); }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    PerfCounterGroup(PerfCounterGroup&& o) noexcept
+        : fds_(std::exchange(o.fds_, kClosed)), order_(o.order_), count_(std::exchange(o.count_, 0)),
+          error_(std::move(o.error_)) {}
+
+    PerfCounterGroup& operator=(PerfCounterGroup&& o) noexcept {
+        if (this != &o) {
+            close();
+            fds_ = std::exchange(o.fds_, kClosed);
+            order_ = o.order_;
+            count_ = std::exchange(o.count_, 0);
+            error_ = std::move(o.error_);
+        }
+        return *this;
+    }
+
+    ~PerfCounterGroup() { close(); }
+
+    [[nodiscard]] bool available() const noexcept { return count_ > 0; }
+
+    /// Какие счётчики открыты (биты Counter).
+    [[nodiscard]] std::uint32_t mask() const noexcept {
+        std::uint32_t m = 0;
+        for (std::size_t i = 0; i < count_; ++i) m |= 1u << static_cast<std::size_t>(order_[i]);
+        return m;
+    }
+
+    /// Почему недоступны (часть) счётчиков; пусто, если открылись все.
+    [[nodiscard]] const std::string& error() const noexcept { return error_; }
+
+    /// Накопленные значения с момента открытия (mask == 0, если недоступны).
+    [[nodiscard]] CounterValues read() const noexcept {
+        CounterValues out;
+#if AIP_HAS_PERF_EVENT
+        if (count_ == 0) return out;
+        // layout PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING: nr, enabled, running, values[nr]
+        std::uint64_t buf[3 + kCounterCount] = {};
+        if (::read(fds_[0], buf, sizeof(buf)) < static_cast<ssize_t>((3 + count_) * sizeof(std::uint64_t)))
+            return out;
+        const std::uint64_t enabled = buf[1], running = buf[2];
+        if (running == 0) return out;  // группа не попала на PMU
+        for (std::size_t i = 0; i < count_ && i < buf[0]; ++i) {
+            const auto c = static_cast<std::size_t>(order_[i]);
+            const double scaled = static_cast<double>(buf[3 + i]) * static_cast<double>(enabled) /
+                                  static_cast<double>(running);
+            out.values[c] = static_cast<std::uint64_t>(scaled);
+            out.mask |= 1u << c;
+        }
+#endif
+        return out;
+    }
+
+   private:
+    static constexpr std::array<int, kCounterCount> kClosed{-1, -1, -1, -1};
+
+    std::array<int, kCounterCount> fds_{kClosed};
+    std::array<Counter, kCounterCount> order_{};  // порядок в группе -> счётчик
+    std::size_t count_{0};
+    std::string error_;
+
+    void open() {
+#if AIP_HAS_PERF_EVENT
+        constexpr std::pair<Counter, std::uint64_t> events[kCounterCount] = {
+            {Counter::Cycles, PERF_COUNT_HW_CPU_CYCLES},
+            {Counter::Instructions, PERF_COUNT_HW_INSTRUCTIONS},
+            {Counter::LlcMisses, PERF_COUNT_HW_CACHE_MISSES},
+            {Counter::BranchMisses, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+        for (const auto& [counter, config] : events) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format =
+                PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int leader = count_ == 0 ? -1 : fds_[0];
+            const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+            if (fd < 0) {
+                if (!error_.empty()) error_ += "; ";
+                error_ += std::string(counterName(counter)) + ": " + std::strerror(errno);
+                continue;
+            }
+            fds_[count_] = static_cast<int>(fd);
+            order_[count_] = counter;
+            ++count_;
+        }
+#else
+        error_ = "perf_event_open is not supported on this platform";
+#endif
+    }
+
+    void close() noexcept {
+#if AIP_HAS_PERF_EVENT
+        for (std::size_t i = count_; i-- > 0;) ::close(fds_[i]);
+#endif
+        fds_ = kClosed;
+        count_ = 0;
+    }
+};
+
+/// Группа счётчиков текущего потока (открывается при первом обращении, закрывается при завершении потока).
+[[nodiscard]] inline const PerfCounterGroup& threadPerfCounters() {
+    thread_local const PerfCounterGroup group;
+    return group;
+}
+
+/**
+ * @brief Сводка счётчиков одной фазы по всем потокам.
+ */
+struct PerfPhaseSummary {
+    std::uint64_t count{0};
+    CounterValues totals{};
+};
+
+struct PerfStats {
+    std::array<PerfPhaseSummary, kPhaseCount> phases{};
+    std::size_t threads{0};
+    /// Сколько потоков не смогли открыть ни одного счётчика.
+    std::size_t unavailableThreads{0};
+    /// Причина недоступности (первая встреченная).
+    std::string error;
+
+    [[nodiscard]] const PerfPhaseSummary& operator[](Phase p) const noexcept {
+        return phases[static_cast<std::size_t>(p)];
+    }
+};
+
+/**
+ * @brief Реестр счётчиков по фазам (устроен как Registry из phase_stats.hpp: поток пишет только свои слоты,
+ *        при завершении потока они переносятся в итог завершившихся, а слот переиспользуется).
+ */
+class PerfRegistry {
+   public:
+    [[nodiscard]] static PerfRegistry& instance() {
+        static PerfRegistry r;
+        return r;
+    }
+
+    /// Фазы, вокруг которых снимаются счётчики (биты Phase). По умолчанию — Chunk и Evaluate: у мелких фаз
+    /// (Decode, Build) два системных вызова на замер сравнимы с самой работой.
+    void setPhaseMask(std::uint32_t mask) noexcept { mask_.store(mask, std::memory_order_relaxed); }
+    [[nodiscard]] bool enabled(Phase p) const noexcept {
+        return mask_.load(std::memory_order_relaxed) & (1u << static_cast<std::size_t>(p));
+    }
+
+    void record(Phase p, const CounterValues& delta) {
+        auto& s = local().slots[static_cast<std::size_t>(p)];
+        bump(s.count, 1);
+        for (std::size_t i = 0; i < kCounterCount; ++i)
+            if (delta.mask & (1u << i)) bump(s.values[i], delta.values[i]);
+        s.mask.store(s.mask.load(std::memory_order_relaxed) | delta.mask, std::memory_order_relaxed);
+    }
+
+    /// Зарегистрировать текущий поток без записи (учитывается в PerfStats::unavailableThreads).
+    void registerThread() { static_cast<void>(local()); }
+
+    [[nodiscard]] PerfStats collect() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PerfStats out = retired_;
+        for (const auto& r : recorders_)
+            if (r->live) accumulate(out, *r);
+        return out;
+    }
+
+    /// Обнулить счётчики. @note Не вызывать, пока идёт инструментированная работа.
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& r : recorders_) clear(*r);
+        retired_ = {};
+    }
+
+    /// Сколько слотов счётчиков выделено (живые потоки + свободные слоты завершившихся).
+    [[nodiscard]] std::size_t slotCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return recorders_.size();
+    }
+
+   private:
+    struct Slot {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint32_t> mask{0};
+        std::array<std::atomic<std::uint64_t>, kCounterCount> values{};
+    };
+
+    struct Recorder {
+        alignas(64) std::array<Slot, kPhaseCount> slots{};
+        bool live{false};  // занят потоком (свободные слоты collect() пропускает)
+        bool available{false};
+        std::string error;
+    };
+
+    /// Владение слотом потока: деструктор thread_local возвращает слот при завершении потока.
+    struct Lease {
+        Recorder* recorder{nullptr};
+
+        Lease() = default;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() {
+            if (recorder) PerfRegistry::instance().release(recorder);
+        }
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Recorder>> recorders_;
+    std::vector<Recorder*> free_;
+    PerfStats retired_;
+    std::atomic<std::uint32_t> mask_{(1u << static_cast<std::size_t>(Phase::Chunk)) |
+                                     (1u << static_cast<std::size_t>(Phase::Evaluate))};
+
+    static void bump(std::atomic<std::uint64_t>& a, std::uint64_t v) noexcept {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    Recorder& local() {
+        thread_local Lease lease;
+        if (!lease.recorder) lease.recorder = acquire(threadPerfCounters());
+        return *lease.recorder;
+    }
+
+    Recorder* acquire(const PerfCounterGroup& group) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Recorder* r = nullptr;
+        if (!free_.empty()) {
+            r = free_.back();
+            free_.pop_back();
+        } else {
+            recorders_.push_back(std::make_unique<Recorder>());
+            free_.reserve(recorders_.size());  // release() при завершении потока не аллоцирует
+            r = recorders_.back().get();
+        }
+        r->live = true;
+        r->available = group.available();
+        r->error = group.error();
+        return r;
+    }
+
+    void release(Recorder* r) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        accumulate(retired_, *r);
+        clear(*r);
+        r->live = false;
+        free_.push_back(r);
+    }
+
+    static void accumulate(PerfStats& out, const Recorder& r) {
+        bool active = false;
+        for (std::size_t p = 0; p < kPhaseCount; ++p) {
+            const auto& s = r.slots[p];
+            auto& d = out.phases[p];
+            const std::uint64_t c = s.count.load(std::memory_order_relaxed);
+            active = active || c > 0;
+            d.count += c;
+            d.totals.mask |= s.mask.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < kCounterCount; ++i)
+                d.totals.values[i] += s.values[i].load(std::memory_order_relaxed);
+        }
+        if (active) ++out.threads;
+        if (!r.available) {
+            ++out.unavailableThreads;
+            if (out.error.empty()) out.error = r.error;
+        }
+    }
+
+    static void clear(Recorder& r) noexcept {
+        for (auto& s : r.slots) {
+            s.count.store(0, std::memory_order_relaxed);
+            s.mask.store(0, std::memory_order_relaxed);
+            for (auto& v : s.values) v.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+[[nodiscard]] inline PerfStats collectPerfStats() { return PerfRegistry::instance().collect(); }
+
+inline void resetPerfStats() { PerfRegistry::instance().reset(); }
+
+/**
+ * @brief RAII-замер счётчиков текущего потока вокруг фазы.
+ *
+ * Если фаза не включена в PerfRegistry::setPhaseMask() или счётчики недоступны, стоит одну проверку.
+ * Значения включают вложенные фазы (как и время в ScopedPhase).
+ */
+class ScopedPerfPhase {
+   public:
+    explicit ScopedPerfPhase(Phase p) : phase_(p) {
+        if (!PerfRegistry::instance().enabled(p)) return;
+        const auto& group = threadPerfCounters();
+        if (!group.available()) {
+            PerfRegistry::instance().registerThread();  // чтобы collect() сообщил о недоступности
+            return;
+        }
+        group_ = &group;
+        start_ = group.read();
+    }
+
+    ScopedPerfPhase(const ScopedPerfPhase&) = delete;
+    ScopedPerfPhase& operator=(const ScopedPerfPhase&) = delete;
+
+    ~ScopedPerfPhase() {
+        if (group_) PerfRegistry::instance().record(phase_, group_->read().since(start_));
+    }
+
+   private:
+    Phase phase_;
+    const PerfCounterGroup* group_{nullptr};
+    CounterValues start_{};
+};
+
+/// Таблица по фазам: вызовы, такты, инструкции, IPC, промахи LLC и переходов на 1000 инструкций.
+inline void printPerfStats(std::ostream& os, const PerfStats& stats) {
+    if (stats.threads == 0 && stats.unavailableThreads > 0) {
+        os << "perf counters unavailable: " << stats.error << '\n';
+        return;
+    }
+    const auto perKilo = [](const CounterValues& v, Counter c) {
+        if (!v.has(c) || !v.has(Counter::Instructions) || v[Counter::Instructions] == 0) return 0.0;
+        return 1000.0 * static_cast<double>(v[c]) / static_cast<double>(v[Counter::Instructions]);
+    };
+
+    os << "phase          calls          cycles    instructions    ipc  llc_mpki  br_mpki  (threads: "
+       << stats.threads << ")\n";
+    const auto flags = os.flags();
+    for (std::size_t p = 0; p < kPhaseCount; ++p) {
+        const auto& s = stats.phases[p];
+        if (s.count == 0) continue;
+        os << std::left << std::setw(9) << phaseName(static_cast<Phase>(p)) << std::right << ' ' << std::setw(10)
+           << s.count << ' ' << std::setw(15) << s.totals[Counter::Cycles] << ' ' << std::setw(15)
+           << s.totals[Counter::Instructions] << ' ' << std::fixed << std::setprecision(2) << std::setw(6)
+           << s.totals.ipc() << ' ' << std::setw(9) << perKilo(s.totals, Counter::LlcMisses) << ' ' << std::setw(8)
+           << perKilo(s.totals, Counter::BranchMisses) << '\n';
+    }
+    os.flags(flags);
+    if (stats.unavailableThreads > 0)
+        os << "(" << stats.unavailableThreads << " thread(s) without counters: " << stats.error << ")\n";
+}
+
+inline void printPerfStats(std::ostream& os) { printPerfStats(os, collectPerfStats()); }
+
+}  // namespace aip::profile
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <string_view>
+
+namespace aip::profile {
+
+/**
+ * @brief Фазы горячего пути поиска.
+ *
+ *  - Decode:   global -> локальные индексы сегментов (decodeLocals, makePiecewise).
+ *  - Build:    сборка моделей по локальным индексам (buildAtLocals/makeAt).
+ *  - Evaluate: вычисление моделей на точках датасета (evalLanes, operator()).
+ *  - Score:    свёртка выходов в оценку (SSE и т.п.).
+ *  - Chunk:    обработка одного чанка параллельного драйвера целиком.
+ */
+enum class Phase : std::size_t { Decode, Build, Evaluate, Score, Chunk };
+
+inline constexpr std::size_t kPhaseCount = 5;
+
+[[nodiscard]] constexpr std::string_view phaseName(Phase p) noexcept {
+    constexpr std::string_view names[kPhaseCount] = {"decode", "build", "evaluate", "score", "chunk"};
+    return names[static_cast<std::size_t>(p)];
+}
+
+/// Инструментирование включено при сборке (макрос AIP_ENABLE_INSTRUMENTATION / CMake-опция).
+#ifdef AIP_ENABLE_INSTRUMENTATION
+inline constexpr bool kInstrumentationEnabled = true;
+#else
+inline constexpr bool kInstrumentationEnabled = false;
+#endif
+
+/// Число log2-корзин гистограммы латентности: корзина b — длительности в [2^(b-1), 2^b) нс.
+inline constexpr std::size_t kHistogramBuckets = 48;
+
+/**
+ * @brief Счётчики одного потока.
+ *
+ * Пишет только поток-владелец (relaxed store без RMW — без конкуренции за кэш-линию),
+ * читает агрегатор — тоже без блокировок.
+ */
+class ThreadRecorder {
+   public:
+    void record(Phase p, std::uint64_t nanos) noexcept {
+        auto& s = slots_[static_cast<std::size_t>(p)];
+        bump(s.count, 1);
+        bump(s.nanos, nanos);
+        const std::size_t b = std::min<std::size_t>(std::bit_width(nanos), kHistogramBuckets - 1);
+        bump(s.histogram[b], 1);
+    }
+
+    /// Аллокация внутри фазы p (вызывается хуками из alloc_tracking.hpp, не должна аллоцировать).
+    void recordAllocation(Phase p, std::uint64_t bytes) noexcept {
+        auto& s = slots_[static_cast<std::size_t>(p)];
+        bump(s.allocations, 1);
+        bump(s.allocatedBytes, bytes);
+    }
+
+   private:
+    friend class Registry;
+
+    struct Slot {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> nanos{0};
+        std::array<std::atomic<std::uint64_t>, kHistogramBuckets> histogram{};
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> allocatedBytes{0};
+    };
+
+    alignas(64) std::array<Slot, kPhaseCount> slots_{};
+
+    static void bump(std::atomic<std::uint64_t>& a, std::uint64_t v) noexcept {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Агрегированная статистика одной фазы.
+ */
+struct PhaseSummary {
+    std::uint64_t count{0};
+    std::uint64_t totalNanos{0};
+    std::array<std::uint64_t, kHistogramBuckets> histogram{};
+    /// Аллокации, сделанные непосредственно в фазе (без вложенных фаз); считаются только с хуками
+    /// AIP_DEFINE_ALLOCATION_HOOKS (alloc_tracking.hpp).
+    std::uint64_t allocations{0};
+    std::uint64_t allocatedBytes{0};
+
+    [[nodiscard]] double meanNanos() const noexcept {
+        return count ? static_cast<double>(totalNanos) / static_cast<double>(count) : 0.0;
+    }
+
+    /// Верхняя граница корзины, в которую попадает квантиль q (0..1), нс. Точность — до 2x.
+    [[nodiscard]] std::uint64_t percentileNanos(double q) const noexcept {
+        if (count == 0) return 0;
+        const auto target = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < kHistogramBuckets; ++b) {
+            seen += histogram[b];
+            if (seen >= target) return b == 0 ? 0 : (std::uint64_t{1} << b) - 1;
+        }
+        return std::uint64_t{1} << (kHistogramBuckets - 1);
+    }
+};
+
+/**
+ * @brief Снимок статистики всех фаз по всем потокам.
+ */
+struct PhaseStats {
+    std::array<PhaseSummary, kPhaseCount> phases{};
+    std::size_t threads{0};
+
+    [[nodiscard]] const PhaseSummary& operator[](Phase p) const noexcept { return phases[static_cast<std::size_t>(p)]; }
+};
+
+namespace detail {
+
+/// Самая внутренняя активная фаза потока (phase < 0 — вне фаз) и счётчики потока.
+struct PhaseContext {
+    ThreadRecorder* recorder{nullptr};
+    int phase{-1};
+};
+
+[[nodiscard]] inline PhaseContext& phaseContext() noexcept {
+    thread_local PhaseContext ctx;
+    return ctx;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Реестр счётчиков потоков (процесс-глобальный).
+ *
+ * Мьютекс берётся только при первой записи потока (регистрация), при его завершении и при collect()/reset().
+ * Когда поток завершается, его счётчики переносятся в общий итог завершившихся потоков, а сам слот
+ * возвращается в реестр и достаётся следующему новому потоку: статистика std::async-задач не теряется,
+ * а память и время collect() ограничены числом одновременно живых потоков.
+ */
+class Registry {
+   public:
+    [[nodiscard]] static Registry& instance() {
+        static Registry r;
+        return r;
+    }
+
+    /// Счётчики текущего потока.
+    [[nodiscard]] ThreadRecorder& local() {
+        thread_local Lease lease;
+        if (!lease.recorder) lease.recorder = acquire();
+        return *lease.recorder;
+    }
+
+    [[nodiscard]] PhaseStats collect() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PhaseStats out;
+        out.phases = retired_;
+        out.threads = retiredThreads_;
+        for (const auto& r : recorders_)
+            if (accumulate(out.phases, *r)) ++out.threads;
+        return out;
+    }
+
+    /// Обнулить счётчики. @note Не вызывать, пока идёт инструментированная работа.
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& r : recorders_) clear(*r);
+        retired_ = {};
+        retiredThreads_ = 0;
+    }
+
+    /// Сколько слотов счётчиков выделено (живые потоки + свободные слоты завершившихся).
+    [[nodiscard]] std::size_t slotCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return recorders_.size();
+    }
+
+   private:
+    /// Владение слотом потока: деструктор thread_local возвращает слот при завершении потока.
+    struct Lease {
+        ThreadRecorder* recorder{nullptr};
+
+        Lease() = default;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() {
+            if (recorder) Registry::instance().release(recorder);
+        }
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadRecorder>> recorders_;
+    std::vector<ThreadRecorder*> free_;
+    std::array<PhaseSummary, kPhaseCount> retired_{};
+    std::size_t retiredThreads_{0};
+
+    ThreadRecorder* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            ThreadRecorder* r = free_.back();
+            free_.pop_back();
+            return r;
+        }
+        recorders_.push_back(std::make_unique<ThreadRecorder>());
+        free_.reserve(recorders_.size());  // release() при завершении потока не аллоцирует
+        return recorders_.back().get();
+    }
+
+    void release(ThreadRecorder* r) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (accumulate(retired_, *r)) ++retiredThreads_;
+        clear(*r);
+        free_.push_back(r);
+    }
+
+    /// Добавить счётчики r к out; true, если поток записал хотя бы одну фазу.
+    static bool accumulate(std::array<PhaseSummary, kPhaseCount>& out, const ThreadRecorder& r) noexcept {
+        bool active = false;
+        for (std::size_t p = 0; p < kPhaseCount; ++p) {
+            const auto& s = r.slots_[p];
+            auto& d = out[p];
+            const std::uint64_t c = s.count.load(std::memory_order_relaxed);
+            active = active || c > 0;
+            d.count += c;
+            d.totalNanos += s.nanos.load(std::memory_order_relaxed);
+            for (std::size_t b = 0; b < kHistogramBuckets; ++b)
+                d.histogram[b] += s.histogram[b].load(std::memory_order_relaxed);
+            d.allocations += s.allocations.load(std::memory_order_relaxed);
+            d.allocatedBytes += s.allocatedBytes.load(std::memory_order_relaxed);
+        }
+        return active;
+    }
+
+    static void clear(ThreadRecorder& r) noexcept {
+        for (auto& s : r.slots_) {
+            s.count.store(0, std::memory_order_relaxed);
+            s.nanos.store(0, std::memory_order_relaxed);
+            for (auto& h : s.histogram) h.store(0, std::memory_order_relaxed);
+            s.allocations.store(0, std::memory_order_relaxed);
+            s.allocatedBytes.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+/// Записать длительность фазы в счётчики текущего потока.
+inline void recordPhase(Phase p, std::uint64_t nanos) { Registry::instance().local().record(p, nanos); }
+
+/// Снимок статистики всех потоков.
+[[nodiscard]] inline PhaseStats collectPhaseStats() { return Registry::instance().collect(); }
+
+inline void resetPhaseStats() { Registry::instance().reset(); }
+
+/**
+ * @brief RAII-таймер фазы: записывает длительность своей жизни и на это время становится
+ *        текущей фазой потока (к ней относятся аллокации, см. alloc_tracking.hpp).
+ *
+ * Обычно используется через AIP_PHASE_SCOPE, который без AIP_ENABLE_INSTRUMENTATION не генерирует кода.
+ */
+class ScopedPhase {
+   public:
+    explicit ScopedPhase(Phase p) : phase_(p), recorder_(&Registry::instance().local()) {
+        auto& ctx = detail::phaseContext();
+        prevPhase_ = ctx.phase;
+        ctx.recorder = recorder_;
+        ctx.phase = static_cast<int>(p);
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    ~ScopedPhase() {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        recorder_->record(phase_, static_cast<std::uint64_t>(ns.count()));
+        detail::phaseContext().phase = prevPhase_;
+    }
+
+   private:
+    Phase phase_;
+    ThreadRecorder* recorder_;
+    int prevPhase_{-1};
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// Таблица по фазам: число вызовов, суммарное и среднее время, p50/p99 по гистограмме
+/// и, если аллокации учитывались, аллокации и байты на вызов.
+inline void printPhaseStats(std::ostream& os, const PhaseStats& stats) {
+    bool allocs = false;
+    for (const auto& s : stats.phases) allocs = allocs || s.allocations > 0;
+
+    os << "phase          calls      total_ms       mean_ns        p50_ns        p99_ns"
+       << (allocs ? "  allocs/call   bytes/call" : "") << "  (threads: " << stats.threads << ")\n";
+    for (std::size_t p = 0; p < kPhaseCount; ++p) {
+        const auto& s = stats.phases[p];
+        if (s.count == 0) continue;
+        os << std::left << std::setw(9) << phaseName(static_cast<Phase>(p)) << std::right << ' ' << std::setw(10)
+           << s.count << ' ' << std::setw(13) << std::fixed << std::setprecision(3)
+           << static_cast<double>(s.totalNanos) / 1e6 << ' ' << std::setw(13) << std::setprecision(1) << s.meanNanos()
+           << ' ' << std::setw(13) << s.percentileNanos(0.5) << ' ' << std::setw(13) << s.percentileNanos(0.99);
+        if (allocs) {
+            const auto calls = static_cast<double>(s.count);
+            os << ' ' << std::setw(12) << std::setprecision(2) << static_cast<double>(s.allocations) / calls << ' '
+               << std::setw(12) << std::setprecision(1) << static_cast<double>(s.allocatedBytes) / calls;
+        }
+        os << '\n';
+    }
+    os.unsetf(std::ios::floatfield);
+}
+
+inline void printPhaseStats(std::ostream& os) { printPhaseStats(os, collectPhaseStats()); }
+
+}  // namespace aip::profile
+
+#define AIP_PHASE_CONCAT_IMPL(a, b) a##b
+#define AIP_PHASE_CONCAT(a, b) AIP_PHASE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Замерить остаток текущей области видимости как фазу aip::profile::Phase::name.
+ *
+ * С AIP_ENABLE_INSTRUMENTATION пишет время фазы, с AIP_ENABLE_PERF_COUNTERS — аппаратные счётчики
+ * (perf_counters.hpp); без обоих раскрывается в пустой оператор — нулевая стоимость.
+ * @note Макросы должны быть определены одинаково во всех единицах трансляции (через CMake-опции),
+ *       иначе inline-функции библиотеки нарушат ODR.
+ */
+#ifdef AIP_ENABLE_INSTRUMENTATION
+#define AIP_PHASE_TIMER_SCOPE(name) \
+    const ::aip::profile::ScopedPhase AIP_PHASE_CONCAT(aip_phase_scope_, __LINE__) { ::aip::profile::Phase::name }
+#else
+#define AIP_PHASE_TIMER_SCOPE(name) static_cast<void>(0)
+#endif
+
+#ifdef AIP_ENABLE_PERF_COUNTERS
+#include <aip/profile/perf_counters.hpp>
+#define AIP_PHASE_PERF_SCOPE(name) \
+    const ::aip::profile::ScopedPerfPhase AIP_PHASE_CONCAT(aip_perf_scope_, __LINE__) { ::aip::profile::Phase::name }
+#else
+#define AIP_PHASE_PERF_SCOPE(name) static_cast<void>(0)
+#endif
+
+#define AIP_PHASE_SCOPE(name) \
+    AIP_PHASE_TIMER_SCOPE(name);  \
+    AIP_PHASE_PERF_SCOPE(name)
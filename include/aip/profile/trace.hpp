@@ -0,0 +1,364 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+
+namespace aip::profile {
+
+/// Трассировка включена при сборке (макрос AIP_ENABLE_TRACING / CMake-опция).
+#ifdef AIP_ENABLE_TRACING
+inline constexpr bool kTracingEnabled = true;
+#else
+inline constexpr bool kTracingEnabled = false;
+#endif
+
+/**
+ * @brief Одно событие-интервал ("complete event" в терминах Chrome trace).
+ *
+ * name/category — строковые литералы (указатели хранятся без копирования, запись не аллоцирует).
+ * arg < 0 — аргумента нет (иначе, например, номер чанка).
+ */
+struct TraceEvent {
+    const char* name{nullptr};
+    const char* category{nullptr};
+    std::uint64_t startNanos{0};
+    std::uint64_t durationNanos{0};
+    std::int64_t arg{-1};
+};
+
+struct TraceOptions {
+    /// Ёмкость кольцевого буфера каждого потока (округляется вверх до степени двойки).
+    std::size_t bufferCapacity{1 << 14};
+    /// Трассировать каждый sampleEvery-й чанк параллельных драйверов (1 — все).
+    std::size_t sampleEvery{1};
+    /// Сколько событий завершившихся потоков хранить до следующего start() (сверх — учитываются в dropped()).
+    std::size_t retiredCapacity{1 << 16};
+};
+
+/**
+ * @brief Кольцевой буфер событий одного потока.
+ *
+ * Пишет только поток-владелец; при переполнении старые события перезаписываются (dropped() считает потери).
+ */
+class TraceBuffer {
+   public:
+    TraceBuffer(std::size_t capacity, std::uint32_t tid) : tid_(tid) { reset(capacity); }
+
+    void push(const TraceEvent& e) noexcept {
+        const std::uint64_t h = head_.load(std::memory_order_relaxed);
+        ring_[h & (ring_.size() - 1)] = e;
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    /// События в порядке записи (не более capacity последних).
+    [[nodiscard]] std::vector<TraceEvent> events() const {
+        const std::uint64_t h = head_.load(std::memory_order_acquire);
+        const std::uint64_t n = std::min<std::uint64_t>(h, ring_.size());
+        std::vector<TraceEvent> out;
+        out.reserve(n);
+        for (std::uint64_t i = h - n; i < h; ++i) out.push_back(ring_[i & (ring_.size() - 1)]);
+        return out;
+    }
+
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        const std::uint64_t h = head_.load(std::memory_order_acquire);
+        return h > ring_.size() ? h - ring_.size() : 0;
+    }
+
+    [[nodiscard]] std::uint32_t tid() const noexcept { return tid_; }
+
+   private:
+    friend class Tracer;
+
+    std::uint32_t tid_;
+    std::vector<TraceEvent> ring_;
+    std::atomic<std::uint64_t> head_{0};
+
+    void reset(std::size_t capacity) {
+        std::size_t cap = 16;
+        while (cap < capacity) cap <<= 1;
+        ring_.assign(cap, TraceEvent{});
+        head_.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Процесс-глобальный трассировщик поиска.
+ *
+ * Пока трассировка не запущена (start()), стоимость точки трассировки — одна relaxed-загрузка флага.
+ * Параллельные драйверы отмечают чанки (TraceChunkScope): события внутри невыбранного чанка
+ * не пишутся, поэтому при sampleEvery = N накладные расходы падают примерно в N раз.
+ *
+ * Результат — JSON в формате Chrome trace events (открывается в Perfetto / chrome://tracing).
+ * Когда поток завершается, его события копируются в общий список (не более retiredCapacity), а буфер
+ * достаётся следующему новому потоку: число буферов ограничено числом одновременно живых потоков.
+ * Номер потока (tid) в трассе у каждого потока свой, даже если буфер переиспользован.
+ * @note start()/stop()/writeChromeTrace() вызывать, когда трассируемая работа не идёт.
+ */
+class Tracer {
+   public:
+    [[nodiscard]] static Tracer& instance() {
+        static Tracer t;
+        return t;
+    }
+
+    /// Очистить буферы и начать запись.
+    void start(const TraceOptions& opt = {}) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = opt;
+        if (options_.sampleEvery == 0) options_.sampleEvery = 1;
+        for (auto& b : buffers_) b->reset(options_.bufferCapacity);
+        retired_.clear();
+        retiredDropped_ = 0;
+        epoch_ = clockNanos();
+        active_.store(true, std::memory_order_release);
+    }
+
+    void stop() noexcept { active_.store(false, std::memory_order_release); }
+
+    [[nodiscard]] bool active() const noexcept { return active_.load(std::memory_order_relaxed); }
+
+    /// Попадает ли чанк с данным номером в выборку.
+    [[nodiscard]] bool sampled(std::size_t chunkIndex) const noexcept {
+        return chunkIndex % options_.sampleEvery == 0;
+    }
+
+    /// Наносекунды от start().
+    [[nodiscard]] std::uint64_t now() const noexcept { return clockNanos() - epoch_; }
+
+    /// Записать событие в буфер текущего потока.
+    void record(const TraceEvent& e) { local().push(e); }
+
+    /// Все события всех потоков: (tid, event), упорядочено по tid и времени начала.
+    [[nodiscard]] std::vector<std::pair<std::uint32_t, TraceEvent>> events() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<std::uint32_t, TraceEvent>> out = retired_;
+        for (const auto& b : buffers_)
+            for (const auto& e : b->events()) out.emplace_back(b->tid(), e);
+        std::stable_sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+            return a.first != b.first ? a.first < b.first : a.second.startNanos < b.second.startNanos;
+        });
+        return out;
+    }
+
+    /// Сколько событий потеряно из-за переполнения кольцевых буферов.
+    [[nodiscard]] std::uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t n = retiredDropped_;
+        for (const auto& b : buffers_) n += b->dropped();
+        return n;
+    }
+
+    /// Сколько буферов выделено (живые потоки + свободные буферы завершившихся).
+    [[nodiscard]] std::size_t bufferCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffers_.size();
+    }
+
+    /// Записать трассу в формате Chrome trace events JSON.
+    void writeChromeTrace(std::ostream& os) const {
+        const auto all = events();
+        std::vector<std::uint32_t> tids;
+        for (const auto& [tid, e] : all)
+            if (tids.empty() || tids.back() != tid) tids.push_back(tid);
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto sep = [&] {
+            os << (first ? "\n" : ",\n");
+            first = false;
+        };
+        for (const auto tid : tids) {
+            sep();
+            os << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid << R"(,"args":{"name":"aip-)" << tid
+               << "\"}}";
+        }
+        const auto flags = os.flags();
+        os << std::fixed << std::setprecision(3);
+        for (const auto& [tid, e] : all) {
+            sep();
+            os << R"({"name":")" << e.name << R"(","cat":")" << e.category << R"(","ph":"X","pid":1,"tid":)" << tid
+               << ",\"ts\":" << static_cast<double>(e.startNanos) / 1e3
+               << ",\"dur\":" << static_cast<double>(e.durationNanos) / 1e3;
+            if (e.arg >= 0) os << ",\"args\":{\"index\":" << e.arg << '}';
+            os << '}';
+        }
+        os.flags(flags);
+        os << "\n]}\n";
+    }
+
+    /// @throws std::runtime_error если файл не удалось записать.
+    void writeChromeTrace(const std::filesystem::path& path) const {
+        std::ofstream out(path);
+        writeChromeTrace(out);
+        if (!out) throw std::runtime_error("Tracer: cannot write " + path.string());
+    }
+
+    /// Состояние текущего потока относительно выборки чанков.
+    enum class ThreadState : std::uint8_t { Free, SampledChunk, SkippedChunk };
+
+    [[nodiscard]] static ThreadState& threadState() noexcept {
+        thread_local ThreadState s = ThreadState::Free;
+        return s;
+    }
+
+   private:
+    /// Владение буфером потока: деструктор thread_local возвращает буфер при завершении потока.
+    struct Lease {
+        TraceBuffer* buffer{nullptr};
+
+        Lease() = default;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() {
+            if (buffer) Tracer::instance().release(buffer);
+        }
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+    std::vector<TraceBuffer*> free_;
+    std::vector<std::pair<std::uint32_t, TraceEvent>> retired_;
+    std::uint64_t retiredDropped_{0};
+    std::uint32_t nextTid_{0};
+    TraceOptions options_{};
+    std::uint64_t epoch_{clockNanos()};
+    std::atomic<bool> active_{false};
+
+    static std::uint64_t clockNanos() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    TraceBuffer& local() {
+        thread_local Lease lease;
+        if (!lease.buffer) lease.buffer = acquire();
+        return *lease.buffer;
+    }
+
+    TraceBuffer* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            TraceBuffer* b = free_.back();
+            free_.pop_back();
+            b->tid_ = nextTid_++;
+            return b;
+        }
+        buffers_.push_back(std::make_unique<TraceBuffer>(options_.bufferCapacity, nextTid_++));
+        free_.reserve(buffers_.size());
+        return buffers_.back().get();
+    }
+
+    void release(TraceBuffer* b) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::uint64_t h = b->head_.load(std::memory_order_acquire);
+        if (h > 0) {
+            const auto events = b->events();
+            const std::size_t room =
+                options_.retiredCapacity > retired_.size() ? options_.retiredCapacity - retired_.size() : 0;
+            const std::size_t kept = std::min(room, events.size());
+            for (std::size_t i = events.size() - kept; i < events.size(); ++i)
+                retired_.emplace_back(b->tid(), events[i]);
+            retiredDropped_ += b->dropped() + (events.size() - kept);
+            b->reset(b->ring_.size());
+        }
+        free_.push_back(b);
+    }
+};
+
+/**
+ * @brief RAII-интервал трассы. Ничего не пишет, если трассировка не запущена или поток внутри
+ *        невыбранного чанка.
+ */
+class TraceScope {
+   public:
+    TraceScope(const char* name, const char* category, std::int64_t arg = -1) noexcept
+        : name_(name), category_(category), arg_(arg) {
+        const auto& t = Tracer::instance();
+        if (t.active() && Tracer::threadState() != Tracer::ThreadState::SkippedChunk) {
+            on_ = true;
+            start_ = t.now();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        if (!on_) return;
+        auto& t = Tracer::instance();
+        t.record(TraceEvent{name_, category_, start_, t.now() - start_, arg_});
+    }
+
+   private:
+    const char* name_;
+    const char* category_;
+    std::int64_t arg_;
+    std::uint64_t start_{0};
+    bool on_{false};
+};
+
+/**
+ * @brief Интервал чанка параллельного драйвера: решает, попадает ли чанк в выборку,
+ *        и на время своей жизни задаёт это решение вложенным TraceScope текущего потока.
+ */
+class TraceChunkScope {
+   public:
+    // span_ создаётся после смены состояния потока: в невыбранном чанке он сам ничего не пишет.
+    explicit TraceChunkScope(std::size_t chunkIndex) noexcept
+        : prev_(enter(chunkIndex)), span_("chunk", "driver", static_cast<std::int64_t>(chunkIndex)) {}
+
+    TraceChunkScope(const TraceChunkScope&) = delete;
+    TraceChunkScope& operator=(const TraceChunkScope&) = delete;
+
+    // span_ пишет событие в своём деструкторе и от состояния потока уже не зависит.
+    ~TraceChunkScope() { Tracer::threadState() = prev_; }
+
+   private:
+    Tracer::ThreadState prev_;
+    TraceScope span_;
+
+    /// Задать состояние потока для чанка; вернуть прежнее.
+    static Tracer::ThreadState enter(std::size_t chunkIndex) noexcept {
+        const Tracer::ThreadState prev = Tracer::threadState();
+        const auto& t = Tracer::instance();
+        if (t.active())
+            Tracer::threadState() =
+                t.sampled(chunkIndex) ? Tracer::ThreadState::SampledChunk : Tracer::ThreadState::SkippedChunk;
+        return prev;
+    }
+};
+
+}  // namespace aip::profile
+
+#define AIP_TRACE_CONCAT_IMPL(a, b) a##b
+#define AIP_TRACE_CONCAT(a, b) AIP_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief AIP_TRACE_SCOPE("name", "category") — интервал трассы до конца области видимости;
+ *        AIP_TRACE_CHUNK(index) — интервал чанка с решением о выборке.
+ *
+ * Без AIP_ENABLE_TRACING раскрываются в пустой оператор.
+ */
+#ifdef AIP_ENABLE_TRACING
+#define AIP_TRACE_SCOPE(name, category) \
+    const ::aip::profile::TraceScope AIP_TRACE_CONCAT(aip_trace_scope_, __LINE__) { name, category }
+#define AIP_TRACE_CHUNK(index) \
+    const ::aip::profile::TraceChunkScope AIP_TRACE_CONCAT(aip_trace_chunk_, __LINE__) { index }
+#else
+#define AIP_TRACE_SCOPE(name, category) static_cast<void>(0)
+#define AIP_TRACE_CHUNK(index) static_cast<void>(0)
+#endif
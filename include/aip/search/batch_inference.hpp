@@ -0,0 +1,91 @@
+#pragma once
+
+#include <span>
+#include <future>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#include <aip/model/imodel.hpp>
+#include <aip/search/parallel_async.hpp>
+
+namespace aip::search {
+
+struct BatchInferenceOptions {
+    /// Точек на чанк: единица работы потока и длина серии, передаваемой в IModel::evaluate (0 — авто).
+    std::size_t chunkSize{1 << 16};
+    /// Точек в блоке потокового режима (evaluateStream). Буферов входа два: следующий блок читается,
+    /// пока считается текущий.
+    std::size_t streamBlock{1 << 22};
+    std::size_t threadCount{std::thread::hardware_concurrency()};
+};
+
+/**
+ * @brief Параллельный пакетный инференс: out[i] = model(xs[i]).
+ *
+ * Массив режется на смежные чанки, которые потоки забирают динамически; каждый чанк целиком уходит
+ * в model.evaluate(), так что PiecewiseModel группирует точки по сегментам внутри чанка,
+ * а модели с векторизованным ядром получают длинные серии. Порядок результатов совпадает со входом.
+ * Для перемешанных входов с доменами-интервалами обычно выгоднее передать сюда aip::model::freeze(pm):
+ * поиск сегмента там не зависит от порядка точек.
+ *
+ * @throws std::invalid_argument если out.size() < xs.size(). Исключение модели пробрасывается после
+ *         завершения остальных чанков.
+ */
+template <typename In, typename Out>
+void evaluateParallel(const model::IModel<In, Out>& model, std::span<const In> xs, std::span<Out> out,
+                      const BatchInferenceOptions& opt = {}) {
+    if (out.size() < xs.size()) throw std::invalid_argument("evaluateParallel: out is too small");
+    detail::runChunked(xs.size(), opt.threadCount, ChunkPolicy::dynamicChunks(opt.chunkSize),
+                       [&](std::size_t, std::size_t begin, std::size_t end) {
+                           model.evaluate(xs.subspan(begin, end - begin), out.subspan(begin, end - begin));
+                       });
+}
+
+/**
+ * @brief Потоковый инференс для входов, не помещающихся в память.
+ *
+ * @tparam Source Callable вида std::size_t(std::span<In> buf): заполнить начало buf, вернуть число
+ *                точек (0 — конец потока). Вызывается из фоновой задачи, но никогда конкурентно с собой.
+ * @tparam Sink   Callable вида void(std::span<const In> xs, std::span<const Out> ys): получает блоки
+ *                по порядку, в вызывающем потоке.
+ *
+ * Каждый блок считается evaluateParallel(); чтение следующего блока перекрывается со счётом и записью
+ * текущего. Память — 2 * streamBlock входов и streamBlock выходов.
+ *
+ * @return Общее число обработанных точек.
+ * @throws std::invalid_argument если opt.streamBlock == 0 или source вернул больше, чем размер буфера.
+ */
+template <typename In, typename Out, typename Source, typename Sink>
+std::size_t evaluateStream(const model::IModel<In, Out>& model, Source&& source, Sink&& sink,
+                           const BatchInferenceOptions& opt = {}) {
+    if (opt.streamBlock == 0) throw std::invalid_argument("evaluateStream: streamBlock must be positive");
+
+    std::vector<In> in[2] = {std::vector<In>(opt.streamBlock), std::vector<In>(opt.streamBlock)};
+    std::vector<Out> out(opt.streamBlock);
+    const auto read = [&](std::vector<In>& buf) {
+        const std::size_t n = source(std::span<In>(buf));
+        if (n > buf.size()) throw std::invalid_argument("evaluateStream: source overfilled the buffer");
+        return n;
+    };
+
+    std::size_t total = 0;
+    std::size_t cur = 0;
+    std::size_t n = read(in[cur]);
+    while (n > 0) {
+        auto next = std::async(std::launch::async, [&, nxt = cur ^ 1] { return read(in[nxt]); });
+
+        const auto xs = std::span<const In>(in[cur]).first(n);
+        const auto ys = std::span<Out>(out).first(n);
+        evaluateParallel(model, xs, ys, opt);
+        sink(xs, std::span<const Out>(ys));
+        total += n;
+
+        n = next.get();
+        cur ^= 1;
+    }
+    return total;
+}
+
+}  // namespace aip::search
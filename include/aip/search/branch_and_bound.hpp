@@ -0,0 +1,225 @@
+#pragma once
+
+#include <span>
+#include <mutex>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+#include <aip/model/imodel.hpp>
+#include <aip/search/score_cache.hpp>
+#include <aip/search/segment_loss.hpp>
+#include <aip/profile/trace.hpp>
+#include <aip/profile/phase_stats.hpp>
+
+namespace aip::search {
+
+struct BranchAndBoundOptions {
+    /// Начальная верхняя граница (известная оценка какого-то решения). По умолчанию — без границы.
+    double initialUpperBound{std::numeric_limits<double>::infinity()};
+
+    /// Число параллельных задач.
+    std::size_t threadCount{std::thread::hardware_concurrency()};
+
+    /// Постоянный кэш потерь сегментов (необязательно): неизменённые сегменты не переоцениваются.
+    ScoreCache* cache{nullptr};
+};
+
+struct BranchAndBoundResult {
+    /// Лучший глобальный индекс (валиден при found).
+    std::size_t global{0};
+
+    /// Его SSE (сумма потерь сегментов).
+    double loss{std::numeric_limits<double>::infinity()};
+
+    /// Найдено ли решение лучше initialUpperBound.
+    bool found{false};
+
+    /// Посещено узлов дерева (частичных назначений).
+    std::size_t nodes{0};
+
+    /// Полностью оценённых кандидатов (листьев).
+    std::size_t leaves{0};
+};
+
+/**
+ * @brief Точный поиск минимума SSE методом ветвей и границ по сегментам оркестратора.
+ *
+ * Потери аддитивны: каждая точка принадлежит первому сегменту, чей домен её содержит, и SSE
+ * piecewise-модели равна сумме SSE сегментов на своих точках (точки вне всех доменов не учитываются).
+ *
+ * 1) Для каждого свободного сегмента заранее считаются потери всех локальных вариантов
+ *    (entrySegmentLosses, пакетно) и сортируются по возрастанию.
+ * 2) Сегменты назначаются по порядку. Граница поддерева = потери уже назначенных сегментов +
+ *    сумма минимальных потерь ещё не назначенных свободных сегментов (для связанных — 0).
+ *    Поддерево, граница которого больше текущего рекорда, отсекается; так как варианты отсортированы,
+ *    остаток цикла по сегменту тоже отбрасывается.
+ * 3) Потери связанного (constrained) сегмента считаются, как только назначены оба его соседа.
+ *
+ * Варианты первого сегмента распределяются между потоками динамически; рекорд общий (атомарный).
+ * При равных потерях выигрывает меньший global — результат не зависит от числа потоков.
+ *
+ * @param orch Оркестратор. Первый и последний сегменты должны быть свободными.
+ *
+ * @throws std::invalid_argument если первый или последний сегмент связанный, или xs/ys разной длины.
+ */
+template <typename Orch>
+[[nodiscard]] BranchAndBoundResult branchAndBound(const Orch& orch, std::span<const typename Orch::input_type> xs,
+                                                  std::span<const typename Orch::output_type> ys,
+                                                  BranchAndBoundOptions opt = {}) {
+    using In = typename Orch::input_type;
+    using Out = typename Orch::output_type;
+    using IMPtr = std::shared_ptr<const aip::model::IModel<In, Out>>;
+
+    BranchAndBoundResult res;
+    const std::size_t K = orch.entryCount();
+    if (K == 0 || orch.size() == 0) return res;
+
+    if (orch[0].isConstrained() || orch[K - 1].isConstrained())
+        throw std::invalid_argument("branchAndBound: the first and the last entries must be free");
+
+    const auto parts = partitionBySegment(orch, xs, ys);
+
+    // --- предрасчёт потерь свободных сегментов ---
+    std::vector<std::vector<double>> losses(K);
+    std::vector<std::vector<std::size_t>> order(K);
+    std::vector<double> restLB(K + 1, 0.0);
+    std::vector<char> constrained(K), needsBuild(K);
+
+    for (std::size_t e = 0; e < K; ++e) constrained[e] = orch[e].isConstrained();
+    for (std::size_t e = 0; e < K; ++e) {
+        needsBuild[e] = (e > 0 && constrained[e - 1]) || (e + 1 < K && constrained[e + 1]);
+
+        order[e].resize(orch[e].size());
+        std::iota(order[e].begin(), order[e].end(), std::size_t{0});
+        if (constrained[e]) continue;
+
+        losses[e] = opt.cache ? cachedSegmentLosses(*opt.cache, orch[e], parts[e])
+                              : entrySegmentLosses(orch[e], parts[e]);
+        std::sort(order[e].begin(), order[e].end(), [&](std::size_t a, std::size_t b) {
+            return losses[e][a] < losses[e][b] || (losses[e][a] == losses[e][b] && a < b);
+        });
+    }
+    for (std::size_t e = K; e-- > 0;) {
+        restLB[e] = restLB[e + 1] + (constrained[e] ? 0.0 : losses[e][order[e].front()]);
+    }
+
+    // --- общий рекорд ---
+    std::atomic<double> incumbent{opt.initialUpperBound};
+    std::mutex bestMutex;
+    std::atomic<std::size_t> nodes{0}, leaves{0};
+
+    auto offer = [&](double loss, std::size_t global) {
+        std::lock_guard<std::mutex> lock(bestMutex);
+        const bool better = loss < res.loss || (loss == res.loss && global < res.global);
+        if (!better || loss > opt.initialUpperBound) return;
+        res.loss = loss;
+        res.global = global;
+        res.found = true;
+        incumbent.store(loss, std::memory_order_relaxed);
+    };
+
+    auto constrainedLoss = [&](std::size_t e, std::size_t local, const std::vector<IMPtr>& built) {
+        const auto m = orch[e].makeAt(local, built, e);
+        if (!m) return std::numeric_limits<double>::infinity();
+        AIP_PHASE_SCOPE(Evaluate);
+        AIP_TRACE_SCOPE("evaluate", "model");
+        double sse = 0.0;
+        for (std::size_t i = 0; i < parts[e].xs.size(); ++i) {
+            const double d = static_cast<double>(parts[e].ys[i]) - static_cast<double>((*m)(parts[e].xs[i]));
+            sse += d * d;
+        }
+        return sse;
+    };
+
+    struct State {
+        std::vector<std::size_t> locals;
+        std::vector<IMPtr> built;
+        std::size_t nodes{0};
+        std::size_t leaves{0};
+    };
+
+    // Рекурсивный обход: назначить сегмент d, partial — потери уже "закрытых" сегментов.
+    auto dfs = [&](auto&& self, State& st, std::size_t d, double partial) -> void {
+        ++st.nodes;
+        if (d == K) {
+            ++st.leaves;
+            offer(partial, orch.encodeLocals(st.locals));
+            return;
+        }
+
+        if (constrained[d]) {
+            // потери станут известны после назначения правого соседа
+            for (const std::size_t local : order[d]) {
+                st.locals[d] = local;
+                self(self, st, d + 1, partial);
+            }
+            return;
+        }
+
+        const bool prevConstrained = d > 0 && constrained[d - 1];
+        for (const std::size_t local : order[d]) {
+            double p = partial + losses[d][local];
+            if (p + restLB[d + 1] > incumbent.load(std::memory_order_relaxed)) {
+                // варианты отсортированы: дальше только хуже (если не примешиваются потери связанного соседа)
+                if (!prevConstrained) break;
+                continue;
+            }
+
+            st.locals[d] = local;
+            if (needsBuild[d]) st.built[d] = orch[d].makeAt(local, st.built, d);
+
+            if (prevConstrained) {
+                p += constrainedLoss(d - 1, st.locals[d - 1], st.built);
+                if (p + restLB[d + 1] > incumbent.load(std::memory_order_relaxed)) continue;
+            }
+            self(self, st, d + 1, p);
+        }
+    };
+
+    // --- параллельный обход: варианты сегмента 0 раздаются динамически ---
+    std::atomic<std::size_t> nextRoot{0};
+    std::size_t threads = opt.threadCount == 0 ? 1 : opt.threadCount;
+    threads = std::min(threads, order[0].size());
+
+    std::vector<std::future<void>> futs;
+    futs.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        futs.push_back(std::async(std::launch::async, [&] {
+            State st;
+            st.locals.assign(K, 0);
+            st.built.assign(K, nullptr);
+
+            for (;;) {
+                const std::size_t i = nextRoot.fetch_add(1, std::memory_order_relaxed);
+                if (i >= order[0].size()) break;
+
+                const std::size_t local = order[0][i];
+                const double p = losses[0][local];
+                if (p + restLB[1] > incumbent.load(std::memory_order_relaxed)) break;
+
+                ++st.nodes;
+                st.locals[0] = local;
+                if (needsBuild[0]) st.built[0] = orch[0].makeAt(local, st.built, 0);
+                dfs(dfs, st, 1, p);
+            }
+
+            nodes.fetch_add(st.nodes, std::memory_order_relaxed);
+            leaves.fetch_add(st.leaves, std::memory_order_relaxed);
+        }));
+    }
+    for (auto& f : futs) f.get();
+
+    res.nodes = nodes.load();
+    res.leaves = leaves.load();
+    return res;
+}
+
+}  // namespace aip::search
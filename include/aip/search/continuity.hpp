@@ -0,0 +1,227 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+
+namespace aip::search {
+
+/**
+ * @brief Отсечение разрывных комбинаций по границам соседних сегментов.
+ *
+ * Для границы между entry i и i+1 задаётся точка x_b и допуск tol: комбинация допустима, только если
+ * |left(x_b) - right(x_b)| <= tol, где left/right — модели соседних сегментов.
+ *
+ * build():
+ *  1) для каждого сегмента у границы вычисляет выход всех локальных вариантов в x_b (пакетно, evalLanes);
+ *  2) сортирует значения слева и справа и соединяет их sort-merge join'ом со скользящим окном
+ *     [v - tol, v + tol] — получаются все совместимые пары (left local, right local) за
+ *     O(n log n + пар);
+ *  3) считает число допустимых комбинаций динамикой по цепочке сегментов.
+ *
+ * После этого forEachFeasible() перебирает только допустимые глобальные индексы — ещё до того,
+ * как хоть одна модель будет оценена на датасете.
+ *
+ * Оба сегмента у объявленной границы должны быть свободными (не constrained).
+ *
+ * @tparam Orch Тип оркестратора (план ссылается на него и должен жить не дольше).
+ */
+template <typename Orch>
+class ContinuityPlan {
+   public:
+    using In = typename Orch::input_type;
+    using Out = typename Orch::output_type;
+
+    explicit ContinuityPlan(const Orch& orch)
+        : orch_(&orch), boundaries_(orch.entryCount() > 0 ? orch.entryCount() - 1 : 0) {}
+
+    /**
+     * @brief Объявить границу между entry @p left и entry left+1.
+     *
+     * @throws std::out_of_range если left + 1 >= entryCount().
+     * @throws std::invalid_argument если один из сегментов связанный или tolerance < 0.
+     */
+    void setBoundary(std::size_t left, In x, double tolerance) {
+        if (left >= boundaries_.size())
+            throw std::out_of_range("ContinuityPlan: no entry to the right of the boundary");
+        if (!(tolerance >= 0.0)) throw std::invalid_argument("ContinuityPlan: tolerance must be >= 0");
+        if ((*orch_)[left].isConstrained() || (*orch_)[left + 1].isConstrained())
+            throw std::invalid_argument("ContinuityPlan: boundary entries must be free");
+
+        boundaries_[left].spec = Spec{x, tolerance};
+        built_ = false;
+    }
+
+    /// @brief Предрасчитать совместимые пары и число допустимых комбинаций.
+    void build() {
+        const std::size_t K = orch_->entryCount();
+        for (std::size_t b = 0; b < boundaries_.size(); ++b) {
+            auto& bd = boundaries_[b];
+            bd.offsets.clear();
+            bd.targets.clear();
+            if (bd.spec) joinBoundary(b);
+        }
+
+        // counts[i][local] — число допустимых продолжений начиная с entry i при данном local
+        counts_.assign(K, {});
+        for (std::size_t i = K; i-- > 0;) {
+            const std::size_t n = (*orch_)[i].size();
+            counts_[i].assign(n, 1.0);
+            if (i + 1 == K) continue;
+
+            const auto& next = counts_[i + 1];
+            const auto& bd = boundaries_[i];
+            const double nextTotal = std::accumulate(next.begin(), next.end(), 0.0);
+            for (std::size_t l = 0; l < n; ++l) {
+                if (!bd.spec) {
+                    counts_[i][l] = nextTotal;
+                    continue;
+                }
+                double c = 0.0;
+                for (std::size_t j = bd.offsets[l]; j < bd.offsets[l + 1]; ++j) c += next[bd.targets[j]];
+                counts_[i][l] = c;
+            }
+        }
+        built_ = true;
+    }
+
+    /**
+     * @brief Число допустимых глобальных комбинаций (после build()).
+     *
+     * Считается в double: для очень больших пространств возможна потеря точности.
+     */
+    [[nodiscard]] double feasibleCount() const {
+        requireBuilt();
+        if (counts_.empty()) return 0.0;
+        return std::accumulate(counts_[0].begin(), counts_[0].end(), 0.0);
+    }
+
+    /// @brief Число совместимых пар на границе left (после build()).
+    [[nodiscard]] std::size_t pairCount(std::size_t left) const {
+        requireBuilt();
+        return boundaries_.at(left).spec ? boundaries_[left].targets.size() : 0;
+    }
+
+    /**
+     * @brief Вызвать fn(global) для каждой допустимой комбинации.
+     *
+     * Порядок обхода — в глубину по цепочке сегментов (entry 0 — внешний цикл), не по возрастанию global.
+     */
+    template <typename Fn>
+    void forEachFeasible(Fn&& fn) const {
+        requireBuilt();
+        const std::size_t K = orch_->entryCount();
+        if (K == 0) return;
+
+        std::vector<std::size_t> locals(K, 0);
+        auto rec = [&](auto&& self, std::size_t i) -> void {
+            if (i == K) {
+                fn(orch_->encodeLocals(locals));
+                return;
+            }
+            auto visit = [&](std::size_t l) {
+                if (counts_[i][l] == 0.0) return;  // тупиковая ветка
+                locals[i] = l;
+                self(self, i + 1);
+            };
+
+            if (i == 0 || !boundaries_[i - 1].spec) {
+                for (std::size_t l = 0; l < counts_[i].size(); ++l) visit(l);
+            } else {
+                const auto& bd = boundaries_[i - 1];
+                const std::size_t prev = locals[i - 1];
+                for (std::size_t j = bd.offsets[prev]; j < bd.offsets[prev + 1]; ++j) visit(bd.targets[j]);
+            }
+        };
+        rec(rec, 0);
+    }
+
+    /// @brief Все допустимые глобальные индексы, по возрастанию.
+    [[nodiscard]] std::vector<std::size_t> feasibleGlobals() const {
+        std::vector<std::size_t> out;
+        forEachFeasible([&](std::size_t g) { out.push_back(g); });
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+   private:
+    struct Spec {
+        In x;
+        double tol;
+    };
+
+    struct Boundary {
+        std::optional<Spec> spec;
+        // CSR: совместимые правые locals для левого local l — targets[offsets[l] .. offsets[l+1])
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> targets;
+    };
+
+    const Orch* orch_;
+    std::vector<Boundary> boundaries_;
+    std::vector<std::vector<double>> counts_;
+    bool built_{false};
+
+    void requireBuilt() const {
+        if (!built_) throw std::logic_error("ContinuityPlan: build() must be called first");
+    }
+
+    /// Выходы всех локальных вариантов entry в точке x.
+    std::vector<double> outputsAt(std::size_t e, const In& x) const {
+        const auto& entry = (*orch_)[e];
+        const std::size_t W = entry.laneWidth();
+        std::vector<double> vals(entry.size());
+        std::vector<Out> out(W);
+        const In xs[1] = {x};
+        for (std::size_t begin = 0; begin < entry.size(); begin += W) {
+            const std::size_t count = entry.evalLanes(begin, std::span<const In>(xs, 1), std::span<Out>(out));
+            for (std::size_t l = 0; l < count; ++l) vals[begin + l] = static_cast<double>(out[l]);
+        }
+        return vals;
+    }
+
+    static std::vector<std::size_t> sortedByValue(const std::vector<double>& v) {
+        std::vector<std::size_t> idx;
+        idx.reserve(v.size());
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            if (!std::isnan(v[i])) idx.push_back(i);  // NaN ни с чем не совместим
+        }
+        std::sort(idx.begin(), idx.end(),
+                  [&](std::size_t a, std::size_t b) { return v[a] < v[b] || (v[a] == v[b] && a < b); });
+        return idx;
+    }
+
+    void joinBoundary(std::size_t b) {
+        auto& bd = boundaries_[b];
+        const auto leftVals = outputsAt(b, bd.spec->x);
+        const auto rightVals = outputsAt(b + 1, bd.spec->x);
+        const double tol = bd.spec->tol;
+
+        const auto L = sortedByValue(leftVals);
+        const auto R = sortedByValue(rightVals);
+
+        // sort-merge join со скользящим окном [v - tol, v + tol]
+        std::vector<std::vector<std::size_t>> adj(leftVals.size());
+        std::size_t lo = 0, hi = 0;
+        for (const std::size_t l : L) {
+            const double v = leftVals[l];
+            while (lo < R.size() && rightVals[R[lo]] < v - tol) ++lo;
+            if (hi < lo) hi = lo;
+            while (hi < R.size() && rightVals[R[hi]] <= v + tol) ++hi;
+            adj[l].assign(R.begin() + static_cast<std::ptrdiff_t>(lo), R.begin() + static_cast<std::ptrdiff_t>(hi));
+            std::sort(adj[l].begin(), adj[l].end());
+        }
+
+        bd.offsets.assign(leftVals.size() + 1, 0);
+        for (std::size_t l = 0; l < adj.size(); ++l) bd.offsets[l + 1] = bd.offsets[l] + adj[l].size();
+        bd.targets.reserve(bd.offsets.back());
+        for (const auto& a : adj) bd.targets.insert(bd.targets.end(), a.begin(), a.end());
+    }
+};
+
+}  // namespace aip::search
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <span>
 #include <array>
 #include <cstddef>
+#include <algorithm>
 #include <optional>
 
 #include <aip/search/index_space.hpp>
@@ -67,6 +69,69 @@ public:
         return std::nullopt;
     }
 
+    /**
+     * @brief Пакетный next(): заполнить out следующими комбинациями.
+     *
+     * Пока не нужен перенос, меняется только младший разряд — без проверок старших.
+     *
+     * @return Число записанных комбинаций (меньше out.size() только в конце перебора).
+     */
+    [[nodiscard]] std::size_t nextBatch(std::span<index_type> out) noexcept {
+        if (!space || finished) return 0;
+
+        std::size_t n = 0;
+        if (first && n < out.size()) {
+            first = false;
+            out[n++] = current;
+        }
+        while (n < out.size()) {
+            if constexpr (N > 0) {
+                const std::size_t base = space->bases[0];
+                if (current[0] + 1 < base) {
+                    const std::size_t run = std::min(out.size() - n, base - 1 - current[0]);
+                    for (std::size_t r = 0; r < run; ++r) {
+                        ++current[0];
+                        out[n++] = current;
+                    }
+                    continue;
+                }
+            }
+            // перенос в старшие разряды (или конец перебора)
+            const auto v = next();
+            if (!v) break;
+            out[n++] = *v;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Пропустить n комбинаций за O(N): следующий next() вернёт комбинацию на n позже.
+     */
+    void skip(std::size_t n) noexcept {
+        if (!space || finished || n == 0) return;
+
+        // локальный индекс комбинации, которую вернул бы next()
+        std::size_t pending = 0;
+        std::size_t mul = 1;
+        for (std::size_t i = 0; i < N; ++i) {
+            pending += current[i] * mul;
+            mul *= space->bases[i];
+        }
+        if (!first) ++pending;
+
+        if (pending >= space->total || n >= space->total - pending) {
+            finished = true;
+            return;
+        }
+
+        pending += n;
+        for (std::size_t i = 0; i < N; ++i) {
+            current[i] = pending % space->bases[i];
+            pending /= space->bases[i];
+        }
+        first = true;
+    }
+
 private:
     const IndexSpace<N>* space{nullptr};
     index_type current{};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <array>
 #include <concepts>
 #include <cstddef>
@@ -40,4 +41,31 @@ concept IndexStrategy =
         { s.next() } -> std::same_as<std::optional<typename S::index_type>>;
     };
 
+/**
+ * @brief Стратегия с перемоткой: skip(n) пропускает n комбинаций (как n вызовов next()),
+ *        но без их генерации.
+ *
+ * Такая стратегия должна выдавать каждую комбинацию пространства ровно один раз
+ * (перестановка [0, total)) и детерминированно после reset(). Тогда оркестратор может
+ * разрезать поток на независимые части (Orchestrator::split) без прохода по префиксу.
+ *
+ * Стратегии без skip() тоже режутся, но каждая часть проматывает свой префикс вызовами next().
+ */
+template <class S, std::size_t N>
+concept SkippableStrategy = IndexStrategy<S, N> && requires(S s, std::size_t n) {
+    { s.skip(n) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Стратегия с пакетной выдачей: nextBatch(out) пишет в out следующие комбинации
+ *        (как подряд идущие вызовы next()) и возвращает их число; 0 — перебор завершён.
+ *
+ * Меньше out.size() возвращается только в конце перебора. Оркестратор и сегменты берут индексы
+ * блоками, амортизируя стоимость вызова на комбинацию.
+ */
+template <class S, std::size_t N>
+concept BatchStrategy = IndexStrategy<S, N> && requires(S s, std::span<typename S::index_type> out) {
+    { s.nextBatch(out) } -> std::same_as<std::size_t>;
+};
+
 } // namespace aip::search
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include <aip/search/top_k.hpp>
+#include <aip/profile/trace.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Параметры одной задачи поиска для JobScheduler.
+ */
+struct JobOptions {
+    /// Сколько лучших кандидатов вернуть.
+    std::size_t topK{1};
+
+    /// Вес задачи при распределении чанков (>= 1). Задача с priority=2 получает вдвое больше чанков, чем с 1.
+    unsigned priority{1};
+
+    /// Размер чанка (число global на одну выдачу потоку). 0 — выбрать автоматически.
+    std::size_t chunkSize{0};
+};
+
+/**
+ * @brief Планировщик множества независимых задач поиска на общем пуле потоков.
+ *
+ * Каждая задача — диапазон глобальных индексов [begin, end) и scorer вида Score(std::size_t global)
+ * (обычно — makePiecewise(global) + оценка на данных). Диапазоны задач режутся на чанки, а потоки пула
+ * берут чанки разных задач вперемешку по stride-планированию: у задачи с наименьшим "pass" забирается
+ * следующий чанк, после чего её pass увеличивается на stride = kStrideBase / priority.
+ * Так тысячи маленьких задач не простаивают друг за другом и не переподписывают ядра.
+ *
+ * У каждой задачи свой TopK и свой std::future с результатом (лучшие кандидаты, от лучшего к худшему).
+ * Исключение из scorer завершает только свою задачу: оно пробрасывается через её future.
+ *
+ * Деструктор дожидается выполнения всех уже поставленных задач.
+ *
+ * @tparam Score  Тип оценки.
+ * @tparam Better Порядок "лучше" для TopK (по умолчанию меньшая оценка лучше).
+ */
+template <typename Score = double, typename Better = std::less<Score>>
+class JobScheduler {
+   public:
+    using TopKType = TopK<Score, Better>;
+    using Result = std::vector<Scored<Score>>;
+
+    explicit JobScheduler(std::size_t threadCount = std::thread::hardware_concurrency()) {
+        if (threadCount == 0) threadCount = 1;
+        workers_.reserve(threadCount);
+        for (std::size_t t = 0; t < threadCount; ++t) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    ~JobScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    [[nodiscard]] std::size_t threadCount() const noexcept { return workers_.size(); }
+
+    /// @brief Число задач, которые ещё не завершены.
+    [[nodiscard]] std::size_t pendingJobs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return active_.size() + running_;
+    }
+
+    /**
+     * @brief Поставить задачу поиска в очередь.
+     *
+     * @param begin  Начальный глобальный индекс (включительно).
+     * @param end    Конечный глобальный индекс (исключая).
+     * @param scorer Callable вида Score(std::size_t global). Должен быть потокобезопасным.
+     * @param opt    Параметры задачи.
+     * @return future с лучшими кандидатами задачи.
+     */
+    template <typename Scorer>
+    [[nodiscard]] std::future<Result> submit(std::size_t begin, std::size_t end, Scorer scorer, JobOptions opt = {}) {
+        auto job = std::make_shared<Job>();
+        job->next = begin;
+        job->end = std::max(begin, end);
+        job->top = TopKType(opt.topK);
+        job->stride = kStrideBase / std::max(1u, opt.priority);
+        job->chunk = opt.chunkSize > 0 ? opt.chunkSize : autoChunk(job->end - job->next);
+        job->run = [scorer = std::move(scorer)](std::size_t b, std::size_t e, TopKType& top) {
+            for (std::size_t g = b; g < e; ++g) top.push(g, scorer(g));
+        };
+
+        auto fut = job->promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (job->next == job->end) {
+                job->promise.set_value(Result{});
+                return fut;
+            }
+            // новая задача стартует с текущего "виртуального времени", чтобы не вытеснять старые
+            job->pass = virtualTime_;
+            active_.push_back(std::move(job));
+        }
+        cv_.notify_all();
+        return fut;
+    }
+
+   private:
+    static constexpr std::size_t kStrideBase = std::size_t{1} << 20;
+
+    struct Job {
+        std::size_t next{0};
+        std::size_t end{0};
+        std::size_t chunk{1};
+        std::size_t pass{0};
+        std::size_t stride{kStrideBase};
+        std::size_t inFlight{0};
+
+        std::function<void(std::size_t, std::size_t, TopKType&)> run;
+
+        std::mutex topMutex;
+        TopKType top;
+        std::exception_ptr error;
+        std::promise<Result> promise;
+    };
+
+    struct Ticket {
+        std::shared_ptr<Job> job;
+        std::size_t begin{0};
+        std::size_t end{0};
+    };
+
+    std::size_t autoChunk(std::size_t total) const noexcept {
+        // несколько чанков на поток — для чередования задач, но не слишком мелко
+        const std::size_t perThread = total / (workers_.size() * 4 + 1);
+        return std::clamp<std::size_t>(perThread, 16, 4096);
+    }
+
+    /// Выбрать задачу с минимальным pass и выдать её следующий чанк. Вызывается под mutex_.
+    bool pickLocked(Ticket& out) {
+        if (active_.empty()) return false;
+
+        auto best = active_.begin();
+        for (auto it = active_.begin(); it != active_.end(); ++it) {
+            if ((*it)->pass < (*best)->pass) best = it;
+        }
+
+        Job& j = **best;
+        out.job = *best;
+        out.begin = j.next;
+        out.end = std::min(j.end, j.next + j.chunk);
+        j.next = out.end;
+        virtualTime_ = j.pass;
+        j.pass += j.stride;
+        ++j.inFlight;
+
+        if (j.next >= j.end) {
+            // все чанки розданы: задача уходит из очереди, но ещё "выполняется"
+            ++running_;
+            active_.erase(best);
+        }
+        return true;
+    }
+
+    void finishChunk(Ticket& t, TopKType& local, std::exception_ptr err) {
+        Job& j = *t.job;
+        {
+            std::lock_guard<std::mutex> lock(j.topMutex);
+            if (err && !j.error) j.error = err;
+            if (!err) j.top.merge(local);
+        }
+
+        bool completed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --j.inFlight;
+            if (j.inFlight == 0 && j.next >= j.end) {
+                completed = true;
+                --running_;
+            }
+        }
+
+        if (completed) {
+            if (j.error) {
+                j.promise.set_exception(j.error);
+            } else {
+                j.promise.set_value(j.top.sorted());
+            }
+        }
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Ticket t;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [&] { return stopping_ || !active_.empty(); });
+                // пусто только при остановке: все поставленные задачи уже розданы
+                if (!pickLocked(t)) return;
+            }
+
+            TopKType local(t.job->top.capacity());
+            std::exception_ptr err;
+
+            bool failed = false;
+            {
+                std::lock_guard<std::mutex> lock(t.job->topMutex);
+                failed = static_cast<bool>(t.job->error);
+            }
+            if (!failed) {
+                try {
+                    AIP_TRACE_CHUNK(t.begin / t.job->chunk);
+                    t.job->run(t.begin, t.end, local);
+                } catch (...) {
+                    err = std::current_exception();
+                }
+            }
+
+            finishChunk(t, local, err);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Job>> active_;
+    std::size_t running_{0};
+    std::size_t virtualTime_{0};
+    bool stopping_{false};
+
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace aip::search
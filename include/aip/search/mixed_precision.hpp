@@ -0,0 +1,174 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <thread>
+#include <cstddef>
+#include <algorithm>
+
+#include <aip/search/top_k.hpp>
+#include <aip/search/parallel_async.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Параметры двухфазного поиска (грубый float-проход + точная переоценка).
+ *
+ * Предполагается модель погрешности грубой оценки:
+ *   |coarse(g) - exact(g)| <= relTolerance * |exact(g)| + absTolerance.
+ * При её выполнении итоговый top-K совпадает с полным поиском в точной арифметике.
+ */
+struct ScreeningOptions {
+    /// Сколько лучших кандидатов вернуть.
+    std::size_t topK{1};
+
+    /// Сколько кандидатов (в разах от topK) пропускать во вторую фазу как минимум.
+    std::size_t oversample{4};
+
+    /// Относительная погрешность грубой оценки.
+    double relTolerance{1e-4};
+
+    /// Абсолютная погрешность грубой оценки.
+    double absTolerance{0.0};
+
+    /// Число параллельных задач.
+    std::size_t threadCount{std::thread::hardware_concurrency()};
+};
+
+/**
+ * @brief Результат двухфазного поиска.
+ */
+struct ScreeningResult {
+    /// Лучшие кандидаты по точной оценке, от лучшего к худшему.
+    std::vector<Scored<double>> best;
+
+    /// Сколько кандидатов оценено грубо (включая повторный проход, если он понадобился).
+    std::size_t screened{0};
+
+    /// Сколько кандидатов переоценено точно.
+    std::size_t rescored{0};
+
+    /// Понадобился ли повторный грубый проход по порогу (первого запаса не хватило для гарантии).
+    bool widened{false};
+};
+
+/**
+ * @brief Сумма квадратов отклонений в float (грубая оценка).
+ *
+ * Простой цикл без зависимостей между итерациями: компилятор векторизует его
+ * с вдвое большим числом дорожек, чем для double.
+ */
+[[nodiscard]] inline float sumSquaredErrors(std::span<const float> pred, std::span<const float> obs) noexcept {
+    const std::size_t n = std::min(pred.size(), obs.size());
+    float acc = 0.0f;
+    for (std::size_t i = 0; i < n; ++i) {
+        const float d = obs[i] - pred[i];
+        acc += d * d;
+    }
+    return acc;
+}
+
+/**
+ * @brief Двухфазный поиск минимума: грубый отбор + точная переоценка выживших.
+ *
+ * Фаза 1: все global из [begin, end) оцениваются coarse(global) (обычно float-ядро) и остаётся
+ *         topK * oversample лучших.
+ * Фаза 2: выжившие переоцениваются exact(global) в родной точности модели.
+ *
+ * Затем проверяется гарантия: любой отсеянный кандидат имеет coarse не лучше худшего выжившего,
+ * значит его точная оценка не меньше (worstCoarse - abs) / (1 + rel). Если эта граница строго хуже
+ * K-го точного результата, ответ доказанно совпадает с полным поиском. Иначе выполняется
+ * повторный грубый проход, отбирающий всех кандидатов ниже порога, и они переоцениваются точно.
+ *
+ * Меньшая оценка лучше (функция потерь, неотрицательная). NaN-оценки отбрасываются.
+ *
+ * @tparam Coarse Callable вида float(std::size_t global) (или любой арифметический тип).
+ * @tparam Exact  Callable вида double(std::size_t global).
+ */
+template <typename Coarse, typename Exact>
+[[nodiscard]] ScreeningResult screenAndRescore(std::size_t begin, std::size_t end, Coarse&& coarse, Exact&& exact,
+                                               ScreeningOptions opt = {}) {
+    ScreeningResult res;
+    if (end <= begin || opt.topK == 0) return res;
+
+    const std::size_t keep = std::max(opt.topK, opt.topK * std::max<std::size_t>(1, opt.oversample));
+
+    // --- Фаза 1: грубый отбор ---
+    auto chunkTops = parallelForChunksAsync(
+        begin, end,
+        [&](std::size_t b, std::size_t e) {
+            TopK<double> top(keep);
+            for (std::size_t g = b; g < e; ++g) top.push(g, static_cast<double>(coarse(g)));
+            return top;
+        },
+        opt.threadCount);
+
+    TopK<double> survivors(keep);
+    for (const auto& t : chunkTops) survivors.merge(t);
+    res.screened = end - begin;
+
+    auto rescore = [&](const std::vector<Scored<double>>& cands, TopK<double>& out) {
+        const auto exactScores = parallelForIndicesAsync(
+            0, cands.size(), [&](std::size_t i) { return static_cast<double>(exact(cands[i].global)); },
+            opt.threadCount);
+        for (std::size_t i = 0; i < cands.size(); ++i) out.push(cands[i].global, exactScores[i]);
+        res.rescored += cands.size();
+    };
+
+    // --- Фаза 2: точная переоценка ---
+    const auto phase1 = survivors.sorted();
+    TopK<double> best(opt.topK);
+    rescore(phase1, best);
+
+    // Если отсеяно ничего не было — ответ точный.
+    if (phase1.size() < keep || phase1.size() == end - begin) {
+        res.best = best.sorted();
+        return res;
+    }
+
+    const double worstCoarse = survivors.worst().score;
+    const double droppedLowerBound = (worstCoarse - opt.absTolerance) / (1.0 + opt.relTolerance);
+
+    // Строго лучше: отсеянный с точной оценкой, равной K-й, но меньшим global выиграл бы tie-break.
+    if (best.full() && droppedLowerBound > best.worst().score) {
+        res.best = best.sorted();
+        return res;
+    }
+
+    // --- Расширение: все кандидаты, чья точная оценка может оказаться лучше текущего K-го ---
+    res.widened = true;
+    const double kth = best.full() ? best.worst().score : std::numeric_limits<double>::infinity();
+    const double threshold = kth * (1.0 + opt.relTolerance) + opt.absTolerance;
+
+    // уже переоценённые кандидаты (при равном coarse == worstCoarse часть могла не попасть в phase1)
+    std::vector<std::size_t> done;
+    done.reserve(phase1.size());
+    for (const auto& v : phase1) done.push_back(v.global);
+    std::sort(done.begin(), done.end());
+
+    auto chunkExtra = parallelForChunksAsync(
+        begin, end,
+        [&](std::size_t b, std::size_t e) {
+            std::vector<Scored<double>> extra;
+            for (std::size_t g = b; g < e; ++g) {
+                const double c = static_cast<double>(coarse(g));
+                if (!(c >= worstCoarse && c <= threshold)) continue;
+                if (std::binary_search(done.begin(), done.end(), g)) continue;
+                extra.push_back({g, c});
+            }
+            return extra;
+        },
+        opt.threadCount);
+    res.screened += end - begin;
+
+    std::vector<Scored<double>> extra;
+    for (auto& v : chunkExtra) extra.insert(extra.end(), v.begin(), v.end());
+    rescore(extra, best);
+
+    res.best = best.sorted();
+    return res;
+}
+
+}  // namespace aip::search
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <span>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+#include <aip/search/top_k.hpp>
+#include <aip/search/parallel_async.hpp>
+#include <aip/profile/trace.hpp>
+#include <aip/profile/phase_stats.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Матрица наблюдений: D рядов (датасетов) на общих входах x.
+ *
+ * Хранится построчно (point-major): для каждой точки i значения всех D датасетов лежат подряд.
+ * Поэтому внутренний цикл оценки "одно предсказание против D наблюдений" идёт по непрерывной памяти
+ * и векторизуется компилятором.
+ *
+ * @tparam Out Тип наблюдения (совпадает с Out модели).
+ */
+template <typename Out>
+class ObservationMatrix {
+   public:
+    ObservationMatrix() = default;
+
+    ObservationMatrix(std::size_t points, std::size_t datasets)
+        : points_(points), datasets_(datasets), data_(points * datasets) {}
+
+    [[nodiscard]] std::size_t points() const noexcept { return points_; }
+    [[nodiscard]] std::size_t datasets() const noexcept { return datasets_; }
+
+    [[nodiscard]] Out& operator()(std::size_t point, std::size_t dataset) noexcept {
+        return data_[point * datasets_ + dataset];
+    }
+    [[nodiscard]] const Out& operator()(std::size_t point, std::size_t dataset) const noexcept {
+        return data_[point * datasets_ + dataset];
+    }
+
+    /// @brief Значения всех датасетов в точке @p point.
+    [[nodiscard]] std::span<const Out> row(std::size_t point) const noexcept {
+        return {data_.data() + point * datasets_, datasets_};
+    }
+
+    /**
+     * @brief Заполнить датасет @p dataset значениями ys (по одному на точку).
+     * @throws std::invalid_argument если размер ys не равен points().
+     */
+    void setColumn(std::size_t dataset, std::span<const Out> ys) {
+        if (ys.size() != points_) throw std::invalid_argument("ObservationMatrix: column size mismatch");
+        for (std::size_t i = 0; i < points_; ++i) data_[i * datasets_ + dataset] = ys[i];
+    }
+
+   private:
+    std::size_t points_{0};
+    std::size_t datasets_{0};
+    std::vector<Out> data_;
+};
+
+struct MultiDatasetOptions {
+    /// Сколько лучших кандидатов хранить для каждого датасета.
+    std::size_t topK{1};
+
+    /// Число параллельных задач.
+    std::size_t threadCount{std::thread::hardware_concurrency()};
+};
+
+/**
+ * @brief Подобрать одну конфигурацию оркестратора сразу к D датасетам на общих x.
+ *
+ * Каждый кандидат (global) строится один раз, его предсказания в точках xs считаются один раз,
+ * а затем сумма квадратов отклонений (SSE) накапливается сразу для всех D столбцов наблюдений.
+ * Для каждого датасета ведётся свой TopK (меньшая SSE лучше).
+ *
+ * Точки, где piecewise-модель не определена (NaN, нет подходящего домена), дают NaN-оценку,
+ * и такой кандидат для этого датасета отбрасывается.
+ *
+ * @param orch Оркестратор (используется только stateless makePiecewise).
+ * @param xs   Общие входы, xs.size() == obs.points().
+ * @param obs  Наблюдения: obs(i, d) — значение датасета d в точке xs[i].
+ * @param opt  Параметры поиска.
+ * @return Для каждого датасета — лучшие кандидаты от лучшего к худшему.
+ *
+ * @throws std::invalid_argument если xs.size() != obs.points().
+ */
+template <typename Orch>
+[[nodiscard]] std::vector<std::vector<Scored<double>>> searchMultiDataset(
+    const Orch& orch, std::span<const typename Orch::input_type> xs,
+    const ObservationMatrix<typename Orch::output_type>& obs, MultiDatasetOptions opt = {}) {
+    using Out = typename Orch::output_type;
+
+    if (xs.size() != obs.points()) throw std::invalid_argument("searchMultiDataset: xs and observations differ");
+
+    const std::size_t D = obs.datasets();
+    const std::size_t n = xs.size();
+
+    auto chunkResults = parallelForChunksAsync(
+        0, orch.size(),
+        [&](std::size_t begin, std::size_t end) {
+            std::vector<TopK<double>> tops(D, TopK<double>(opt.topK));
+            std::vector<Out> preds(n);
+            std::vector<double> sse(D);
+
+            for (std::size_t g = begin; g < end; ++g) {
+                const auto pm = orch.makePiecewise(g);
+                {
+                    AIP_PHASE_SCOPE(Evaluate);
+                    AIP_TRACE_SCOPE("evaluate", "model");
+                    for (std::size_t i = 0; i < n; ++i) preds[i] = pm(xs[i]);
+                }
+
+                AIP_PHASE_SCOPE(Score);
+                AIP_TRACE_SCOPE("score", "model");
+                std::fill(sse.begin(), sse.end(), 0.0);
+                double* acc = sse.data();
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double p = static_cast<double>(preds[i]);
+                    const Out* y = obs.row(i).data();
+                    // по датасетам — непрерывная память, векторизуется
+                    for (std::size_t d = 0; d < D; ++d) {
+                        const double diff = static_cast<double>(y[d]) - p;
+                        acc[d] += diff * diff;
+                    }
+                }
+
+                for (std::size_t d = 0; d < D; ++d) tops[d].push(g, sse[d]);
+            }
+            return tops;
+        },
+        opt.threadCount);
+
+    std::vector<std::vector<Scored<double>>> out(D);
+    for (std::size_t d = 0; d < D; ++d) {
+        TopK<double> merged(opt.topK);
+        for (const auto& tops : chunkResults) merged.merge(tops[d]);
+        out[d] = merged.sorted();
+    }
+    return out;
+}
+
+}  // namespace aip::search
@@ -3,14 +3,135 @@
 #include <atomic>
 #include <cstddef>
 #include <future>
+#include <optional>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 #include <algorithm>
 
+#include <aip/profile/trace.hpp>
+#include <aip/profile/phase_stats.hpp>
+
 namespace aip::search {
 
+/**
+ * @brief Политика разбиения диапазона на чанки для параллельных драйверов.
+ *
+ *  - Static:  чанки раздаются потокам заранее по кругу (поток t берёт чанки t, t + T, ...).
+ *             Минимум синхронизации; хорошо при равной стоимости индексов.
+ *  - Dynamic: потоки забирают следующий чанк из общего атомарного счётчика.
+ *             Выравнивает нагрузку, когда стоимость индексов сильно различается.
+ *
+ * chunkSize == 0 — автоматически: для Static один чанк на поток, для Dynamic ~8 чанков на поток.
+ */
+struct ChunkPolicy {
+    enum class Kind { Static, Dynamic };
+
+    Kind kind{Kind::Static};
+    std::size_t chunkSize{0};
+
+    [[nodiscard]] static constexpr ChunkPolicy staticChunks(std::size_t size = 0) noexcept {
+        return {Kind::Static, size};
+    }
+    [[nodiscard]] static constexpr ChunkPolicy dynamicChunks(std::size_t size = 0) noexcept {
+        return {Kind::Dynamic, size};
+    }
+};
+
+namespace detail {
+
+/// Фактический размер чанка для total индексов и threads потоков.
+[[nodiscard]] constexpr std::size_t resolveChunkSize(std::size_t total, std::size_t threads,
+                                                     const ChunkPolicy& policy) noexcept {
+    if (policy.chunkSize > 0) return policy.chunkSize;
+    const std::size_t parts = policy.kind == ChunkPolicy::Kind::Static ? threads : threads * 8;
+    return std::max<std::size_t>(1, (total + parts - 1) / parts);
+}
+
+/**
+ * @brief Выполнить fn(chunkIndex, offBegin, offEnd) для всех чанков [0, total) согласно policy.
+ *
+ * Создаёт min(threads, chunkCount) async-задач. Исключение из fn пробрасывается после завершения всех задач
+ * (оставшиеся чанки упавшего потока не выполняются).
+ */
+template <typename Fn>
+void runChunked(std::size_t total, std::size_t threads, const ChunkPolicy& policy, Fn&& fn) {
+    if (total == 0) return;
+    if (threads == 0) threads = 1;
+
+    const std::size_t chunk = resolveChunkSize(total, threads, policy);
+    const std::size_t chunkCount = (total + chunk - 1) / chunk;
+    threads = std::min(threads, chunkCount);
+
+    std::atomic<std::size_t> nextChunk{0};
+    auto runOne = [&](std::size_t c) {
+        AIP_PHASE_SCOPE(Chunk);
+        AIP_TRACE_CHUNK(c);
+        fn(c, c * chunk, std::min(total, (c + 1) * chunk));
+    };
+
+    std::vector<std::future<void>> futs;
+    futs.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        futs.push_back(std::async(std::launch::async, [&, t]() {
+            if (policy.kind == ChunkPolicy::Kind::Static) {
+                for (std::size_t c = t; c < chunkCount; c += threads) runOne(c);
+            } else {
+                for (;;) {
+                    const std::size_t c = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                    if (c >= chunkCount) break;
+                    runOne(c);
+                }
+            }
+        }));
+    }
+
+    for (auto& f : futs) f.wait();
+    for (auto& f : futs) f.get();
+}
+
+}  // namespace detail
+
+/**
+ * @brief Параллельно обработать диапазон индексов [begin, end) чанками согласно ChunkPolicy.
+ *
+ * @tparam Worker      Callable вида Result(std::size_t global).
+ * @tparam OnProgress  Callable вида void(std::size_t done, std::size_t total).
+ *
+ * @return std::vector<Result> размера (end-begin), в исходном порядке по global.
+ *
+ * @note Если worker бросает исключение, оно пробросится после завершения остальных задач.
+ */
+template <typename Worker, typename OnProgress = std::nullptr_t>
+auto parallelForIndicesAsync(std::size_t begin,
+                             std::size_t end,
+                             Worker&& worker,
+                             ChunkPolicy policy,
+                             std::size_t threadCount = std::thread::hardware_concurrency(),
+                             OnProgress onProgress = nullptr)
+    -> std::vector<std::invoke_result_t<Worker&, std::size_t>>
+{
+    using Result = std::invoke_result_t<Worker&, std::size_t>;
+
+    const std::size_t total = (end > begin) ? (end - begin) : 0;
+    std::vector<Result> results;
+    results.resize(total);
+
+    std::atomic<std::size_t> done{0};
+    detail::runChunked(total, threadCount, policy, [&](std::size_t, std::size_t chunkBegin, std::size_t chunkEnd) {
+        for (std::size_t off = chunkBegin; off < chunkEnd; ++off) {
+            results[off] = worker(begin + off);
+
+            const std::size_t now = done.fetch_add(1, std::memory_order_relaxed) + 1;
+            if constexpr (!std::is_same_v<OnProgress, std::nullptr_t>) {
+                onProgress(now, total);
+            }
+        }
+    });
+    return results;
+}
+
 /**
  * @brief Параллельно обработать диапазон индексов [begin, end) с помощью std::async.
  *
@@ -38,46 +159,64 @@ auto parallelForIndicesAsync(std::size_t begin,
                              OnProgress onProgress = nullptr)
     -> std::vector<std::invoke_result_t<Worker&, std::size_t>>
 {
-    using Result = std::invoke_result_t<Worker&, std::size_t>;
+    return parallelForIndicesAsync(begin, end, std::forward<Worker>(worker), ChunkPolicy{}, threadCount,
+                                   std::move(onProgress));
+}
+
+/**
+ * @brief Как parallelForChunksAsync, но с явной политикой разбиения.
+ *
+ * @return По одному результату на чанк, в порядке возрастания global (независимо от того, какой поток и
+ *         когда обработал чанк).
+ */
+template <typename ChunkWorker>
+auto parallelForChunksAsync(std::size_t begin,
+                            std::size_t end,
+                            ChunkWorker&& worker,
+                            ChunkPolicy policy,
+                            std::size_t threadCount = std::thread::hardware_concurrency())
+    -> std::vector<std::invoke_result_t<ChunkWorker&, std::size_t, std::size_t>>
+{
+    using Result = std::invoke_result_t<ChunkWorker&, std::size_t, std::size_t>;
 
     const std::size_t total = (end > begin) ? (end - begin) : 0;
     std::vector<Result> results;
-    results.resize(total);
-
     if (total == 0) return results;
 
-    if (threadCount == 0) threadCount = 1;
-    threadCount = std::min(threadCount, total);
+    const std::size_t threads = threadCount == 0 ? 1 : threadCount;
+    const std::size_t chunk = detail::resolveChunkSize(total, threads, policy);
+    std::vector<std::optional<Result>> slots((total + chunk - 1) / chunk);
 
-    // Размер чанка: равномерно распределяем работу
-    const std::size_t chunk = (total + threadCount - 1) / threadCount;
-
-    std::atomic<std::size_t> done{0};
-    std::vector<std::future<void>> futs;
-    futs.reserve(threadCount);
-
-    for (std::size_t t = 0; t < threadCount; ++t) {
-        const std::size_t chunkBegin = t * chunk;
-        const std::size_t chunkEnd = std::min(total, chunkBegin + chunk);
-        if (chunkBegin >= chunkEnd) break;
-
-        futs.push_back(std::async(std::launch::async,
-            [&, chunkBegin, chunkEnd]() {
-                for (std::size_t off = chunkBegin; off < chunkEnd; ++off) {
-                    const std::size_t global = begin + off;
-                    results[off] = std::forward<Worker>(worker)(global);
-
-                    const std::size_t now = done.fetch_add(1, std::memory_order_relaxed) + 1;
-                    if constexpr (!std::is_same_v<OnProgress, std::nullptr_t>) {
-                        onProgress(now, total);
-                    }
-                }
-            }
-        ));
-    }
+    detail::runChunked(total, threads, policy, [&](std::size_t c, std::size_t chunkBegin, std::size_t chunkEnd) {
+        slots[c].emplace(worker(begin + chunkBegin, begin + chunkEnd));
+    });
 
-    for (auto& f : futs) f.get();
+    results.reserve(slots.size());
+    for (auto& r : slots) results.push_back(std::move(*r));
     return results;
 }
 
+/**
+ * @brief Параллельно обработать диапазон [begin, end) чанками: по одному вызову на чанк.
+ *
+ * В отличие от parallelForIndicesAsync, worker получает весь чанк целиком и возвращает один результат
+ * на чанк. Это позволяет держать состояние на поток (буферы, локальный TopK) и не хранить результат
+ * на каждый global.
+ *
+ * @tparam ChunkWorker Callable вида Result(std::size_t chunkBegin, std::size_t chunkEnd) — глобальные индексы.
+ *
+ * @return std::vector<Result> — по одному результату на чанк, в порядке возрастания global.
+ *
+ * @note Если worker бросает исключение, оно пробросится при get() соответствующего future.
+ */
+template <typename ChunkWorker>
+auto parallelForChunksAsync(std::size_t begin,
+                            std::size_t end,
+                            ChunkWorker&& worker,
+                            std::size_t threadCount = std::thread::hardware_concurrency())
+    -> std::vector<std::invoke_result_t<ChunkWorker&, std::size_t, std::size_t>>
+{
+    return parallelForChunksAsync(begin, end, std::forward<ChunkWorker>(worker), ChunkPolicy{}, threadCount);
+}
+
 } // namespace aip::search
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <ostream>
+#include <charconv>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+#include <aip/search/top_k.hpp>
+#include <aip/core/param_field.hpp>
+#include <aip/search/parallel_async.hpp>
+
+namespace aip::search {
+
+struct ParamExportOptions {
+    /// Разделитель полей CSV.
+    char delimiter{','};
+    /// Строк на чанк — единица работы потока.
+    std::size_t chunkSize{1024};
+    std::size_t threadCount{std::thread::hardware_concurrency()};
+};
+
+/**
+ * @brief Параметры набора кандидатов в колоночном виде.
+ *
+ * Строка r — кандидат globals[r] с оценкой scores[r]; columns[c][r] — значение параметра names[c].
+ * Имена столбцов — "s<сегмент>.<имя параметра>", для неименованных — "s<сегмент>.p<позиция>".
+ * Значения — double (asDouble): целые больше 2^53 по модулю теряют точность, нечисловые — NaN.
+ */
+template <typename Score = double>
+struct ParamTable {
+    std::vector<std::string> names;
+    std::vector<std::size_t> globals;
+    std::vector<Score> scores;
+    std::vector<std::vector<double>> columns;
+
+    [[nodiscard]] std::size_t rows() const noexcept { return globals.size(); }
+
+    /// Столбец по имени (пустой span — нет такого столбца).
+    [[nodiscard]] std::span<const double> column(std::string_view name) const noexcept {
+        const auto it = std::find(names.begin(), names.end(), name);
+        if (it == names.end()) return {};
+        return columns[static_cast<std::size_t>(it - names.begin())];
+    }
+};
+
+namespace detail {
+
+/// Имена столбцов параметров и смещение первого столбца каждого сегмента.
+template <typename Orch>
+std::vector<std::string> paramColumnNames(const Orch& orch, std::vector<std::size_t>& offsets) {
+    std::vector<std::string> names;
+    offsets.assign(orch.entryCount() + 1, 0);
+    std::vector<core::ParamField> fields;
+    for (std::size_t e = 0; e < orch.entryCount(); ++e) {
+        offsets[e] = names.size();
+        const auto& entry = orch[e];
+        fields.resize(entry.paramCount());
+        // имена не зависят от кандидата — берём у local 0
+        const std::size_t n = entry.size() > 0 ? entry.paramsAt(0, fields) : 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            // дописываем по частям: "s" + std::to_string(...) даёт ложный -Wrestrict в GCC 12
+            std::string name = "s";
+            name += std::to_string(e);
+            name += '.';
+            if (fields[j].label.empty()) {
+                name += 'p';
+                name += std::to_string(fields[j].index);
+            } else {
+                name += fields[j].label;
+            }
+            names.push_back(std::move(name));
+        }
+    }
+    offsets.back() = names.size();
+    return names;
+}
+
+/// Дописать поле CSV по RFC 4180: в кавычках, если содержит разделитель, '"', '\n' или '\r'; '"' удваивается.
+inline void appendCsvField(std::string& out, std::string_view s, char delimiter) {
+    const auto special = [delimiter](char ch) { return ch == delimiter || ch == '"' || ch == '\n' || ch == '\r'; };
+    if (std::none_of(s.begin(), s.end(), special)) {
+        out += s;
+        return;
+    }
+    out += '"';
+    for (const char ch : s) {
+        if (ch == '"') out += '"';
+        out += ch;
+    }
+    out += '"';
+}
+
+/// Наибольшее paramCount() среди сегментов — размер буфера ParamField на поток.
+template <typename Orch>
+std::size_t maxParamCount(const Orch& orch) noexcept {
+    std::size_t m = 0;
+    for (std::size_t e = 0; e < orch.entryCount(); ++e) m = std::max(m, orch[e].paramCount());
+    return m;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Выгрузить параметры кандидатов (обычно TopK::sorted()) в столбцы.
+ *
+ * Строки раскладываются параллельно чанками; параметры читаются через IEntry::paramsAt —
+ * без форматирования и аллокаций на строку.
+ */
+template <typename Orch, typename Score>
+[[nodiscard]] ParamTable<Score> exportParamTable(const Orch& orch, std::span<const Scored<Score>> rows,
+                                                 const ParamExportOptions& opt = {}) {
+    ParamTable<Score> t;
+    std::vector<std::size_t> offsets;
+    t.names = detail::paramColumnNames(orch, offsets);
+    t.globals.resize(rows.size());
+    t.scores.resize(rows.size());
+    t.columns.assign(t.names.size(), std::vector<double>(rows.size()));
+
+    const std::size_t K = orch.entryCount();
+    const std::size_t maxParams = detail::maxParamCount(orch);
+    detail::runChunked(rows.size(), opt.threadCount, ChunkPolicy::dynamicChunks(opt.chunkSize),
+                       [&](std::size_t, std::size_t begin, std::size_t end) {
+                           std::vector<std::size_t> locals(K);
+                           std::vector<core::ParamField> fields(maxParams);
+                           for (std::size_t r = begin; r < end; ++r) {
+                               t.globals[r] = rows[r].global;
+                               t.scores[r] = rows[r].score;
+                               orch.decodeLocals(rows[r].global, locals);
+                               for (std::size_t e = 0; e < K; ++e) {
+                                   const std::size_t n = orch[e].paramsAt(locals[e], fields);
+                                   for (std::size_t j = 0; j < n; ++j)
+                                       t.columns[offsets[e] + j][r] = core::asDouble(fields[j].value);
+                               }
+                           }
+                       });
+    return t;
+}
+
+template <typename Orch, typename Score>
+[[nodiscard]] ParamTable<Score> exportParamTable(const Orch& orch, const std::vector<Scored<Score>>& rows,
+                                                 const ParamExportOptions& opt = {}) {
+    return exportParamTable(orch, std::span<const Scored<Score>>(rows), opt);
+}
+
+/**
+ * @brief Записать параметры кандидатов в CSV: "global,score,<столбцы параметров>" (см. ParamTable).
+ *
+ * Числа форматируются std::to_chars (double — кратчайшее точное представление, целые — точно);
+ * чанки строк форматируются параллельно в отдельные буферы и пишутся в os по порядку.
+ * Нечисловые параметры форматируются через IEntry::forEachParamAt; такие значения и имена столбцов
+ * экранируются по RFC 4180 (кавычки, если есть разделитель, '"' или перевод строки).
+ *
+ * @tparam Score Арифметический тип оценки.
+ */
+template <typename Orch, typename Score>
+void writeParamCsv(std::ostream& os, const Orch& orch, std::span<const Scored<Score>> rows,
+                   const ParamExportOptions& opt = {}) {
+    static_assert(std::is_arithmetic_v<Score>, "writeParamCsv: Score must be arithmetic");
+
+    std::vector<std::size_t> offsets;
+    const auto names = detail::paramColumnNames(orch, offsets);
+    std::string header = "global";
+    header += opt.delimiter;
+    header += "score";
+    for (const auto& n : names) {
+        header += opt.delimiter;
+        detail::appendCsvField(header, n, opt.delimiter);
+    }
+    header += '\n';
+    os << header;
+
+    const std::size_t K = orch.entryCount();
+    const std::size_t maxParams = detail::maxParamCount(orch);
+    const std::size_t chunk = opt.chunkSize > 0 ? opt.chunkSize : 1;
+    std::vector<std::string> text((rows.size() + chunk - 1) / chunk);
+
+    detail::runChunked(rows.size(), opt.threadCount, ChunkPolicy::dynamicChunks(chunk),
+                       [&](std::size_t c, std::size_t begin, std::size_t end) {
+                           std::vector<std::size_t> locals(K);
+                           std::vector<core::ParamField> fields(maxParams);
+                           std::string& out = text[c];
+                           out.reserve((end - begin) * (2 + names.size()) * 12);
+
+                           char buf[64];
+                           const auto put = [&](const core::ParamValue& v) {
+                               out.append(buf, core::toChars(buf, buf + sizeof(buf), v).ptr);
+                           };
+                           for (std::size_t r = begin; r < end; ++r) {
+                               put(core::toParamValue(rows[r].global));
+                               out += opt.delimiter;
+                               put(core::toParamValue(rows[r].score));
+                               orch.decodeLocals(rows[r].global, locals);
+                               for (std::size_t e = 0; e < K; ++e) {
+                                   const std::size_t n = orch[e].paramsAt(locals[e], fields);
+                                   for (std::size_t j = 0; j < n; ++j) {
+                                       out += opt.delimiter;
+                                       if (!std::holds_alternative<std::monostate>(fields[j].value)) {
+                                           put(fields[j].value);
+                                           continue;
+                                       }
+                                       std::size_t k = 0;
+                                       orch[e].forEachParamAt(locals[e], [&](std::string_view, std::string s) {
+                                           if (k++ == j) detail::appendCsvField(out, s, opt.delimiter);
+                                       });
+                                   }
+                               }
+                               out += '\n';
+                           }
+                       });
+
+    for (const auto& s : text) os.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+template <typename Orch, typename Score>
+void writeParamCsv(std::ostream& os, const Orch& orch, const std::vector<Scored<Score>>& rows,
+                   const ParamExportOptions& opt = {}) {
+    writeParamCsv(os, orch, std::span<const Scored<Score>>(rows), opt);
+}
+
+}  // namespace aip::search
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <array>
 #include <cstddef>
 #include <optional>
@@ -53,6 +54,54 @@ public:
         return idx;
     }
 
+    /**
+     * @brief Пакетный next(): раскладка по базам — один раз на пакет, дальше декремент одометра.
+     *
+     * @return Число записанных комбинаций (меньше out.size() только в конце перебора).
+     */
+    [[nodiscard]] std::size_t nextBatch(std::span<index_type> out) noexcept {
+        if (!space || finished || out.empty()) return 0;
+
+        index_type idx{};
+        std::size_t local = currentLocal;
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t base = space->bases[i];
+            if (base == 0) { finished = true; return 0; }
+            idx[i] = local % base;
+            local /= base;
+        }
+
+        std::size_t n = 0;
+        while (n < out.size()) {
+            out[n++] = idx;
+            if (currentLocal == 0) {
+                finished = true;
+                break;
+            }
+            --currentLocal;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (idx[i] > 0) {
+                    --idx[i];
+                    break;
+                }
+                idx[i] = space->bases[i] - 1;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @brief Пропустить n комбинаций за O(1): следующий next() вернёт комбинацию на n позже.
+     */
+    void skip(std::size_t n) noexcept {
+        if (!space || finished || n == 0) return;
+        if (n > currentLocal) {
+            finished = true;
+            return;
+        }
+        currentLocal -= n;
+    }
+
 private:
     const IndexSpace<N>* space{nullptr};
     std::size_t currentLocal{0};
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <span>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+#include <aip/core/fingerprint.hpp>
+#include <aip/core/mapped_file.hpp>
+#include <aip/profile/trace.hpp>
+#include <aip/search/segment_loss.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Постоянный (между запусками) кэш оценок: (ключ, local) -> double.
+ *
+ * Ключ — отпечаток содержимого: обычно ScoreCache::key(отпечаток сегмента, отпечаток его данных),
+ * так что любое изменение решётки, домена, типа модели или точек сегмента даёт другой ключ и
+ * старые значения просто не находятся (точная инвалидация без явного сброса).
+ *
+ * Хранилище — файл, отображённый в память (MappedFile): заголовок + хеш-таблица с открытой
+ * адресацией (линейное пробирование), ёмкость — степень двойки, рост вдвое при заполнении > 70%.
+ *
+ * Потокобезопасен (один mutex). Несколько процессов не должны писать в один файл одновременно.
+ */
+class ScoreCache {
+   public:
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    /**
+     * @brief Открыть или создать файл кэша.
+     *
+     * @throws std::runtime_error если файл существует, но не является кэшем этой версии.
+     * @throws std::system_error при ошибках ОС.
+     */
+    explicit ScoreCache(const std::filesystem::path& path, std::size_t initialCapacity = 1 << 12) {
+        std::size_t cap = 16;
+        while (cap < initialCapacity) cap <<= 1;
+
+        file_ = aip::core::MappedFile(path, aip::core::MappedFile::Mode::ReadWrite);
+        if (file_.size() == 0) {
+            file_.resize(bytesFor(cap));
+            Header h{};
+            std::memcpy(h.magic, kMagic, sizeof(h.magic));
+            h.version = kFormatVersion;
+            h.capacity = cap;
+            writeHeader(h);
+            return;
+        }
+
+        const auto bad = [] { return std::runtime_error("ScoreCache: not a cache file of a supported version"); };
+        if (file_.size() < sizeof(Header)) throw bad();
+        const Header h = header();
+        if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0 || h.version != kFormatVersion) throw bad();
+        // Пробирование маскирует индекс по (capacity - 1) и ищет пустой слот: нужна степень двойки и count < capacity.
+        if (h.capacity == 0 || (h.capacity & (h.capacity - 1)) != 0 || h.count >= h.capacity ||
+            h.capacity > (std::numeric_limits<std::size_t>::max() - sizeof(Header)) / sizeof(Slot) ||
+            file_.size() != bytesFor(h.capacity))
+            throw bad();
+    }
+
+    /// Ключ кэша для сегмента с отпечатком entry на данных с отпечатком data.
+    [[nodiscard]] static aip::core::Fingerprint key(const aip::core::Fingerprint& entry,
+                                                    const aip::core::Fingerprint& data) noexcept {
+        aip::core::Fingerprinter f;
+        f.add(entry.hi).add(entry.lo).add(data.hi).add(data.lo);
+        return *f.result();
+    }
+
+    [[nodiscard]] std::optional<double> find(const aip::core::Fingerprint& key, std::size_t local) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t cap = header().capacity;
+        for (std::size_t i = slotOf(key, local, cap);; i = (i + 1) & (cap - 1)) {
+            const Slot s = slot(i);
+            if (s.empty()) break;
+            if (s.matches(key, local)) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return s.value;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    void store(const aip::core::Fingerprint& key, std::size_t local, double value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Header h = header();
+        if ((h.count + 1) * 10 > h.capacity * 7) {
+            grow(h.capacity * 2);
+            h = header();
+        }
+        if (insert(Slot{key.hi, key.lo, local, value}, h.capacity)) {
+            ++h.count;
+            writeHeader(h);
+        }
+    }
+
+    /// Число сохранённых значений.
+    [[nodiscard]] std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return header().count;
+    }
+
+    [[nodiscard]] std::size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return header().capacity;
+    }
+
+    /// Попадания/промахи find() за время жизни объекта.
+    [[nodiscard]] std::size_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::size_t misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+
+    /// Сбросить изменения на диск (msync).
+    void flush() {
+        AIP_TRACE_SCOPE("cache.flush", "io");
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.flush();
+    }
+
+   private:
+    static constexpr char kMagic[8] = {'A', 'I', 'P', 'S', 'C', 'O', 'R', 'E'};
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+        std::uint64_t capacity;
+        std::uint64_t count;
+    };
+
+    struct Slot {
+        std::uint64_t hi;
+        std::uint64_t lo;
+        std::uint64_t local;
+        double value;
+
+        // отпечатки никогда не равны {0, 0} (см. Fingerprinter::result)
+        [[nodiscard]] bool empty() const noexcept { return hi == 0 && lo == 0; }
+        [[nodiscard]] bool matches(const aip::core::Fingerprint& k, std::size_t l) const noexcept {
+            return hi == k.hi && lo == k.lo && local == l;
+        }
+    };
+
+    static_assert(sizeof(Header) == 32 && sizeof(Slot) == 32);
+
+    aip::core::MappedFile file_;
+    mutable std::mutex mutex_;
+    mutable std::atomic<std::size_t> hits_{0};
+    mutable std::atomic<std::size_t> misses_{0};
+
+    static constexpr std::size_t bytesFor(std::size_t cap) noexcept { return sizeof(Header) + cap * sizeof(Slot); }
+
+    static std::size_t slotOf(const aip::core::Fingerprint& k, std::size_t local, std::size_t cap) noexcept {
+        std::uint64_t z = k.lo ^ (k.hi + 0x9e3779b97f4a7c15ull * (static_cast<std::uint64_t>(local) + 1));
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<std::size_t>(z ^ (z >> 31)) & (cap - 1);
+    }
+
+    // Доступ через memcpy: содержимое файла не обязано быть выровнено под объекты.
+    [[nodiscard]] Header header() const noexcept {
+        Header h{};
+        std::memcpy(&h, file_.data(), sizeof(h));
+        return h;
+    }
+    void writeHeader(const Header& h) noexcept { std::memcpy(file_.data(), &h, sizeof(h)); }
+
+    [[nodiscard]] Slot slot(std::size_t i) const noexcept {
+        Slot s{};
+        std::memcpy(&s, file_.data() + sizeof(Header) + i * sizeof(Slot), sizeof(s));
+        return s;
+    }
+    void writeSlot(std::size_t i, const Slot& s) noexcept {
+        std::memcpy(file_.data() + sizeof(Header) + i * sizeof(Slot), &s, sizeof(s));
+    }
+
+    /// @return true, если добавлена новая запись (false — перезаписана существующая).
+    bool insert(const Slot& s, std::size_t cap) noexcept {
+        const aip::core::Fingerprint k{s.hi, s.lo};
+        for (std::size_t i = slotOf(k, s.local, cap);; i = (i + 1) & (cap - 1)) {
+            const Slot cur = slot(i);
+            if (cur.empty() || cur.matches(k, s.local)) {
+                writeSlot(i, s);
+                return cur.empty();
+            }
+        }
+    }
+
+    void grow(std::size_t newCap) {
+        AIP_TRACE_SCOPE("cache.grow", "io");
+        Header h = header();
+        std::vector<Slot> live;
+        live.reserve(h.count);
+        for (std::size_t i = 0; i < h.capacity; ++i) {
+            const Slot s = slot(i);
+            if (!s.empty()) live.push_back(s);
+        }
+
+        file_.resize(bytesFor(newCap));
+        std::memset(file_.data() + sizeof(Header), 0, newCap * sizeof(Slot));
+        h.capacity = newCap;
+        writeHeader(h);
+        for (const auto& s : live) insert(s, newCap);
+    }
+};
+
+/// Отпечаток точек сегмента (nullopt, если типы In/Out не поддаются хешированию).
+template <typename In, typename Out>
+[[nodiscard]] std::optional<aip::core::Fingerprint> fingerprintOf(const SegmentPoints<In, Out>& pts) {
+    aip::core::Fingerprinter f;
+    f.addType<In>();
+    f.addType<Out>();
+    f.add(static_cast<std::uint64_t>(pts.xs.size()));
+    for (const auto& x : pts.xs) f.add(x);
+    for (const auto& y : pts.ys) f.add(y);
+    return f.result();
+}
+
+/**
+ * @brief entrySegmentLosses() с постоянным кэшем.
+ *
+ * Блоки кандидатов, полностью найденные в кэше, не оцениваются; остальные считаются через
+ * evalLanes и сохраняются. Если у сегмента или данных нет отпечатка, кэш не используется.
+ */
+template <typename Entry, typename In, typename Out>
+[[nodiscard]] std::vector<double> cachedSegmentLosses(ScoreCache& cache, const Entry& entry,
+                                                      const SegmentPoints<In, Out>& pts) {
+    const std::size_t W = entry.laneWidth();
+    if (entry.isConstrained() || W == 0) return {};
+
+    const auto entryFp = entry.fingerprint();
+    const auto dataFp = fingerprintOf(pts);
+    if (!entryFp || !dataFp) return entrySegmentLosses(entry, pts);
+    const auto key = ScoreCache::key(*entryFp, *dataFp);
+
+    std::vector<double> losses(entry.size(), 0.0);
+    std::vector<Out> out;
+    std::vector<double> acc(W);
+
+    for (std::size_t begin = 0; begin < entry.size(); begin += W) {
+        const std::size_t count = std::min(W, entry.size() - begin);
+        bool hit = true;
+        for (std::size_t l = 0; l < count && hit; ++l) {
+            const auto v = cache.find(key, begin + l);
+            if (v) losses[begin + l] = *v;
+            hit = v.has_value();
+        }
+        if (hit) continue;
+
+        out.resize(pts.xs.size() * W);
+        segmentLossBlock(entry, pts, begin, std::span<Out>(out), std::span<double>(acc));
+        for (std::size_t l = 0; l < count; ++l) {
+            losses[begin + l] = acc[l];
+            cache.store(key, begin + l, acc[l]);
+        }
+    }
+    return losses;
+}
+
+}  // namespace aip::search
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+#include <aip/profile/trace.hpp>
+#include <aip/profile/phase_stats.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Точки датасета, принадлежащие одному сегменту (entry) оркестратора.
+ */
+template <typename In, typename Out>
+struct SegmentPoints {
+    std::vector<In> xs;
+    std::vector<Out> ys;
+};
+
+/**
+ * @brief Номер сегмента-владельца для каждой точки.
+ *
+ * Владелец — первая entry, чей домен содержит x (так же выбирает сегмент PiecewiseModel).
+ * Для точек вне всех доменов возвращается orch.entryCount().
+ */
+template <typename Orch>
+[[nodiscard]] std::vector<std::size_t> assignPointsToEntries(const Orch& orch,
+                                                             std::span<const typename Orch::input_type> xs) {
+    const std::size_t K = orch.entryCount();
+    std::vector<std::size_t> owner(xs.size(), K);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        for (std::size_t e = 0; e < K; ++e) {
+            if (orch[e].getDomain()(xs[i])) {
+                owner[i] = e;
+                break;
+            }
+        }
+    }
+    return owner;
+}
+
+/**
+ * @brief Разбить датасет по сегментам-владельцам.
+ *
+ * Точки вне всех доменов отбрасываются: PiecewiseModel в них не определена при любом кандидате.
+ *
+ * @throws std::invalid_argument если xs.size() != ys.size().
+ */
+template <typename Orch>
+[[nodiscard]] auto partitionBySegment(const Orch& orch, std::span<const typename Orch::input_type> xs,
+                                      std::span<const typename Orch::output_type> ys) {
+    using In = typename Orch::input_type;
+    using Out = typename Orch::output_type;
+
+    if (xs.size() != ys.size()) throw std::invalid_argument("partitionBySegment: xs and ys differ in size");
+
+    const auto owner = assignPointsToEntries(orch, xs);
+    std::vector<SegmentPoints<In, Out>> parts(orch.entryCount());
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        if (owner[i] >= parts.size()) continue;
+        parts[owner[i]].xs.push_back(xs[i]);
+        parts[owner[i]].ys.push_back(ys[i]);
+    }
+    return parts;
+}
+
+/**
+ * @brief SSE блока из laneWidth() последовательных кандидатов свободного сегмента.
+ *
+ * @param scratch Буфер выходов, scratch.size() >= pts.xs.size() * laneWidth().
+ * @param losses  losses[l] — SSE кандидата localBegin + l, losses.size() >= laneWidth().
+ *
+ * @return Число валидных кандидатов в блоке (как у IEntry::evalLanes).
+ */
+template <typename Entry, typename In, typename Out>
+std::size_t segmentLossBlock(const Entry& entry, const SegmentPoints<In, Out>& pts, std::size_t localBegin,
+                             std::span<Out> scratch, std::span<double> losses) {
+    const std::size_t W = entry.laneWidth();
+    const std::size_t n = pts.xs.size();
+    std::size_t count = 0;
+    {
+        AIP_PHASE_SCOPE(Evaluate);
+        AIP_TRACE_SCOPE("evaluate", "model");
+        count = entry.evalLanes(localBegin, std::span<const In>(pts.xs), scratch);
+    }
+
+    AIP_PHASE_SCOPE(Score);
+    AIP_TRACE_SCOPE("score", "model");
+    std::fill(losses.begin(), losses.begin() + static_cast<std::ptrdiff_t>(W), 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double y = static_cast<double>(pts.ys[i]);
+        const Out* row = scratch.data() + i * W;
+        for (std::size_t l = 0; l < W; ++l) {
+            const double d = y - static_cast<double>(row[l]);
+            losses[l] += d * d;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief SSE свободного сегмента на своих точках для каждого локального индекса.
+ *
+ * Использует пакетную оценку IEntry::evalLanes (lane-ядро модели, если подключено).
+ * Для связанных (constrained) сегментов потери зависят от соседей и здесь не считаются.
+ *
+ * @return losses[local] — сумма квадратов отклонений; пустой вектор для constrained-сегмента.
+ */
+template <typename Entry, typename In, typename Out>
+[[nodiscard]] std::vector<double> entrySegmentLosses(const Entry& entry, const SegmentPoints<In, Out>& pts) {
+    const std::size_t W = entry.laneWidth();
+    if (entry.isConstrained() || W == 0) return {};
+
+    std::vector<double> losses(entry.size(), 0.0);
+    std::vector<Out> out(pts.xs.size() * W);
+    std::vector<double> acc(W);
+
+    for (std::size_t begin = 0; begin < entry.size(); begin += W) {
+        const std::size_t count = segmentLossBlock(entry, pts, begin, std::span<Out>(out), std::span<double>(acc));
+        for (std::size_t l = 0; l < count; ++l) losses[begin + l] = acc[l];
+    }
+    return losses;
+}
+
+}  // namespace aip::search
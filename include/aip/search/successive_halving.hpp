@@ -0,0 +1,196 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+#include <aip/search/top_k.hpp>
+#include <aip/search/segment_loss.hpp>
+#include <aip/search/parallel_async.hpp>
+#include <aip/profile/trace.hpp>
+#include <aip/profile/phase_stats.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Параметры successive halving по подвыборкам данных.
+ */
+struct HalvingOptions {
+    /// Доля точек в первом раунде (0 < initialFraction <= 1).
+    double initialFraction{1.0 / 16.0};
+
+    /// Во сколько раз сокращается число кандидатов и растёт подвыборка на каждом раунде (>= 2).
+    std::size_t eta{2};
+
+    /// Минимум точек от каждого страта (домена сегмента) в подвыборке.
+    std::size_t minPerStratum{2};
+
+    /// Сколько лучших кандидатов вернуть.
+    std::size_t topK{1};
+
+    /// Seed генератора подвыборок (детерминированный результат).
+    std::uint64_t seed{0x5eed};
+
+    /// Число параллельных задач.
+    std::size_t threadCount{std::thread::hardware_concurrency()};
+};
+
+/**
+ * @brief Результат successive halving.
+ */
+struct HalvingResult {
+    /// Лучшие кандидаты по оценке на полном датасете, от лучшего к худшему.
+    std::vector<Scored<double>> best;
+
+    /// Число кандидатов на входе.
+    std::size_t candidates{0};
+
+    /// Число раундов.
+    std::size_t rounds{0};
+
+    /// Сколько вычислений модели в точках выполнено всего.
+    std::size_t pointEvaluations{0};
+
+    /// Сколько вычислений понадобилось бы полному перебору (candidates * points).
+    std::size_t fullPointEvaluations{0};
+
+    /// Сэкономлено "полных оценок" (кандидат на всём датасете): (full - done) / points.
+    [[nodiscard]] double fullEvaluationsSaved() const noexcept {
+        if (fullPointEvaluations == 0) return 0.0;
+        const double points = static_cast<double>(fullPointEvaluations) / static_cast<double>(candidates);
+        // может быть отрицательным, если подвыборки оказались дороже полного перебора
+        return (static_cast<double>(fullPointEvaluations) - static_cast<double>(pointEvaluations)) / points;
+    }
+};
+
+/**
+ * @brief Стратифицированная подвыборка индексов точек.
+ *
+ * Страт точки i — strata[i] (обычно номер первого сегмента, чей домен содержит x_i).
+ * Из каждого страта берётся доля fraction (не меньше minPerStratum, не больше его размера),
+ * поэтому короткие сегменты не пропадают из малых подвыборок.
+ *
+ * @return Индексы точек по возрастанию.
+ */
+[[nodiscard]] inline std::vector<std::size_t> stratifiedSample(std::span<const std::size_t> strata, double fraction,
+                                                               std::size_t minPerStratum, std::uint64_t seed) {
+    std::size_t stratumCount = 0;
+    for (auto s : strata) stratumCount = std::max(stratumCount, s + 1);
+
+    std::vector<std::vector<std::size_t>> byStratum(stratumCount);
+    for (std::size_t i = 0; i < strata.size(); ++i) byStratum[strata[i]].push_back(i);
+
+    std::mt19937_64 rng(seed);
+    std::vector<std::size_t> out;
+    for (auto& members : byStratum) {
+        const auto want = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(members.size())));
+        const std::size_t take = std::min(members.size(), std::max(want, minPerStratum));
+        // частичный Fisher–Yates: первые take элементов — случайная выборка без повторов
+        for (std::size_t j = 0; j < take; ++j) {
+            std::uniform_int_distribution<std::size_t> dist(j, members.size() - 1);
+            std::swap(members[j], members[dist(rng)]);
+        }
+        out.insert(out.end(), members.begin(), members.begin() + static_cast<std::ptrdiff_t>(take));
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+/**
+ * @brief Multi-fidelity поиск (successive halving) по глобальным индексам оркестратора.
+ *
+ * Раунд r: все оставшиеся кандидаты оцениваются средней квадратичной ошибкой (MSE) на
+ * стратифицированной подвыборке доли initialFraction * eta^r; в следующий раунд проходит лучшая
+ * 1/eta часть (но не меньше topK). Последний раунд всегда идёт на полном датасете, так что
+ * итоговые оценки точные. Подвыборки вложены не обязательно — каждая строится заново с seed + r.
+ *
+ * Страты — сегменты: точка относится к первой entry, чей домен её содержит (как в PiecewiseModel).
+ * Точки вне всех доменов образуют отдельный страт.
+ *
+ * Меньшая MSE лучше. Кандидаты с NaN-оценкой выбывают.
+ *
+ * @param orch Оркестратор (stateless makePiecewise).
+ * @param xs   Входы.
+ * @param ys   Наблюдения, ys.size() == xs.size().
+ *
+ * @throws std::invalid_argument при несовпадении размеров или некорректных параметрах.
+ */
+template <typename Orch>
+[[nodiscard]] HalvingResult successiveHalving(const Orch& orch, std::span<const typename Orch::input_type> xs,
+                                              std::span<const typename Orch::output_type> ys,
+                                              HalvingOptions opt = {}) {
+    if (xs.size() != ys.size()) throw std::invalid_argument("successiveHalving: xs and ys differ in size");
+    if (opt.eta < 2) throw std::invalid_argument("successiveHalving: eta must be >= 2");
+    if (!(opt.initialFraction > 0.0 && opt.initialFraction <= 1.0))
+        throw std::invalid_argument("successiveHalving: initialFraction must be in (0, 1]");
+
+    HalvingResult res;
+    const std::size_t total = orch.size();
+    const std::size_t n = xs.size();
+    res.candidates = total;
+    res.fullPointEvaluations = total * n;
+    if (total == 0 || n == 0 || opt.topK == 0) return res;
+
+    // страты: номер первой entry, чей домен содержит x; вне доменов — entryCount()
+    const auto strata = assignPointsToEntries(orch, xs);
+
+    std::vector<std::size_t> alive(total);
+    std::iota(alive.begin(), alive.end(), std::size_t{0});
+
+    double fraction = opt.initialFraction;
+    for (std::size_t round = 0;; ++round) {
+        const bool last = fraction >= 1.0 || alive.size() <= opt.topK;
+
+        std::vector<std::size_t> points;
+        if (last) {
+            points.resize(n);
+            std::iota(points.begin(), points.end(), std::size_t{0});
+        } else {
+            points = stratifiedSample(strata, fraction, opt.minPerStratum, opt.seed + round);
+        }
+
+        const auto scores = parallelForIndicesAsync(
+            0, alive.size(),
+            [&](std::size_t i) {
+                const auto pm = orch.makePiecewise(alive[i]);
+                AIP_PHASE_SCOPE(Evaluate);
+                AIP_TRACE_SCOPE("evaluate", "model");
+                double sse = 0.0;
+                for (const std::size_t p : points) {
+                    const double d = static_cast<double>(ys[p]) - static_cast<double>(pm(xs[p]));
+                    sse += d * d;
+                }
+                return sse / static_cast<double>(points.size());
+            },
+            opt.threadCount);
+
+        res.pointEvaluations += alive.size() * points.size();
+        res.rounds = round + 1;
+
+        if (last) {
+            TopK<double> top(opt.topK);
+            for (std::size_t i = 0; i < alive.size(); ++i) top.push(alive[i], scores[i]);
+            res.best = top.sorted();
+            return res;
+        }
+
+        const std::size_t keep = std::max(opt.topK, (alive.size() + opt.eta - 1) / opt.eta);
+        TopK<double> top(keep);
+        for (std::size_t i = 0; i < alive.size(); ++i) top.push(alive[i], scores[i]);
+
+        alive.clear();
+        for (const auto& v : top.sorted()) alive.push_back(v.global);
+        if (alive.empty()) return res;
+
+        fraction = std::min(1.0, fraction * static_cast<double>(opt.eta));
+    }
+}
+
+}  // namespace aip::search
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include <aip/profile/trace.hpp>
+
+namespace aip::search {
+
+/**
+ * @brief Оценённый кандидат: глобальный индекс оркестратора + его оценка.
+ *
+ * @tparam Score Тип оценки (обычно double).
+ */
+template <typename Score = double>
+struct Scored {
+    std::size_t global{};
+    Score score{};
+
+    friend constexpr bool operator==(const Scored&, const Scored&) = default;
+};
+
+/**
+ * @brief Ограниченный набор K лучших кандидатов.
+ *
+ * Хранит не более K пар (global, score). "Лучший" определяется компаратором @p Better:
+ * по умолчанию std::less — меньшая оценка лучше (функция потерь). Для максимизации
+ * (например, корреляции Пирсона) используйте std::greater<>.
+ *
+ * При равных оценках выигрывает меньший global — это делает результат детерминированным
+ * независимо от порядка push()/merge() (важно при параллельном поиске).
+ *
+ * NaN-оценки (для floating-point Score) игнорируются.
+ *
+ * @tparam Score  Тип оценки.
+ * @tparam Better Строгий порядок: Better(a, b) == true, если a лучше b.
+ */
+template <typename Score = double, typename Better = std::less<Score>>
+class TopK {
+   public:
+    using value_type = Scored<Score>;
+
+    TopK() = default;
+
+    explicit TopK(std::size_t k, Better better = {}) : k_(k), better_(std::move(better)) { heap_.reserve(k_); }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return k_; }
+    [[nodiscard]] std::size_t size() const noexcept { return heap_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return heap_.empty(); }
+    [[nodiscard]] bool full() const noexcept { return heap_.size() >= k_; }
+
+    /**
+     * @brief Худший из хранимых кандидатов (граница отсечения).
+     * @note Только при !empty().
+     */
+    [[nodiscard]] const value_type& worst() const noexcept { return heap_.front(); }
+
+    /**
+     * @brief Прошёл бы кандидат с такой оценкой в набор (без учёта tie-break по global).
+     */
+    [[nodiscard]] bool admits(const Score& s) const noexcept {
+        if (isNaN(s) || k_ == 0) return false;
+        return !full() || better_(s, heap_.front().score);
+    }
+
+    /**
+     * @brief Предложить кандидата.
+     * @return true, если кандидат попал в набор.
+     */
+    bool push(std::size_t global, const Score& score) {
+        if (k_ == 0 || isNaN(score)) return false;
+
+        const value_type v{global, score};
+        if (!full()) {
+            heap_.push_back(v);
+            std::push_heap(heap_.begin(), heap_.end(), heapCmp());
+            return true;
+        }
+        if (!lessWorse(v, heap_.front())) return false;
+
+        std::pop_heap(heap_.begin(), heap_.end(), heapCmp());
+        heap_.back() = v;
+        std::push_heap(heap_.begin(), heap_.end(), heapCmp());
+        return true;
+    }
+
+    /// @brief Слить другой набор (например, результат другого потока/чанка).
+    void merge(const TopK& other) {
+        AIP_TRACE_SCOPE("merge", "search");
+        for (const auto& v : other.heap_) push(v.global, v.score);
+    }
+
+    /// @brief Кандидаты, упорядоченные от лучшего к худшему.
+    [[nodiscard]] std::vector<value_type> sorted() const {
+        std::vector<value_type> out(heap_);
+        std::sort(out.begin(), out.end(), [&](const value_type& a, const value_type& b) { return lessWorse(a, b); });
+        return out;
+    }
+
+    void clear() noexcept { heap_.clear(); }
+
+   private:
+    std::size_t k_{0};
+    Better better_{};
+    // max-heap по "худобе": на вершине худший кандидат
+    std::vector<value_type> heap_;
+
+    static bool isNaN(const Score& s) noexcept {
+        if constexpr (std::is_floating_point_v<Score>) {
+            return std::isnan(s);
+        } else {
+            (void)s;
+            return false;
+        }
+    }
+
+    /// a строго лучше b (оценка, затем меньший global)
+    bool lessWorse(const value_type& a, const value_type& b) const noexcept {
+        if (better_(a.score, b.score)) return true;
+        if (better_(b.score, a.score)) return false;
+        return a.global < b.global;
+    }
+
+    auto heapCmp() const noexcept {
+        return [this](const value_type& a, const value_type& b) { return lessWorse(a, b); };
+    }
+};
+
+}  // namespace aip::search
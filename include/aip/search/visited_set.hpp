@@ -0,0 +1,309 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <unordered_set>
+#include <unordered_map>
+
+namespace aip::search {
+
+/**
+ * @brief Плотный конкурентный набор посещённых global: один бит на индекс.
+ *
+ * Память — size / 8 байт (4 млрд индексов ~ 512 МиБ). testAndSet() — один fetch_or без блокировок.
+ */
+class VisitedBitmap {
+   public:
+    VisitedBitmap() = default;
+
+    explicit VisitedBitmap(std::size_t size)
+        : size_(size), words_(std::make_unique<std::atomic<std::uint64_t>[]>((size + 63) / 64)) {}
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return size_; }
+
+    /**
+     * @brief Отметить global как посещённый.
+     *
+     * @return true, если global отмечен впервые (вызывающий "владеет" его оценкой).
+     * @throws std::out_of_range если global >= capacity().
+     */
+    bool testAndSet(std::size_t global) {
+        if (global >= size_) throw std::out_of_range("VisitedBitmap: global is out of range");
+        const std::uint64_t bit = std::uint64_t{1} << (global & 63);
+        const std::uint64_t prev = words_[global >> 6].fetch_or(bit, std::memory_order_relaxed);
+        if (prev & bit) return false;
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] bool contains(std::size_t global) const noexcept {
+        if (global >= size_) return false;
+        const std::uint64_t bit = std::uint64_t{1} << (global & 63);
+        return (words_[global >> 6].load(std::memory_order_relaxed) & bit) != 0;
+    }
+
+    /// Число отмеченных индексов.
+    [[nodiscard]] std::size_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    /// @note Не потокобезопасно относительно testAndSet().
+    void clear() noexcept {
+        for (std::size_t w = 0; w < (size_ + 63) / 64; ++w) words_[w].store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    std::size_t size_{0};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words_;
+    std::atomic<std::size_t> count_{0};
+};
+
+/**
+ * @brief Разреженный конкурентный набор посещённых global: хеш-множества по шардам под mutex.
+ *
+ * Для пространств, где битовая карта слишком велика, а посещается лишь малая доля индексов.
+ * Шард выбирается по перемешанному global, поэтому соседние индексы попадают в разные шарды.
+ */
+class ShardedVisitedSet {
+   public:
+    explicit ShardedVisitedSet(std::size_t shardCount = 64) : shards_(shardCount == 0 ? 1 : shardCount) {}
+
+    bool testAndSet(std::size_t global) {
+        auto& s = shardOf(global);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.set.insert(global).second;
+    }
+
+    [[nodiscard]] bool contains(std::size_t global) const {
+        auto& s = shardOf(global);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.set.count(global) != 0;
+    }
+
+    [[nodiscard]] std::size_t count() const {
+        std::size_t n = 0;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            n += s.set.size();
+        }
+        return n;
+    }
+
+    void clear() {
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.set.clear();
+        }
+    }
+
+   private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<std::size_t> set;
+    };
+
+    mutable std::vector<Shard> shards_;
+
+    Shard& shardOf(std::size_t global) const noexcept { return shards_[mixIndex(global) % shards_.size()]; }
+
+   public:
+    /// splitmix64-финализатор: равномерное распределение последовательных индексов по шардам.
+    static constexpr std::size_t mixIndex(std::size_t x) noexcept {
+        std::uint64_t z = static_cast<std::uint64_t>(x) + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<std::size_t>(z ^ (z >> 31));
+    }
+};
+
+/**
+ * @brief Набор посещённых global с автоматическим выбором представления.
+ *
+ * При size <= denseLimit — VisitedBitmap (по умолчанию до 2^33 индексов, <= 1 ГиБ),
+ * иначе — ShardedVisitedSet.
+ */
+class VisitedSet {
+   public:
+    static constexpr std::size_t kDefaultDenseLimit = std::size_t{1} << 33;
+
+    explicit VisitedSet(std::size_t size, std::size_t denseLimit = kDefaultDenseLimit) {
+        if (size <= denseLimit)
+            dense_.emplace(size);
+        else
+            sparse_ = std::make_unique<ShardedVisitedSet>();
+    }
+
+    [[nodiscard]] bool isDense() const noexcept { return dense_.has_value(); }
+
+    /// @return true, если global отмечен впервые.
+    bool testAndSet(std::size_t global) { return dense_ ? dense_->testAndSet(global) : sparse_->testAndSet(global); }
+
+    [[nodiscard]] bool contains(std::size_t global) const {
+        return dense_ ? dense_->contains(global) : sparse_->contains(global);
+    }
+
+    [[nodiscard]] std::size_t count() const { return dense_ ? dense_->count() : sparse_->count(); }
+
+    void clear() {
+        if (dense_)
+            dense_->clear();
+        else
+            sparse_->clear();
+    }
+
+   private:
+    std::optional<VisitedBitmap> dense_;
+    std::unique_ptr<ShardedVisitedSet> sparse_;
+};
+
+/**
+ * @brief Конкурентная память оценок global -> score.
+ *
+ * getOrCompute() гарантирует, что для каждого global функция оценки выполнится ровно один раз
+ * за время жизни памяти: первый вызвавший поток считает, остальные ждут его результат.
+ * Если оценка бросила исключение, оно передаётся всем ожидающим, а запись удаляется
+ * (следующий вызов посчитает заново).
+ *
+ * @tparam Score Тип оценки.
+ */
+template <typename Score = double>
+class ScoreMemo {
+   public:
+    explicit ScoreMemo(std::size_t shardCount = 64) : shards_(shardCount == 0 ? 1 : shardCount) {}
+
+    /**
+     * @brief Вернуть сохранённую оценку global или посчитать её через fn(global).
+     */
+    template <typename Fn>
+    Score getOrCompute(std::size_t global, Fn&& fn) {
+        auto& s = shardOf(global);
+        std::promise<Score> promise;
+        {
+            std::unique_lock<std::mutex> lock(s.mutex);
+            auto it = s.map.find(global);
+            if (it != s.map.end()) {
+                auto fut = it->second;
+                lock.unlock();
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return fut.get();
+            }
+            s.map.emplace(global, promise.get_future().share());
+        }
+
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        try {
+            Score v = std::invoke(fn, global);
+            promise.set_value(v);
+            return v;
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.map.erase(global);
+            throw;
+        }
+    }
+
+    /// Сохранённая (и уже посчитанная) оценка, без ожидания.
+    [[nodiscard]] std::optional<Score> find(std::size_t global) const {
+        auto& s = shardOf(global);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.map.find(global);
+        if (it == s.map.end()) return std::nullopt;
+        if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return std::nullopt;
+        return it->second.get();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        std::size_t n = 0;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            n += s.map.size();
+        }
+        return n;
+    }
+
+    /// Сколько раз оценка была взята из памяти.
+    [[nodiscard]] std::size_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+
+    /// Сколько раз оценка была посчитана.
+    [[nodiscard]] std::size_t misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+
+    /// @note Не вызывать одновременно с getOrCompute().
+    void clear() {
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.map.clear();
+        }
+        hits_.store(0, std::memory_order_relaxed);
+        misses_.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::size_t, std::shared_future<Score>> map;
+    };
+
+    mutable std::vector<Shard> shards_;
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+
+    Shard& shardOf(std::size_t global) const noexcept {
+        return shards_[ShardedVisitedSet::mixIndex(global) % shards_.size()];
+    }
+};
+
+/**
+ * @brief Оценщик global -> score, который никогда не оценивает один global дважды.
+ *
+ * Оборачивает произвольный scorer (например, для JobScheduler, screenAndRescore или ручного цикла
+ * по Orchestrator::nextGlobal()) общей ScoreMemo. Одну память можно разделить между несколькими
+ * стратегиями/рестартами одного запуска — повторно предложенные global берутся из памяти.
+ */
+template <typename Scorer, typename Score = double>
+class MemoizedScorer {
+   public:
+    MemoizedScorer(Scorer scorer, ScoreMemo<Score>& memo) : scorer_(std::move(scorer)), memo_(&memo) {}
+
+    Score operator()(std::size_t global) const { return memo_->getOrCompute(global, scorer_); }
+
+   private:
+    Scorer scorer_;
+    ScoreMemo<Score>* memo_;
+};
+
+template <typename Scorer, typename Score>
+[[nodiscard]] MemoizedScorer<std::decay_t<Scorer>, Score> memoize(Scorer&& scorer, ScoreMemo<Score>& memo) {
+    return MemoizedScorer<std::decay_t<Scorer>, Score>(std::forward<Scorer>(scorer), memo);
+}
+
+/**
+ * @brief Прогнать stateful-стратегию оркестратора, пропуская уже посещённые global.
+ *
+ * Вызывает fn(global) только для global, впервые отмеченных в visited. Один VisitedSet можно
+ * использовать для нескольких проходов (рестарты, coarse-to-fine) — каждый global будет выдан один раз.
+ *
+ * @return Число выданных (новых) global.
+ */
+template <typename Orch, typename Fn>
+std::size_t forEachUnvisited(Orch& orch, VisitedSet& visited, Fn&& fn) {
+    std::size_t fresh = 0;
+    while (auto g = orch.nextGlobal()) {
+        if (!visited.testAndSet(*g)) continue;
+        ++fresh;
+        fn(*g);
+    }
+    return fresh;
+}
+
+}  // namespace aip::search
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/top_k.hpp>
+#include <aip/search/segment_loss.hpp>
+#include <aip/search/visited_set.hpp>
+#include <aip/profile/alloc_tracking.hpp>
+
+// Хуки действуют на весь исполняемый файл aip_tests.
+AIP_DEFINE_ALLOCATION_HOOKS();
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+using Grid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+
+Orch makeOrch() {
+    Grid g;
+    g.get<0>() = {-1.0, 1.0, 0.5};
+    g.get<1>() = {-1.0, 1.0, 0.5};
+    Orch o;
+    o.add(Seg{0.0, 1.0}, g);
+    o.add(Seg{1.0, 2.0}, g);
+    o.add(Seg{2.0, 3.0}, g);
+    return o;
+}
+
+}  // namespace
+
+TEST(AllocTracking, hooks_count_allocations_of_this_thread) {
+    ASSERT_TRUE(aip::profile::allocationHooksInstalled());
+
+    aip::profile::AllocScope scope;
+    auto v = std::make_unique<std::vector<int>>(100);
+    EXPECT_GE(scope.allocations(), 2u);
+    EXPECT_GE(scope.bytes(), 100 * sizeof(int));
+
+    const auto before = aip::profile::threadAllocationCounts().deallocations;
+    v.reset();
+    EXPECT_GE(aip::profile::threadAllocationCounts().deallocations, before + 2);
+}
+
+TEST(AllocTracking, allocations_are_attributed_to_innermost_phase) {
+    aip::profile::resetPhaseStats();
+    {
+        aip::profile::ScopedPhase build(aip::profile::Phase::Build);
+        auto a = std::make_unique<double>(1.0);
+        {
+            aip::profile::ScopedPhase decode(aip::profile::Phase::Decode);
+            std::vector<char> buf(64);
+        }
+    }
+    auto outside = std::make_unique<int>(0);  // вне фаз не учитывается
+
+    const auto s = aip::profile::collectPhaseStats();
+    EXPECT_EQ(s[aip::profile::Phase::Build].allocations, 1u);
+    EXPECT_EQ(s[aip::profile::Phase::Build].allocatedBytes, sizeof(double));
+    EXPECT_EQ(s[aip::profile::Phase::Decode].allocations, 1u);
+    EXPECT_EQ(s[aip::profile::Phase::Decode].allocatedBytes, 64u);
+}
+
+TEST(AllocTracking, makePiecewise_allocation_rate_is_measurable) {
+    const auto orch = makeOrch();
+    aip::profile::AllocScope scope;
+    const auto pm = orch.makePiecewise(orch.size() / 2);
+    EXPECT_GT(scope.allocations(), 0u);  // vector locals + shared_ptr на сегмент + вектор сегментов
+}
+
+// Горячие пути, которые должны оставаться без аллокаций.
+
+TEST(AllocFree, decodeLocals_into_span) {
+    const auto orch = makeOrch();
+    std::vector<std::size_t> locals(orch.entryCount());
+    orch.decodeLocals(0, std::span<std::size_t>(locals));  // прогрев (регистрация счётчиков фаз потока)
+    {
+        aip::profile::NoAllocGuard guard("Orchestrator::decodeLocals(span)");
+        for (std::size_t g = 0; g < orch.size(); g += 7) orch.decodeLocals(g, std::span<std::size_t>(locals));
+    }
+    EXPECT_EQ(orch.encodeLocals(locals), (orch.size() - 1) / 7 * 7);
+}
+
+TEST(AllocFree, piecewise_model_evaluation) {
+    const auto orch = makeOrch();
+    const auto pm = orch.makePiecewise(3);
+    double acc = pm(0.5);
+    {
+        aip::profile::NoAllocGuard guard("PiecewiseModel::operator()");
+        for (int i = 0; i < 300; ++i) acc += pm(0.01 * i);
+    }
+    EXPECT_TRUE(std::isfinite(acc));
+}
+
+TEST(AllocFree, segment_loss_block_with_preallocated_scratch) {
+    const auto orch = makeOrch();
+    aip::search::SegmentPoints<double, double> pts;
+    for (int i = 0; i < 32; ++i) {
+        pts.xs.push_back(i / 32.0);
+        pts.ys.push_back(0.5 * i / 32.0);
+    }
+    const std::size_t W = orch[0].laneWidth();
+    std::vector<double> scratch(pts.xs.size() * W), losses(W);
+    aip::search::segmentLossBlock(orch[0], pts, 0, std::span<double>(scratch), std::span<double>(losses));
+    {
+        aip::profile::NoAllocGuard guard("segmentLossBlock");
+        for (std::size_t b = 0; b < orch[0].size(); b += W)
+            aip::search::segmentLossBlock(orch[0], pts, b, std::span<double>(scratch), std::span<double>(losses));
+    }
+}
+
+TEST(AllocFree, top_k_push_and_visited_bitmap) {
+    aip::search::TopK<double> top(8);
+    for (std::size_t g = 0; g < 8; ++g) top.push(g, static_cast<double>(g));
+    aip::search::VisitedBitmap visited(1024);
+    {
+        aip::profile::NoAllocGuard guard("TopK::push / VisitedBitmap::testAndSet");
+        for (std::size_t g = 0; g < 1024; ++g) {
+            top.push(g, static_cast<double>(g % 13));
+            (void)visited.testAndSet(g);
+        }
+    }
+    EXPECT_EQ(visited.count(), 1024u);
+}
+
+TEST(AllocFreeDeathTest, guard_aborts_when_hot_path_allocates) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH(
+        {
+            aip::profile::NoAllocGuard guard("test");
+            // Явный вызов ::operator new и volatile-приёмник: пару new/delete из new-выражения
+            // оптимизатор вправе удалить, и аллокация не дошла бы до хука.
+            static void* volatile sink = nullptr;
+            sink = ::operator new(16);
+            ::operator delete(sink);
+        },
+        "hot path 'test' allocated");
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <cmath>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#include <aip/model/imodel.hpp>
+#include <aip/model/piecewise_model.hpp>
+#include <aip/search/batch_inference.hpp>
+
+namespace {
+
+/// Линейная модель, считающая вызовы пакетного пути.
+struct CountingLine final : aip::model::IModel<double, double> {
+    double k{}, b{};
+    mutable std::atomic<std::size_t> batches{0};
+    CountingLine(double kk, double bb) : k(kk), b(bb) {}
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k * x + b; }
+    void evaluate(std::span<const double> xs, std::span<double> out) const override {
+        ++batches;
+        for (std::size_t i = 0; i < xs.size(); ++i) out[i] = k * xs[i] + b;
+    }
+};
+
+struct Square final : aip::model::IModel<double, double> {
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return x * x; }
+};
+
+struct Interval {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+using Piecewise = aip::model::PiecewiseModel<double, double, Interval>;
+
+void expectSame(double a, double b) {
+    if (std::isnan(a)) {
+        EXPECT_TRUE(std::isnan(b));
+    } else {
+        EXPECT_DOUBLE_EQ(a, b);
+    }
+}
+
+}  // namespace
+
+TEST(BatchInference, default_model_batch_matches_scalar) {
+    const Square square;
+    const aip::model::IModel<double, double>& model = square;
+    const std::vector<double> xs{-2.0, 0.5, 3.0};
+    std::vector<double> out(xs.size());
+    model.evaluate(xs, out);
+    for (std::size_t i = 0; i < xs.size(); ++i) EXPECT_DOUBLE_EQ(out[i], model(xs[i]));
+
+    std::vector<double> small(1);
+    EXPECT_THROW(model.evaluate(xs, small), std::invalid_argument);
+}
+
+TEST(BatchInference, piecewise_batch_groups_sorted_and_shuffled_inputs) {
+    auto left = std::make_shared<CountingLine>(1.0, 0.0);
+    auto right = std::make_shared<CountingLine>(-1.0, 4.0);
+    Piecewise pm;
+    pm.add(Interval{0.0, 2.0}, left);
+    pm.add(Interval{1.5, 4.0}, right);  // пересечение: выигрывает первый
+    pm.add(Interval{5.0, 6.0}, std::make_shared<Square>());  // пробел [4, 5)
+
+    std::vector<double> sorted;
+    for (int i = 0; i < 1000; ++i) sorted.push_back(-0.5 + 7.0 * i / 1000.0);
+    std::vector<double> out(sorted.size());
+    pm.evaluate(sorted, out);
+    for (std::size_t i = 0; i < sorted.size(); ++i) expectSame(pm(sorted[i]), out[i]);
+    EXPECT_LE(left->batches.load(), 4u);  // одна серия на блок из 256 точек
+    EXPECT_LE(right->batches.load(), 4u);
+
+    std::vector<double> shuffled;
+    for (int i = 0; i < 1000; ++i) shuffled.push_back(std::fmod(i * 0.731, 7.0) - 0.5);
+    left->batches = 0;
+    pm.evaluate(shuffled, out);
+    for (std::size_t i = 0; i < shuffled.size(); ++i) expectSame(pm(shuffled[i]), out[i]);
+    EXPECT_LE(left->batches.load(), 4u);  // блок переупорядочен по сегментам
+
+    std::vector<double> small(1);
+    EXPECT_THROW(pm.evaluate(shuffled, small), std::invalid_argument);
+}
+
+TEST(BatchInference, parallel_evaluation_keeps_input_order) {
+    Piecewise pm;
+    pm.add(Interval{0.0, 50.0}, std::make_shared<CountingLine>(2.0, 1.0));
+    pm.add(Interval{50.0, 100.0}, std::make_shared<Square>());
+
+    std::vector<double> xs(100'000);
+    for (std::size_t i = 0; i < xs.size(); ++i) xs[i] = std::fmod(static_cast<double>(i) * 0.37, 110.0);
+    std::vector<double> out(xs.size());
+    aip::search::evaluateParallel(pm, std::span<const double>(xs), std::span<double>(out),
+                                  {.chunkSize = 1000, .threadCount = 4});
+    for (std::size_t i = 0; i < xs.size(); ++i) expectSame(pm(xs[i]), out[i]);
+
+    std::vector<double> small(1);
+    EXPECT_THROW(aip::search::evaluateParallel(pm, std::span<const double>(xs), std::span<double>(small)),
+                 std::invalid_argument);
+}
+
+TEST(BatchInference, stream_processes_blocks_in_order) {
+    const Square model;
+    const std::size_t total = 10'007;
+    std::size_t produced = 0;
+    auto source = [&](std::span<double> buf) {
+        std::size_t n = 0;
+        for (; n < buf.size() && produced < total; ++n) buf[n] = static_cast<double>(produced++);
+        return n;
+    };
+
+    std::vector<double> got;
+    std::size_t blocks = 0;
+    auto sink = [&](std::span<const double> xs, std::span<const double> ys) {
+        ++blocks;
+        ASSERT_EQ(xs.size(), ys.size());
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            EXPECT_DOUBLE_EQ(xs[i], static_cast<double>(got.size()));
+            got.push_back(ys[i]);
+        }
+    };
+
+    const std::size_t n =
+        aip::search::evaluateStream(model, source, sink, {.chunkSize = 256, .streamBlock = 1000, .threadCount = 3});
+    EXPECT_EQ(n, total);
+    EXPECT_EQ(blocks, 11u);
+    ASSERT_EQ(got.size(), total);
+    for (std::size_t i = 0; i < total; ++i) EXPECT_DOUBLE_EQ(got[i], static_cast<double>(i * i));
+
+    EXPECT_THROW(aip::search::evaluateStream(model, source, sink, {.streamBlock = 0}), std::invalid_argument);
+}
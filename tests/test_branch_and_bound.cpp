@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <cmath>
+#include <vector>
+#include <limits>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/params/unit_grid.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/branch_and_bound.hpp>
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+struct Parabola final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"a"}> a{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"c"}> c{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return a.value * x * x + c.value; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    double k{}, m{};
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k * x + m; }
+};
+
+struct FitLine {
+    double xL{}, xR{};
+    void operator()(Line& l, const double& yL, const double& yR) const noexcept {
+        l.k = (yR - yL) / (xR - xL);
+        l.m = yL - l.k * xL;
+    }
+};
+
+using PGrid = aip::params::ParamGrid<Parabola, aip::params::UniformRange, &Parabola::a, &Parabola::c>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+
+PGrid grid() {
+    PGrid g;
+    g.get<0>() = {-1.0, 1.0, 0.25};  // 9
+    g.get<1>() = {-1.0, 1.0, 0.5};   // 5
+    return g;
+}
+
+void data(std::vector<double>& xs, std::vector<double>& ys) {
+    for (int i = 0; i < 300; ++i) {
+        const double x = -3.0 + i * 0.02;
+        xs.push_back(x);
+        ys.push_back(x < -1.0 ? 0.6 * x * x - 0.4 : (x < 1.0 ? 0.3 * x + std::sin(7 * x) * 0.1 : -0.3 * x * x + 0.9));
+    }
+}
+
+double bruteForce(const Orch& orch, const std::vector<double>& xs, const std::vector<double>& ys, std::size_t& best) {
+    double bestLoss = std::numeric_limits<double>::infinity();
+    for (std::size_t g = 0; g < orch.size(); ++g) {
+        const auto pm = orch.makePiecewise(g);
+        double sse = 0.0;
+        for (std::size_t i = 0; i < xs.size(); ++i) sse += (ys[i] - pm(xs[i])) * (ys[i] - pm(xs[i]));
+        if (sse < bestLoss) {
+            bestLoss = sse;
+            best = g;
+        }
+    }
+    return bestLoss;
+}
+
+}  // namespace
+
+TEST(BranchAndBound, matches_brute_force_on_free_entries) {
+    Orch orch;
+    orch.add(Seg{-3.0, -1.0}, grid());
+    orch.add(Seg{-1.0, 1.0}, grid());
+    orch.add(Seg{1.0, 3.0}, grid());
+
+    std::vector<double> xs, ys;
+    data(xs, ys);
+
+    std::size_t bestGlobal = 0;
+    const double bestLoss = bruteForce(orch, xs, ys, bestGlobal);
+
+    const auto res = aip::search::branchAndBound(orch, std::span<const double>(xs), std::span<const double>(ys),
+                                                 {std::numeric_limits<double>::infinity(), 4});
+    ASSERT_TRUE(res.found);
+    EXPECT_EQ(res.global, bestGlobal);
+    EXPECT_NEAR(res.loss, bestLoss, 1e-9);
+    EXPECT_LT(res.leaves, orch.size());
+}
+
+TEST(BranchAndBound, matches_brute_force_with_constrained_entry) {
+    Orch orch;
+    orch.add(Seg{-3.0, -1.0}, grid());
+    orch.addConstrained(Seg{-1.0, 1.0}, aip::params::UnitGrid<Line>{}, -1.0, 1.0, FitLine{-1.0, 1.0});
+    orch.add(Seg{1.0, 3.0}, grid());
+
+    std::vector<double> xs, ys;
+    data(xs, ys);
+
+    std::size_t bestGlobal = 0;
+    const double bestLoss = bruteForce(orch, xs, ys, bestGlobal);
+
+    const auto res = aip::search::branchAndBound(orch, std::span<const double>(xs), std::span<const double>(ys),
+                                                 {std::numeric_limits<double>::infinity(), 3});
+    ASSERT_TRUE(res.found);
+    EXPECT_EQ(res.global, bestGlobal);
+    EXPECT_NEAR(res.loss, bestLoss, 1e-9);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/continuity.hpp>
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+using Grid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+
+Grid grid() {
+    Grid g;
+    g.get<0>() = {-1.0, 1.0, 0.5};  // 5
+    g.get<1>() = {-1.0, 1.0, 0.25};  // 9
+    return g;
+}
+
+}  // namespace
+
+TEST(Continuity, enumerates_exactly_the_continuous_combinations) {
+    Orch orch;
+    orch.add(Seg{-2.0, 0.0}, grid());
+    orch.add(Seg{0.0, 1.0}, grid());
+    orch.add(Seg{1.0, 2.0}, grid());
+
+    const double tol = 0.3;
+    aip::search::ContinuityPlan<Orch> plan(orch);
+    plan.setBoundary(0, 0.0, tol);
+    plan.setBoundary(1, 1.0, tol);
+    plan.build();
+
+    // эталон: полный перебор с проверкой скачков
+    std::vector<std::size_t> expected;
+    for (std::size_t g = 0; g < orch.size(); ++g) {
+        const auto locals = orch.decodeLocals(g);
+        const auto m0 = orch[0].makeAt(locals[0], {}, 0);
+        const auto m1 = orch[1].makeAt(locals[1], {}, 1);
+        const auto m2 = orch[2].makeAt(locals[2], {}, 2);
+        if (std::abs((*m0)(0.0) - (*m1)(0.0)) <= tol && std::abs((*m1)(1.0) - (*m2)(1.0)) <= tol) {
+            expected.push_back(g);
+        }
+    }
+
+    const auto feasible = plan.feasibleGlobals();
+    EXPECT_EQ(feasible, expected);
+    EXPECT_DOUBLE_EQ(plan.feasibleCount(), static_cast<double>(expected.size()));
+    EXPECT_LT(feasible.size(), orch.size() / 10);
+}
+
+TEST(Continuity, undeclared_boundary_keeps_all_pairs) {
+    Orch orch;
+    orch.add(Seg{-2.0, 0.0}, grid());
+    orch.add(Seg{0.0, 2.0}, grid());
+
+    aip::search::ContinuityPlan<Orch> plan(orch);
+    EXPECT_THROW(plan.setBoundary(1, 0.0, 0.1), std::out_of_range);
+    EXPECT_THROW((void)plan.feasibleCount(), std::logic_error);
+
+    plan.build();
+    EXPECT_DOUBLE_EQ(plan.feasibleCount(), static_cast<double>(orch.size()));
+    EXPECT_EQ(plan.pairCount(0), 0u);
+}
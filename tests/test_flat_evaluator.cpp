@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+
+#include <aip/model/imodel.hpp>
+#include <aip/model/piecewise_model.hpp>
+#include <aip/model/flat_evaluator.hpp>
+
+namespace {
+
+/// Полуинтервал [lo, hi) с трейтами интервала.
+struct HalfOpen {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+/// Отрезок [lo, hi] с трейтами интервала: концы берутся из предиката.
+struct Closed {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x <= hi; }
+};
+
+/// Произвольный предикат без трейтов.
+struct Side {
+    bool left{};
+    constexpr bool operator()(const double& x) const noexcept { return left ? x < 0.0 : x >= 0.0; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    double k{}, b{};
+    Line(double kk, double bb) : k(kk), b(bb) {}
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k * x + b; }
+};
+
+struct Square final : aip::model::IModel<double, double> {
+    double a{};
+    explicit Square(double aa) : a(aa) {}
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return a * x * x; }
+};
+
+/// Тип, не перечисленный в freeze<...>: остаётся виртуальным.
+struct Constant final : aip::model::IModel<double, double> {
+    double c{};
+    explicit Constant(double cc) : c(cc) {}
+    [[nodiscard]] double operator()(const double&) const noexcept override { return c; }
+};
+
+void expectSame(double a, double b) {
+    if (std::isnan(a)) {
+        EXPECT_TRUE(std::isnan(b));
+    } else {
+        EXPECT_DOUBLE_EQ(a, b);
+    }
+}
+
+}  // namespace
+
+template <>
+struct aip::model::IntervalDomainTraits<HalfOpen> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const HalfOpen& d) noexcept { return {d.lo, d.hi}; }
+};
+
+template <>
+struct aip::model::IntervalDomainTraits<Closed> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const Closed& d) noexcept { return {d.lo, d.hi}; }
+};
+
+TEST(FlatEvaluator, matches_piecewise_model_with_overlaps_and_gaps) {
+    aip::model::PiecewiseModel<double, double, HalfOpen> pm;
+    pm.add(HalfOpen{0.0, 1.0}, std::make_shared<Line>(1.0, 0.0));
+    pm.add(HalfOpen{0.5, 2.0}, std::make_shared<Square>(2.0));  // пересечение: выигрывает первый
+    pm.add(HalfOpen{3.0, 4.0}, std::make_shared<Constant>(7.0));  // после пробела [2, 3)
+    pm.add(HalfOpen{-INFINITY, -1.0}, std::make_shared<Line>(-1.0, 1.0));
+
+    const auto flat = aip::model::freeze<Line, Square>(pm);
+    static_assert(decltype(flat)::kHasBreakpoints);
+    EXPECT_EQ(flat.segmentCount(), 4u);
+    EXPECT_EQ(flat.devirtualizedCount(), 3u);
+
+    for (double x = -3.0; x <= 5.0; x += 0.125) expectSame(pm(x), flat(x));
+    for (const double x : {0.0, 0.5, 1.0, 2.0, 3.0, 4.0, -1.0, -1e300, 1e300}) expectSame(pm(x), flat(x));
+    EXPECT_TRUE(std::isnan(flat(std::nan(""))));
+    EXPECT_EQ(flat.segmentOf(0.75), std::optional<std::size_t>(0));
+    EXPECT_EQ(flat.segmentOf(2.5), std::nullopt);
+}
+
+TEST(FlatEvaluator, closed_intervals_resolve_endpoints_from_predicate) {
+    aip::model::PiecewiseModel<double, double, Closed> pm;
+    pm.add(Closed{0.0, 1.0}, std::make_shared<Line>(1.0, 0.0));
+    pm.add(Closed{1.0, 2.0}, std::make_shared<Line>(10.0, 0.0));
+
+    const auto flat = aip::model::freeze<Line>(pm);
+    EXPECT_DOUBLE_EQ(flat(1.0), 1.0);  // общий конец принадлежит первому
+    EXPECT_DOUBLE_EQ(flat(2.0), 20.0);
+    EXPECT_TRUE(std::isnan(flat(2.0000001)));
+}
+
+TEST(FlatEvaluator, predicate_domains_fall_back_to_scan) {
+    aip::model::PiecewiseModel<double, double, Side> pm;
+    pm.add(Side{true}, std::make_shared<Line>(-1.0, 0.0));
+    pm.add(Side{false}, std::make_shared<Square>(1.0));
+
+    const auto flat = aip::model::freeze<Line, Square>(pm);
+    static_assert(!decltype(flat)::kHasBreakpoints);
+    for (double x = -2.0; x <= 2.0; x += 0.25) expectSame(pm(x), flat(x));
+}
+
+TEST(FlatEvaluator, batch_evaluation_matches_scalar) {
+    aip::model::PiecewiseModel<double, double, HalfOpen> pm;
+    pm.add(HalfOpen{0.0, 1.0}, std::make_shared<Line>(2.0, 1.0));
+    pm.add(HalfOpen{1.0, 2.0}, std::make_shared<Constant>(3.0));
+    pm.add(HalfOpen{2.5, 3.0}, std::make_shared<Square>(1.0));
+    const auto flat = aip::model::freeze<Line, Square>(pm);
+
+    std::vector<double> xs;
+    for (int i = 0; i < 200; ++i) xs.push_back(std::fmod(i * 0.37, 3.2));  // вперемешку, с пробелами
+    for (int i = 0; i < 50; ++i) xs.push_back(i * 0.06);                   // отсортированная серия
+    std::vector<double> out(xs.size());
+    flat.evaluate(std::span<const double>(xs), std::span<double>(out));
+    for (std::size_t i = 0; i < xs.size(); ++i) expectSame(pm(xs[i]), out[i]);
+
+    std::vector<double> small(1);
+    EXPECT_THROW(flat.evaluate(std::span<const double>(xs), std::span<double>(small)), std::invalid_argument);
+}
+
+TEST(FlatEvaluator, uniform_and_clustered_breakpoints_match_piecewise_model) {
+    // равномерные точки — поиск через корзины; сгусток у нуля — бинарный поиск
+    for (const bool clustered : {false, true}) {
+        aip::model::PiecewiseModel<double, double, HalfOpen> pm;
+        for (int i = 0; i < 40; ++i) {
+            const double lo = clustered ? std::ldexp(1.0, -i) : i, hi = clustered ? std::ldexp(1.0, 1 - i) : i + 1;
+            pm.add(HalfOpen{lo, hi}, std::make_shared<Line>(i, 1.0));
+        }
+        pm.add(HalfOpen{100.0, 110.0}, std::make_shared<Square>(1.0));
+        const auto flat = aip::model::freeze<Line, Square>(pm);
+
+        std::vector<double> xs;
+        for (int i = 0; i < 40; ++i) {
+            xs.push_back(std::ldexp(1.0, -i));
+            xs.push_back(std::ldexp(1.5, -i));
+        }
+        for (double x = -1.0; x <= 120.0; x += 0.3) xs.push_back(x);
+        std::vector<double> out(xs.size());
+        flat.evaluate(std::span<const double>(xs), std::span<double>(out));
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            expectSame(pm(xs[i]), flat(xs[i]));
+            expectSame(pm(xs[i]), out[i]);
+        }
+    }
+}
+
+TEST(FlatEvaluator, shared_across_threads) {
+    aip::model::PiecewiseModel<double, double, HalfOpen> pm;
+    pm.add(HalfOpen{0.0, 10.0}, std::make_shared<Line>(0.5, 0.0));
+    const auto flat = aip::model::freeze<Line>(pm);
+
+    std::vector<double> sums(4, 0.0);
+    std::vector<std::thread> ts;
+    for (std::size_t t = 0; t < sums.size(); ++t)
+        ts.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) sums[t] += flat(i * 0.01);
+        });
+    for (auto& th : ts) th.join();
+    for (const double s : sums) EXPECT_DOUBLE_EQ(s, sums[0]);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <future>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+#include <aip/search/job_scheduler.hpp>
+
+TEST(JobScheduler, each_job_gets_its_own_top_k) {
+    aip::search::JobScheduler<> sched(4);
+
+    std::vector<std::future<aip::search::JobScheduler<>::Result>> futs;
+    for (std::size_t j = 0; j < 20; ++j) {
+        // минимум задачи j находится в global == j
+        futs.push_back(sched.submit(
+            0, 1000 + j, [j](std::size_t g) { return static_cast<double>(g > j ? g - j : j - g); },
+            aip::search::JobOptions{2, static_cast<unsigned>(1 + j % 3), 0}));
+    }
+
+    for (std::size_t j = 0; j < futs.size(); ++j) {
+        const auto best = futs[j].get();
+        ASSERT_EQ(best.size(), 2u);
+        EXPECT_EQ(best[0].global, j);
+        EXPECT_DOUBLE_EQ(best[0].score, 0.0);
+        EXPECT_DOUBLE_EQ(best[1].score, 1.0);
+    }
+    EXPECT_EQ(sched.pendingJobs(), 0u);
+}
+
+TEST(JobScheduler, exception_fails_only_its_job) {
+    aip::search::JobScheduler<> sched(2);
+
+    auto bad = sched.submit(0, 100, [](std::size_t g) -> double {
+        if (g == 42) throw std::runtime_error("boom");
+        return 0.0;
+    });
+    auto good = sched.submit(10, 20, [](std::size_t g) { return static_cast<double>(g); });
+    auto empty = sched.submit(5, 5, [](std::size_t) { return 0.0; });
+
+    EXPECT_THROW(bad.get(), std::runtime_error);
+    EXPECT_EQ(good.get().front().global, 10u);
+    EXPECT_TRUE(empty.get().empty());
+}
+
+TEST(JobScheduler, priority_two_gets_twice_the_chunks) {
+    aip::search::JobScheduler<> sched(1);
+
+    // единственный поток занят, пока обе задачи не поставлены: они стартуют с одного pass
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    auto blocker = sched.submit(0, 1, [opened](std::size_t) {
+        opened.wait();
+        return 0.0;
+    });
+
+    constexpr std::size_t kChunks = 40;
+    std::mutex m;
+    std::vector<int> order;  // какой задаче выдан очередной чанк (один global на чанк)
+    const auto scorer = [&](int job) {
+        return [&, job](std::size_t) {
+            std::lock_guard<std::mutex> lock(m);
+            order.push_back(job);
+            return 0.0;
+        };
+    };
+    auto high = sched.submit(0, kChunks, scorer(2), aip::search::JobOptions{1, 2, 1});
+    auto low = sched.submit(0, kChunks, scorer(1), aip::search::JobOptions{1, 1, 1});
+    gate.set_value();
+    blocker.get();
+    high.get();
+    low.get();
+
+    ASSERT_EQ(order.size(), 2 * kChunks);
+    // пока обе задачи активны, priority=2 получает вдвое больше чанков
+    const auto highDone = std::find(order.rbegin(), order.rend(), 2).base();
+    const auto lowBefore = std::count(order.begin(), highDone, 1);
+    EXPECT_NEAR(static_cast<double>(lowBefore), kChunks / 2.0, 1.0);
+    EXPECT_EQ(order.back(), 1);
+}
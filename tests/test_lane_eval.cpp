@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <vector>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/model/lane_traits.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+
+namespace {
+struct Always {
+    constexpr bool operator()(const double&) const noexcept { return true; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<float, aip::core::fixed_string{"m"}> m{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"c"}> c{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return m.value * x + c.value; }
+};
+
+struct Parabola final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"a"}> a{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return a.value * x * x + b.value; }
+};
+
+using LineGrid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::m, &Line::c>;
+using ParGrid = aip::params::ParamGrid<Parabola, aip::params::UniformRange, &Parabola::a, &Parabola::b>;
+}  // namespace
+
+template <>
+struct aip::model::LaneTraits<Line> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 4;
+
+    template <class Lanes>
+    static void eval(const Lanes& lanes, std::span<const double> xs, std::span<double> out) noexcept {
+        const auto& [m, c] = lanes;
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            for (std::size_t l = 0; l < width; ++l) out[i * width + l] = m[l] * xs[i] + c[l];
+        }
+    }
+};
+
+template <class Grid>
+static void expect_lanes_match_scalar(const Grid& g) {
+    aip::core::Orchestrator<double, double, Always> orch;
+    orch.add(Always{}, g);
+    const auto& e = orch[0];
+
+    const std::vector<double> xs{-2.0, 0.0, 0.5, 3.0};
+    const std::size_t W = e.laneWidth();
+    ASSERT_GT(W, 0u);
+    std::vector<double> out(xs.size() * W);
+
+    std::size_t seen = 0;
+    for (std::size_t begin = 0; begin < e.size(); begin += W) {
+        const std::size_t count = e.evalLanes(begin, xs, out);
+        ASSERT_EQ(count, std::min(W, e.size() - begin));
+        for (std::size_t l = 0; l < count; ++l, ++seen) {
+            const auto pm = orch.makePiecewise(begin + l);
+            for (std::size_t i = 0; i < xs.size(); ++i) EXPECT_DOUBLE_EQ(out[i * W + l], pm(xs[i]));
+        }
+        // хвостовой блок: лишние дорожки повторяют последнего валидного кандидата
+        for (std::size_t l = count; l < W; ++l) {
+            for (std::size_t i = 0; i < xs.size(); ++i) EXPECT_DOUBLE_EQ(out[i * W + l], out[i * W + count - 1]);
+        }
+    }
+    EXPECT_EQ(seen, e.size());
+    EXPECT_EQ(e.evalLanes(e.size(), xs, out), 0u);
+}
+
+TEST(LaneEval, kernel_path_matches_scalar) {
+    LineGrid g;
+    g.get<0>() = {-1.0f, 1.0f, 0.5f};  // 5
+    g.get<1>() = {0.0, 1.0, 0.5};      // 3 -> 15 кандидатов, хвост в последнем блоке
+    expect_lanes_match_scalar(g);
+}
+
+TEST(LaneEval, scalar_fallback_without_traits) {
+    ParGrid g;
+    g.get<0>() = {0.0, 2.0, 1.0};
+    g.get<1>() = {-1.0, 1.0, 1.0};
+    expect_lanes_match_scalar(g);
+}
+
+TEST(LaneEval, grid_lanes_duplicate_last_candidate_in_tail) {
+    LineGrid g;
+    g.get<0>() = {0.0f, 1.0f, 1.0f};  // 2
+    g.get<1>() = {5.0, 5.0, 1.0};     // 1
+
+    LineGrid::Lanes<4> lanes{};
+    EXPECT_EQ(g.lanesAt<4>(1, lanes), 1u);
+    EXPECT_FLOAT_EQ(std::get<0>(lanes)[0], 1.0f);
+    EXPECT_FLOAT_EQ(std::get<0>(lanes)[3], 1.0f);
+    EXPECT_DOUBLE_EQ(std::get<1>(lanes)[3], 5.0);
+}
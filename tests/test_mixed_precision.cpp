@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <aip/search/top_k.hpp>
+#include <aip/search/mixed_precision.hpp>
+
+namespace {
+
+double exactLoss(std::size_t g) {
+    // неотрицательная "шумная" функция потерь
+    const double x = static_cast<double>(g);
+    return 1.0 + std::sin(x * 0.37) * std::sin(x * 0.11) + 1e-6 * x;
+}
+
+std::vector<aip::search::Scored<double>> bruteForce(std::size_t total, std::size_t k) {
+    aip::search::TopK<double> top(k);
+    for (std::size_t g = 0; g < total; ++g) top.push(g, exactLoss(g));
+    return top.sorted();
+}
+
+}  // namespace
+
+TEST(MixedPrecision, float_screening_matches_full_precision) {
+    const std::size_t total = 5000;
+    auto coarse = [](std::size_t g) { return static_cast<float>(exactLoss(g)); };
+
+    aip::search::ScreeningOptions opt;
+    opt.topK = 10;
+    opt.oversample = 4;
+    opt.relTolerance = 1e-6;  // float: ~6e-8 относительная погрешность
+    opt.threadCount = 4;
+
+    const auto res = aip::search::screenAndRescore(0, total, coarse, exactLoss, opt);
+
+    EXPECT_EQ(res.best, bruteForce(total, 10));
+    EXPECT_EQ(res.screened, total);
+    EXPECT_LT(res.rescored, total / 10);
+}
+
+TEST(MixedPrecision, widens_when_coarse_error_exceeds_margin) {
+    const std::size_t total = 2000;
+    // грубая оценка с заметной ошибкой: +-5%
+    auto coarse = [](std::size_t g) {
+        const double e = exactLoss(g);
+        return static_cast<float>(e * (1.0 + 0.05 * std::cos(static_cast<double>(g))));
+    };
+
+    aip::search::ScreeningOptions opt;
+    opt.topK = 5;
+    opt.oversample = 1;
+    opt.relTolerance = 0.06;
+    opt.threadCount = 3;
+
+    const auto res = aip::search::screenAndRescore(0, total, coarse, exactLoss, opt);
+
+    EXPECT_TRUE(res.widened);
+    EXPECT_EQ(res.best, bruteForce(total, 5));
+}
+
+TEST(MixedPrecision, bound_equal_to_kth_score_still_widens_for_tie_break) {
+    // g1 и g2 равны по грубой оценке, g2 отсеян; его точная оценка равна K-й (g3), но global меньше.
+    const double coarseScores[] = {5.0, 1.0, 1.0, 0.0};
+    const double exactScores[] = {5.0, 1.0, 0.0, 0.0};
+    auto coarse = [&](std::size_t g) { return coarseScores[g]; };
+    auto exact = [&](std::size_t g) { return exactScores[g]; };
+
+    aip::search::ScreeningOptions opt;
+    opt.topK = 1;
+    opt.oversample = 2;
+    opt.relTolerance = 0.0;
+    opt.absTolerance = 1.0;
+    opt.threadCount = 1;
+
+    const auto res = aip::search::screenAndRescore(0, 4, coarse, exact, opt);
+
+    EXPECT_TRUE(res.widened);
+    ASSERT_EQ(res.best.size(), 1u);
+    EXPECT_EQ(res.best[0].global, 2u);
+    EXPECT_DOUBLE_EQ(res.best[0].score, 0.0);
+}
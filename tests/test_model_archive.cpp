@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <filesystem>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/unit_grid.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/core/model_archive.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/uniform_range.hpp>
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+// Неименованные поля сохраняются по позиции, целое — через double.
+struct Step final : aip::model::IModel<double, double> {
+    double level{};
+    int sign{1};
+
+    [[nodiscard]] double operator()(const double&) const noexcept override { return sign * level; }
+};
+
+struct FitLine {
+    double xL{}, xR{};
+    void operator()(Line& l, const double& yL, const double& yR) const noexcept {
+        l.k = (yR - yL) / (xR - xL);
+        l.b = yL - l.k.value * xL;
+    }
+};
+
+using Registry = aip::core::ModelRegistry<double, double>;
+using Archive = aip::core::ModelArchive<double, double, Seg>;
+using PM = aip::model::PiecewiseModel<double, double, Seg>;
+using LineGrid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+
+Registry registry() {
+    Registry r;
+    r.add<Line, &Line::k, &Line::b>("line");
+    r.add<Step, &Step::level, &Step::sign>("step");
+    return r;
+}
+
+std::shared_ptr<const Line> line(double k, double b) {
+    auto l = std::make_shared<Line>();
+    l->k = k;
+    l->b = b;
+    return l;
+}
+
+struct TempFile {
+    std::filesystem::path path;
+    explicit TempFile(const std::string& name) : path(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove(path);
+    }
+    ~TempFile() { std::filesystem::remove(path); }
+};
+
+}  // namespace
+
+TEST(ModelArchive, round_trip_restores_models_and_domains) {
+    TempFile tmp("aip_model_archive_roundtrip.bin");
+    const auto reg = registry();
+
+    auto step = std::make_shared<Step>();
+    step->level = 2.5;
+    step->sign = -1;
+
+    PM pm;
+    pm.add(Seg{0.0, 1.0}, line(2.0, 1.0));
+    pm.add(Seg{1.0, 2.0}, step);
+    pm.add(Seg{2.0, 3.0}, line(-1.0, 0.5));
+    Archive::write(pm, reg, tmp.path);
+
+    const Archive archive(tmp.path);
+    ASSERT_EQ(archive.segmentCount(), 3u);
+    EXPECT_EQ(archive.tag(0), "line");
+    EXPECT_EQ(archive.tag(1), "step");
+    EXPECT_DOUBLE_EQ(archive.domain(2).lo, 2.0);
+    ASSERT_EQ(archive.paramCount(0), 2u);
+    EXPECT_EQ(archive.param(0, 0).label, "k");
+    EXPECT_DOUBLE_EQ(archive.param(0, 0).value, 2.0);
+    EXPECT_EQ(archive.param(1, 1).label, "");
+    EXPECT_DOUBLE_EQ(archive.param(1, 1).value, -1.0);
+
+    const PM loaded = archive.load(reg);
+    ASSERT_EQ(loaded.segmentCount(), 3u);
+    for (double x : {0.0, 0.25, 0.99, 1.0, 1.5, 2.0, 2.75}) EXPECT_DOUBLE_EQ(loaded(x), pm(x)) << x;
+    EXPECT_FALSE(loaded.evaluate(3.5).has_value());
+}
+
+TEST(ModelArchive, saves_orchestrator_choice_including_constrained_segment) {
+    TempFile tmp("aip_model_archive_orch.bin");
+    const auto reg = registry();
+
+    LineGrid g;
+    g.get<0>() = {-1.0, 1.0, 0.5};
+    g.get<1>() = {0.0, 1.0, 0.5};
+
+    aip::core::Orchestrator<double, double, Seg> orch;
+    orch.add(Seg{0.0, 1.0}, g);
+    orch.addConstrained(Seg{1.0, 2.0}, aip::params::UnitGrid<Line>{}, 1.0, 2.0, FitLine{1.0, 2.0});
+    orch.add(Seg{2.0, 3.0}, g);
+
+    const std::size_t global = orch.size() / 2 + 3;
+    const PM pm = orch.makePiecewise(global);
+    Archive::write(pm, reg, tmp.path);
+
+    // Архив не зависит от оркестратора: загрузка без него даёт ту же модель.
+    const PM loaded = Archive(tmp.path).load(reg);
+    for (double x = 0.0; x < 3.0; x += 0.125) EXPECT_DOUBLE_EQ(loaded(x), pm(x)) << x;
+}
+
+TEST(ModelArchive, rewrite_replaces_file_and_keeps_open_archive_valid) {
+    TempFile tmp("aip_model_archive_rewrite.bin");
+    const auto reg = registry();
+
+    PM a;
+    a.add(Seg{0.0, 1.0}, line(1.0, 0.0));
+    Archive::write(a, reg, tmp.path);
+    const Archive old(tmp.path);
+
+    PM b;
+    b.add(Seg{0.0, 1.0}, line(3.0, 0.0));
+    b.add(Seg{1.0, 2.0}, line(0.0, 1.0));
+    Archive::write(b, reg, tmp.path);
+
+    EXPECT_EQ(old.segmentCount(), 1u);
+    EXPECT_DOUBLE_EQ(old.load(reg)(0.5), 0.5);
+    EXPECT_DOUBLE_EQ(Archive(tmp.path).load(reg)(0.5), 1.5);
+    EXPECT_FALSE(std::filesystem::exists(tmp.path.string() + ".tmp"));
+}
+
+TEST(ModelArchive, write_rejects_unregistered_type) {
+    TempFile tmp("aip_model_archive_unregistered.bin");
+    Registry reg;
+    reg.add<Step, &Step::level, &Step::sign>("step");
+
+    PM pm;
+    pm.add(Seg{0.0, 1.0}, line(1.0, 0.0));
+    EXPECT_THROW(Archive::write(pm, reg, tmp.path), std::invalid_argument);
+}
+
+TEST(ModelArchive, load_rejects_unknown_tag_and_changed_fields) {
+    TempFile tmp("aip_model_archive_mismatch.bin");
+    PM pm;
+    pm.add(Seg{0.0, 1.0}, line(1.0, 0.0));
+    Archive::write(pm, registry(), tmp.path);
+    const Archive archive(tmp.path);
+
+    Registry other;
+    other.add<Step, &Step::level, &Step::sign>("step");
+    EXPECT_THROW((void)archive.load(other), std::runtime_error);
+
+    Registry narrower;
+    narrower.add<Line, &Line::k>("line");
+    EXPECT_THROW((void)archive.load(narrower), std::runtime_error);
+
+    Registry reordered;
+    reordered.add<Line, &Line::b, &Line::k>("line");
+    EXPECT_DOUBLE_EQ(archive.load(reordered)(0.5), 0.5);
+}
+
+TEST(ModelArchive, open_rejects_foreign_or_truncated_files) {
+    TempFile tmp("aip_model_archive_bad.bin");
+    std::ofstream(tmp.path, std::ios::binary) << "definitely not an archive, but long enough to have a header";
+    EXPECT_THROW(Archive{tmp.path}, std::runtime_error);
+
+    PM pm;
+    pm.add(Seg{0.0, 1.0}, line(1.0, 0.0));
+    Archive::write(pm, registry(), tmp.path);
+    std::filesystem::resize_file(tmp.path, std::filesystem::file_size(tmp.path) - 1);
+    EXPECT_THROW(Archive{tmp.path}, std::runtime_error);
+
+    // Другой тип домена — другой отпечаток типов.
+    Archive::write(pm, registry(), tmp.path);
+    struct OtherSeg {
+        double lo{}, hi{};
+        constexpr bool operator()(const double& x) const noexcept { return x > lo && x <= hi; }
+    };
+    using OtherArchive = aip::core::ModelArchive<double, double, OtherSeg>;
+    EXPECT_THROW(OtherArchive{tmp.path}, std::runtime_error);
+}
+
+TEST(ModelArchive, open_rejects_counts_that_overflow_the_file_size) {
+    TempFile tmp("aip_model_archive_overflow.bin");
+    PM pm;
+    pm.add(Seg{0.0, 1.0}, line(1.0, 0.0));
+    Archive::write(pm, registry(), tmp.path);
+
+    // Заголовок: paramCount по смещению 36, stringBytes — 40; paramCount первого сегмента — 68.
+    // Лишний параметр (запись 16 байт) "оплачен" переполнением stringBytes: сумма размеров по модулю
+    // 2^64 не меняется, а пул строк с границей ~2^64 пропустил бы любые смещения.
+    const auto read = [&](std::streamoff at, auto v) {
+        std::ifstream(tmp.path, std::ios::binary).seekg(at).read(reinterpret_cast<char*>(&v), sizeof(v));
+        return v;
+    };
+    const auto patch = [&](std::streamoff at, const auto& v) {
+        std::fstream f(tmp.path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(at);
+        f.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    };
+    patch(36, static_cast<std::uint32_t>(read(36, std::uint32_t{}) + 1));
+    patch(68, static_cast<std::uint32_t>(read(68, std::uint32_t{}) + 1));
+    patch(40, static_cast<std::uint64_t>(read(40, std::uint64_t{}) - 16));
+    EXPECT_THROW(Archive{tmp.path}, std::runtime_error);
+
+    Archive::write(pm, registry(), tmp.path);
+    patch(40, std::uint64_t{1} << 40);
+    EXPECT_THROW(Archive{tmp.path}, std::runtime_error);
+}
+
+TEST(ModelRegistry, rejects_duplicate_tags_and_types) {
+    Registry reg;
+    reg.add<Line, &Line::k, &Line::b>("line");
+    EXPECT_THROW((reg.add<Step, &Step::level>("line")), std::invalid_argument);
+    EXPECT_THROW((reg.add<Line, &Line::k>("line2")), std::invalid_argument);
+    EXPECT_THROW((reg.add<Step, &Step::level>("")), std::invalid_argument);
+    EXPECT_EQ(reg.size(), 1u);
+}
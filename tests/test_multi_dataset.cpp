@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/multi_dataset.hpp>
+
+namespace {
+struct Always {
+    constexpr bool operator()(const double&) const noexcept { return true; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+using Grid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+}  // namespace
+
+TEST(MultiDataset, finds_best_candidate_per_dataset) {
+    aip::core::Orchestrator<double, double, Always> orch;
+    Grid g;
+    g.get<0>() = {-2.0, 2.0, 1.0};  // k: 5 values
+    g.get<1>() = {0.0, 3.0, 1.0};   // b: 4 values
+    orch.add(Always{}, g);
+
+    const std::vector<double> xs{-1.0, 0.0, 0.5, 2.0};
+
+    // датасет d порождён линией (k_d, b_d)
+    const double ks[] = {-2.0, 1.0, 2.0};
+    const double bs[] = {3.0, 0.0, 1.0};
+    aip::search::ObservationMatrix<double> obs(xs.size(), 3);
+    for (std::size_t d = 0; d < 3; ++d) {
+        for (std::size_t i = 0; i < xs.size(); ++i) obs(i, d) = ks[d] * xs[i] + bs[d];
+    }
+
+    const auto res = aip::search::searchMultiDataset(orch, std::span<const double>(xs), obs, {2, 3});
+    ASSERT_EQ(res.size(), 3u);
+
+    for (std::size_t d = 0; d < 3; ++d) {
+        ASSERT_EQ(res[d].size(), 2u);
+        EXPECT_DOUBLE_EQ(res[d][0].score, 0.0);
+
+        // global = local (одна entry), local = ik + 5 * ib
+        const std::size_t ik = static_cast<std::size_t>(ks[d] + 2.0);
+        const std::size_t ib = static_cast<std::size_t>(bs[d]);
+        EXPECT_EQ(res[d][0].global, ik + 5 * ib);
+        EXPECT_GT(res[d][1].score, 0.0);
+    }
+}
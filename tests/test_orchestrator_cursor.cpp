@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+
+#include <aip/model/imodel.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/search/enumeration_strategy.hpp>
+#include <aip/search/reverse_enumeration_strategy.hpp>
+
+namespace {
+
+struct Always {
+    constexpr bool operator()(const double&) const noexcept { return true; }
+};
+
+struct M final : aip::model::IModel<double, double> {
+    double a{};
+    double b{};
+
+    [[nodiscard]] double operator()(const double&) const noexcept override { return a + 10.0 * b; }
+};
+
+using Grid = aip::params::ParamGrid<M, aip::params::UniformRange, &M::a, &M::b>;
+
+/// Без skip(): сначала чётные локальные индексы, затем нечётные.
+template <std::size_t N>
+class EvensFirstStrategy {
+   public:
+    using index_type = std::array<std::size_t, N>;
+
+    void reset(const aip::search::IndexSpace<N>& s) noexcept {
+        space_ = &s;
+        step_ = 0;
+    }
+
+    [[nodiscard]] std::optional<index_type> next() noexcept {
+        const std::size_t total = space_->total;
+        if (step_ >= total) return std::nullopt;
+        const std::size_t evens = (total + 1) / 2;
+        std::size_t local = step_ < evens ? 2 * step_ : 2 * (step_ - evens) + 1;
+        ++step_;
+
+        index_type idx{};
+        for (std::size_t i = 0; i < N; ++i) {
+            idx[i] = local % space_->bases[i];
+            local /= space_->bases[i];
+        }
+        return idx;
+    }
+
+   private:
+    const aip::search::IndexSpace<N>* space_{nullptr};
+    std::size_t step_{0};
+};
+
+/// Без skip() и не полная: только первая половина локальных индексов.
+template <std::size_t N>
+class HalfStrategy {
+   public:
+    using index_type = std::array<std::size_t, N>;
+
+    void reset(const aip::search::IndexSpace<N>& s) noexcept {
+        inner_.reset(s);
+        left_ = s.total / 2;
+    }
+
+    [[nodiscard]] std::optional<index_type> next() noexcept {
+        if (left_ == 0) return std::nullopt;
+        --left_;
+        return inner_.next();
+    }
+
+   private:
+    aip::search::EnumerationStrategy<N> inner_;
+    std::size_t left_{0};
+};
+
+static_assert(aip::search::SkippableStrategy<aip::search::EnumerationStrategy<2>, 2>);
+static_assert(aip::search::SkippableStrategy<aip::search::ReverseEnumerationStrategy<2>, 2>);
+static_assert(!aip::search::SkippableStrategy<EvensFirstStrategy<2>, 2>);
+
+Grid grid(double aMax, double bMax) {
+    Grid g;
+    g.get<0>() = {0.0, aMax, 1.0};
+    g.get<1>() = {0.0, bMax, 1.0};
+    return g;
+}
+
+template <class Orch>
+void build(Orch& orch) {
+    orch.add(Always{}, grid(2.0, 1.0));  // 3 x 2
+    orch.add(Always{}, grid(1.0, 2.0));  // 2 x 3
+    orch.add(Always{}, grid(4.0, 0.0));  // 5 x 1
+}
+
+template <class Orch>
+std::vector<std::size_t> sequential(Orch& orch) {
+    std::vector<std::size_t> out;
+    orch.reset();
+    while (auto g = orch.nextGlobal()) out.push_back(*g);
+    return out;
+}
+
+template <class Orch>
+std::vector<std::size_t> concatenated(const Orch& orch, std::size_t k) {
+    std::vector<std::size_t> out;
+    for (auto& c : orch.split(k))
+        while (auto g = c.nextGlobal()) out.push_back(*g);
+    return out;
+}
+
+}  // namespace
+
+TEST(EnumerationStrategy, skip_matches_repeated_next) {
+    const auto space = aip::search::make_index_space(grid(2.0, 3.0));
+    for (std::size_t n = 0; n <= space.total; ++n) {
+        for (std::size_t warm = 0; warm < 3; ++warm) {
+            aip::search::EnumerationStrategy<2> a, b;
+            a.reset(space);
+            b.reset(space);
+            for (std::size_t i = 0; i < warm; ++i) {
+                (void)a.next();
+                (void)b.next();
+            }
+            a.skip(n);
+            for (std::size_t i = 0; i < n; ++i) (void)b.next();
+            EXPECT_EQ(a.next(), b.next()) << "n=" << n << " warm=" << warm;
+        }
+    }
+}
+
+TEST(ReverseEnumerationStrategy, skip_matches_repeated_next) {
+    const auto space = aip::search::make_index_space(grid(2.0, 3.0));
+    for (std::size_t n = 0; n <= space.total; ++n) {
+        aip::search::ReverseEnumerationStrategy<2> a, b;
+        a.reset(space);
+        b.reset(space);
+        (void)a.next();
+        (void)b.next();
+        a.skip(n);
+        for (std::size_t i = 0; i < n; ++i) (void)b.next();
+        EXPECT_EQ(a.next(), b.next()) << "n=" << n;
+    }
+}
+
+TEST(OrchestratorCursor, split_concatenates_to_sequential_order) {
+    aip::core::Orchestrator<double, double, Always> fwd;
+    aip::core::Orchestrator<double, double, Always, aip::search::ReverseEnumerationStrategy> rev;
+    aip::core::Orchestrator<double, double, Always, EvensFirstStrategy> evens;
+    build(fwd);
+    build(rev);
+    build(evens);
+
+    const auto f = sequential(fwd);
+    const auto r = sequential(rev);
+    const auto e = sequential(evens);
+    ASSERT_EQ(f.size(), fwd.size());
+    for (std::size_t k : {1u, 2u, 3u, 7u, 179u, 200u}) {
+        EXPECT_EQ(concatenated(fwd, k), f) << k;
+        EXPECT_EQ(concatenated(rev, k), r) << k;
+        EXPECT_EQ(concatenated(evens, k), e) << k;
+    }
+}
+
+TEST(OrchestratorCursor, partial_strategies_use_their_stream_length) {
+    aip::core::Orchestrator<double, double, Always, HalfStrategy> orch;
+    build(orch);
+
+    EXPECT_EQ(orch.streamSize(), 3u * 3u * 2u);
+    const auto seq = sequential(orch);
+    EXPECT_EQ(seq.size(), orch.streamSize());
+    EXPECT_EQ(concatenated(orch, 4), seq);
+}
+
+TEST(OrchestratorCursor, cursor_range_and_models) {
+    aip::core::Orchestrator<double, double, Always> orch;
+    build(orch);
+    const auto seq = sequential(orch);
+
+    auto c = orch.cursor(10, 15);
+    EXPECT_EQ(c.position(), 10u);
+    EXPECT_EQ(c.remaining(), 5u);
+    for (std::size_t s = 10; s < 15; ++s) {
+        auto pm = c.next();
+        ASSERT_TRUE(pm.has_value());
+        EXPECT_DOUBLE_EQ((*pm)(0.0), orch.makePiecewise(seq[s])(0.0));
+    }
+    EXPECT_FALSE(c.next().has_value());
+
+    auto tail = orch.cursor(orch.size() - 1, orch.size() + 10);
+    EXPECT_EQ(tail.remaining(), 1u);
+    EXPECT_EQ(tail.nextGlobal(), seq.back());
+    EXPECT_FALSE(tail.nextGlobal().has_value());
+
+    EXPECT_THROW((void)orch.split(0), std::invalid_argument);
+}
+
+TEST(OrchestratorCursor, cursors_run_concurrently_and_leave_orchestrator_state_alone) {
+    aip::core::Orchestrator<double, double, Always, aip::search::ReverseEnumerationStrategy> orch;
+    build(orch);
+    const auto seq = sequential(orch);
+
+    orch.reset();
+    const auto first = orch.nextGlobal();
+
+    auto parts = orch.split(4);
+    std::vector<std::future<std::vector<std::size_t>>> futs;
+    for (auto& p : parts) {
+        futs.push_back(std::async(std::launch::async, [&p] {
+            std::vector<std::size_t> out;
+            while (auto g = p.nextGlobal()) out.push_back(*g);
+            return out;
+        }));
+    }
+    std::vector<std::size_t> all;
+    for (auto& f : futs) {
+        const auto part = f.get();
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    EXPECT_EQ(all, seq);
+
+    // stateful-перебор оркестратора продолжается с того же места
+    EXPECT_EQ(first, seq[0]);
+    EXPECT_EQ(orch.nextGlobal(), seq[1]);
+}
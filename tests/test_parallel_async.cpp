@@ -22,3 +22,49 @@ TEST(ParallelAsync, preserves_order_and_reports_progress) {
 
     EXPECT_EQ(lastDone.load(std::memory_order_relaxed), 100u);
 }
+
+TEST(ParallelAsync, chunks_cover_range_in_order) {
+    auto out = aip::search::parallelForChunksAsync(
+        5, 105,
+        [](std::size_t b, std::size_t e) {
+            std::size_t sum = 0;
+            for (std::size_t g = b; g < e; ++g) sum += g;
+            return std::make_pair(b, sum);
+        },
+        4);
+
+    ASSERT_EQ(out.size(), 4u);
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        if (i > 0) {
+            EXPECT_LT(out[i - 1].first, out[i].first);
+        }
+        sum += out[i].second;
+    }
+    EXPECT_EQ(out.front().first, 5u);
+    EXPECT_EQ(sum, (5u + 104u) * 100u / 2u);
+}
+
+TEST(ParallelAsync, dynamic_policy_covers_range_with_fixed_chunks) {
+    const auto policy = aip::search::ChunkPolicy::dynamicChunks(7);
+
+    auto out = aip::search::parallelForIndicesAsync(
+        0, 100, [](std::size_t g) { return static_cast<int>(g) * 3; }, policy, 4);
+    ASSERT_EQ(out.size(), 100u);
+    for (std::size_t i = 0; i < out.size(); ++i) EXPECT_EQ(out[i], static_cast<int>(i) * 3);
+
+    auto chunks = aip::search::parallelForChunksAsync(
+        10, 110, [](std::size_t b, std::size_t e) { return std::make_pair(b, e); }, policy, 3);
+    ASSERT_EQ(chunks.size(), 15u);  // ceil(100 / 7)
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        EXPECT_EQ(chunks[i].first, 10 + 7 * i);
+        EXPECT_EQ(chunks[i].second, std::min<std::size_t>(110, 10 + 7 * (i + 1)));
+    }
+}
+
+TEST(ParallelAsync, static_policy_with_small_chunks_round_robins) {
+    auto chunks = aip::search::parallelForChunksAsync(
+        0, 10, [](std::size_t b, std::size_t e) { return e - b; }, aip::search::ChunkPolicy::staticChunks(3), 2);
+    ASSERT_EQ(chunks.size(), 4u);
+    EXPECT_EQ(chunks.back(), 1u);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <aip/params/param_grid.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/params/param_columns.hpp>
+#include <aip/search/index_unrank.hpp>
+#include <aip/search/index_space_from_grid.hpp>
+
+using namespace aip::params;
+
+namespace {
+
+struct M {
+    double k;
+    ControlParam<int, "b"> b;
+    ControlParam<float, "c"> c;
+};
+
+using Grid = ParamGrid<M, UniformRange, &M::k, &M::b, &M::c>;
+
+Grid makeGrid() {
+    Grid g;
+    g.get<0>() = {0.0, 2.0, 1.0};     // 3
+    g.get<1>() = {1, 2, 1};           // 2
+    g.get<2>() = {0.5f, 2.0f, 0.5f};  // 4
+    return g;
+}
+
+}  // namespace
+
+TEST(ParamColumns, whole_grid_matches_unranked_indices) {
+    const Grid g = makeGrid();
+    const auto cols = materializeParams(g);
+    ASSERT_EQ(cols.size(), g.size());
+
+    const auto space = aip::search::make_index_space(g);
+    for (std::size_t local = 0; local < g.size(); ++local) {
+        const auto idx = aip::search::linear_to_multi_index(space, local);
+        EXPECT_DOUBLE_EQ(cols.column<0>()[local], g.get<0>()[idx[0]]);
+        EXPECT_EQ(cols.column<1>()[local], g.get<1>()[idx[1]]);
+        EXPECT_FLOAT_EQ(cols.column<2>()[local], g.get<2>()[idx[2]]);
+    }
+
+    EXPECT_EQ(cols.label(0), "");
+    EXPECT_EQ(cols.label(1), "b");
+    EXPECT_EQ(cols.label(2), "c");
+}
+
+TEST(ParamColumns, blocks_concatenate_to_whole_grid) {
+    const Grid g = makeGrid();
+    const auto whole = materializeParams(g);
+
+    std::vector<int> bs;
+    std::size_t expectedBegin = 0;
+    forEachParamBlock(g, 5, [&](const ParamColumns<Grid>& block) {
+        EXPECT_EQ(block.localBegin(), expectedBegin);
+        EXPECT_LE(block.size(), 5u);
+        for (auto v : block.column<1>()) bs.push_back(v);
+        expectedBegin += block.size();
+    });
+
+    ASSERT_EQ(bs.size(), g.size());
+    for (std::size_t i = 0; i < bs.size(); ++i) EXPECT_EQ(bs[i], whole.column<1>()[i]);
+}
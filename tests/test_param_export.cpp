@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/unit_grid.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/core/param_field.hpp>
+#include <aip/search/param_export.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/profile/alloc_tracking.hpp>
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+struct Steps final : aip::model::IModel<double, double> {
+    int n{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"h"}> h{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return std::floor(x * n) * h.value; }
+};
+
+struct FitLine {
+    double xL{}, xR{};
+    void operator()(Line& l, const double& yL, const double& yR) const noexcept {
+        l.k = (yR - yL) / (xR - xL);
+        l.b = yL - l.k.value * xL;
+    }
+};
+
+template <typename T>
+struct ListRange {
+    using value_type = T;
+    std::vector<T> values;
+    [[nodiscard]] std::size_t size() const noexcept { return values.size(); }
+    [[nodiscard]] const T& operator[](std::size_t i) const { return values[i]; }
+};
+
+struct Tagged final : aip::model::IModel<double, double> {
+    std::string tag;
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return x; }
+};
+
+using LineGrid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+using StepsGrid = aip::params::ParamGrid<Steps, aip::params::UniformRange, &Steps::n, &Steps::h>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+using aip::core::ParamField;
+using aip::search::Scored;
+
+void build(Orch& orch) {
+    LineGrid lg;
+    lg.get<0>() = {-1.0, 1.0, 0.5};  // 5
+    lg.get<1>() = {0.0, 0.5, 0.25};  // 3
+    StepsGrid sg;
+    sg.get<0>() = {1, 4, 1};        // 4
+    sg.get<1>() = {1.0, 3.0, 1.0};  // 3
+
+    orch.add(Seg{0.0, 1.0}, lg);
+    orch.addConstrained(Seg{1.0, 2.0}, aip::params::UnitGrid<Line>{}, 1.0, 2.0, FitLine{1.0, 2.0});
+    orch.add(Seg{2.0, 3.0}, sg);
+}
+
+}  // namespace
+
+TEST(ParamField, values_keep_integer_types_and_format_with_to_chars) {
+    EXPECT_EQ(aip::core::toParamValue(3).index(), 1u);
+    EXPECT_EQ(aip::core::toParamValue(std::size_t{3}).index(), 2u);
+    EXPECT_EQ(aip::core::toParamValue(0.25f).index(), 3u);
+    EXPECT_EQ(aip::core::toParamValue(std::string("x")).index(), 0u);
+    EXPECT_TRUE(std::isnan(aip::core::asDouble(aip::core::ParamValue{})));
+
+    char buf[32];
+    const auto put = [&](const aip::core::ParamValue& v) {
+        return std::string(buf, aip::core::toChars(buf, buf + sizeof(buf), v).ptr);
+    };
+    EXPECT_EQ(put(std::int64_t{-7}), "-7");
+    EXPECT_EQ(put(0.1), "0.1");
+    EXPECT_EQ(put(aip::core::ParamValue{}), "");
+}
+
+TEST(ParamField, params_at_matches_string_visitor) {
+    Orch orch;
+    build(orch);
+
+    ASSERT_EQ(orch[0].paramCount(), 2u);
+    ASSERT_EQ(orch[1].paramCount(), 0u);
+    ASSERT_EQ(orch[2].paramCount(), 2u);
+
+    std::vector<ParamField> fields(2);
+    for (std::size_t local = 0; local < orch[2].size(); ++local) {
+        ASSERT_EQ(orch[2].paramsAt(local, fields), 2u);
+        std::vector<std::string> text;
+        orch[2].forEachParamAt(local, [&](std::string_view, std::string v) { text.push_back(std::move(v)); });
+
+        EXPECT_EQ(fields[0].label, "");
+        EXPECT_EQ(fields[0].index, 0u);
+        ASSERT_TRUE(std::holds_alternative<std::int64_t>(fields[0].value));
+        EXPECT_EQ(std::to_string(std::get<std::int64_t>(fields[0].value)), text[0]);
+        EXPECT_EQ(fields[1].label, "h");
+        EXPECT_NEAR(aip::core::asDouble(fields[1].value), std::stod(text[1]), 1e-6);
+    }
+
+    // Буфер короче paramCount() — пишется только его начало.
+    EXPECT_EQ(orch[0].paramsAt(6, std::span<ParamField>(fields).first(1)), 1u);
+    EXPECT_EQ(fields[0].label, "k");
+    EXPECT_DOUBLE_EQ(aip::core::asDouble(fields[0].value), -0.5);  // local 6 -> idx {1, 1}
+}
+
+TEST(ParamField, params_at_does_not_allocate) {
+    if (!aip::profile::allocationHooksInstalled()) GTEST_SKIP() << "allocation hooks are not installed";
+    Orch orch;
+    build(orch);
+
+    std::vector<ParamField> fields(2);
+    aip::profile::AllocScope scope;
+    for (std::size_t local = 0; local < orch[0].size(); ++local) (void)orch[0].paramsAt(local, fields);
+    EXPECT_EQ(scope.allocations(), 0u);
+}
+
+TEST(ParamExport, table_has_one_column_per_grid_parameter) {
+    Orch orch;
+    build(orch);
+    const std::vector<Scored<double>> top = {{orch.encodeLocals({6, 0, 5}), 0.5}, {orch.encodeLocals({0, 0, 11}), 1.5}};
+
+    const auto t = aip::search::exportParamTable(orch, top);
+    ASSERT_EQ(t.rows(), 2u);
+    EXPECT_EQ(t.names, (std::vector<std::string>{"s0.k", "s0.b", "s2.p0", "s2.h"}));
+    EXPECT_EQ(t.globals[1], top[1].global);
+    EXPECT_DOUBLE_EQ(t.scores[0], 0.5);
+    EXPECT_DOUBLE_EQ(t.column("s0.k")[0], -0.5);
+    EXPECT_DOUBLE_EQ(t.column("s0.b")[0], 0.25);
+    EXPECT_DOUBLE_EQ(t.column("s2.p0")[0], 2.0);  // local 5 -> idx {1, 1}
+    EXPECT_DOUBLE_EQ(t.column("s2.h")[1], 3.0);  // local 11 -> idx {3, 2}
+    EXPECT_TRUE(t.column("missing").empty());
+}
+
+TEST(ParamExport, csv_is_identical_for_any_thread_count) {
+    Orch orch;
+    build(orch);
+
+    std::vector<Scored<double>> rows;
+    for (std::size_t g = 0; g < orch.size(); g += 3) rows.push_back({g, 0.1 * static_cast<double>(g)});
+
+    std::ostringstream one, many;
+    aip::search::writeParamCsv(one, orch, rows, {',', 7, 1});
+    aip::search::writeParamCsv(many, orch, rows, {',', 7, 4});
+    EXPECT_EQ(one.str(), many.str());
+
+    std::istringstream in(one.str());
+    std::string header, first;
+    std::getline(in, header);
+    std::getline(in, first);
+    EXPECT_EQ(header, "global,score,s0.k,s0.b,s2.p0,s2.h");
+    EXPECT_EQ(first, "0,0,-1,0,1,1");
+
+    std::size_t lines = 2;
+    for (std::string line; std::getline(in, line);) ++lines;
+    EXPECT_EQ(lines, rows.size() + 1);
+}
+
+TEST(ParamExport, csv_quotes_non_numeric_values_per_rfc4180) {
+    aip::params::ParamGrid<Tagged, ListRange, &Tagged::tag> g;
+    g.get<0>() = {{"plain", "a,b", "say \"hi\"", "two\nlines"}};
+    Orch orch;
+    orch.add(Seg{0.0, 1.0}, g);
+
+    const std::vector<Scored<double>> rows = {{0, 0.0}, {1, 0.0}, {2, 0.0}, {3, 0.0}};
+    std::ostringstream os;
+    aip::search::writeParamCsv(os, orch, rows, {',', 2, 2});
+    EXPECT_EQ(os.str(),
+              "global,score,s0.p0\n"
+              "0,0,plain\n"
+              "1,0,\"a,b\"\n"
+              "2,0,\"say \"\"hi\"\"\"\n"
+              "3,0,\"two\nlines\"\n");
+
+    std::ostringstream semi;
+    aip::search::writeParamCsv(semi, orch, std::vector<Scored<double>>{{1, 0.0}}, {';', 2, 1});
+    EXPECT_EQ(semi.str(), "global;score;s0.p0\n1;0;a,b\n");
+}
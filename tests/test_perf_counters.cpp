@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <sstream>
+
+#include <aip/profile/perf_counters.hpp>
+
+namespace {
+
+using aip::profile::Counter;
+using aip::profile::CounterValues;
+using aip::profile::Phase;
+
+double busyWork(int n) {
+    volatile double acc = 0.0;
+    for (int i = 0; i < n; ++i) acc = acc + static_cast<double>(i % 7) * 0.5;
+    return acc;
+}
+
+}  // namespace
+
+TEST(PerfCounters, group_degrades_gracefully_without_counters) {
+    aip::profile::PerfCounterGroup g;
+    const auto before = g.read();
+    busyWork(1'000'000);
+    const auto d = g.read().since(before);
+
+    if (!g.available()) {
+        // контейнер / нет прав: ничего не измеряется, причина объяснена
+        EXPECT_EQ(g.mask(), 0u);
+        EXPECT_EQ(d.mask, 0u);
+        EXPECT_FALSE(g.error().empty());
+        EXPECT_EQ(d.ipc(), 0.0);
+        return;
+    }
+    EXPECT_NE(g.mask(), 0u);
+    if (d.has(Counter::Instructions)) {
+        EXPECT_GT(d[Counter::Instructions], 1'000'000u);
+    }
+}
+
+TEST(PerfCounters, since_uses_common_counters_only) {
+    CounterValues a, b;
+    a.mask = 0b0011;
+    a.values = {1000, 3000, 0, 0};
+    b.mask = 0b0111;
+    b.values = {100, 1000, 5, 0};
+
+    const auto d = a.since(b);
+    EXPECT_EQ(d.mask, 0b0011u);
+    EXPECT_EQ(d[Counter::Cycles], 900u);
+    EXPECT_EQ(d[Counter::Instructions], 2000u);
+    EXPECT_FALSE(d.has(Counter::LlcMisses));
+    EXPECT_NEAR(d.ipc(), 2000.0 / 900.0, 1e-12);
+}
+
+TEST(PerfCounters, registry_aggregates_per_phase_across_threads) {
+    aip::profile::resetPerfStats();
+    CounterValues v;
+    v.mask = 0b1111;
+    v.values = {10, 20, 1, 2};
+
+    std::vector<std::thread> ts;
+    for (int t = 0; t < 3; ++t)
+        ts.emplace_back([&] {
+            for (int i = 0; i < 100; ++i) aip::profile::PerfRegistry::instance().record(Phase::Evaluate, v);
+        });
+    for (auto& t : ts) t.join();
+
+    const auto s = aip::profile::collectPerfStats();
+    EXPECT_EQ(s[Phase::Evaluate].count, 300u);
+    EXPECT_EQ(s[Phase::Evaluate].totals[Counter::Cycles], 3000u);
+    EXPECT_EQ(s[Phase::Evaluate].totals[Counter::BranchMisses], 600u);
+    EXPECT_EQ(s[Phase::Evaluate].totals.mask, 0b1111u);
+    EXPECT_EQ(s[Phase::Decode].count, 0u);
+    EXPECT_GE(s.threads, 3u);
+
+    std::ostringstream os;
+    aip::profile::printPerfStats(os, s);
+    EXPECT_NE(os.str().find("evaluate"), std::string::npos);
+}
+
+TEST(PerfCounters, scoped_phase_respects_mask_and_availability) {
+    aip::profile::resetPerfStats();
+    auto& reg = aip::profile::PerfRegistry::instance();
+    reg.setPhaseMask(1u << static_cast<std::size_t>(Phase::Score));
+
+    std::thread([] {
+        {
+            aip::profile::ScopedPerfPhase off(Phase::Decode);  // не в маске
+            busyWork(1000);
+        }
+        {
+            aip::profile::ScopedPerfPhase on(Phase::Score);
+            busyWork(100'000);
+        }
+    }).join();
+
+    const auto s = aip::profile::collectPerfStats();
+    EXPECT_EQ(s[Phase::Decode].count, 0u);
+    if (aip::profile::threadPerfCounters().available()) {
+        EXPECT_EQ(s[Phase::Score].count, 1u);
+    } else {
+        EXPECT_GE(s.unavailableThreads, 1u);
+    }
+
+    reg.setPhaseMask((1u << static_cast<std::size_t>(Phase::Chunk)) |
+                     (1u << static_cast<std::size_t>(Phase::Evaluate)));
+}
+
+TEST(PerfCounters, exited_threads_fold_into_totals_and_free_their_slots) {
+    aip::profile::resetPerfStats();
+    auto& reg = aip::profile::PerfRegistry::instance();
+    CounterValues v;
+    v.mask = 0b0001;
+    v.values = {5, 0, 0, 0};
+
+    std::thread([&] { reg.record(Phase::Chunk, v); }).join();
+    const std::size_t slots = reg.slotCount();
+    for (int t = 0; t < 31; ++t) std::thread([&] { reg.record(Phase::Chunk, v); }).join();
+    EXPECT_EQ(reg.slotCount(), slots);
+
+    const auto s = aip::profile::collectPerfStats();
+    EXPECT_EQ(s[Phase::Chunk].count, 32u);
+    EXPECT_EQ(s[Phase::Chunk].totals[Counter::Cycles], 160u);
+    EXPECT_EQ(s.threads, 32u);
+}
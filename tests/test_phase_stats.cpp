@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <sstream>
+
+#include <aip/profile/phase_stats.hpp>
+
+namespace {
+
+using aip::profile::Phase;
+
+}  // namespace
+
+TEST(PhaseStats, record_and_collect) {
+    aip::profile::resetPhaseStats();
+    aip::profile::recordPhase(Phase::Decode, 100);
+    aip::profile::recordPhase(Phase::Decode, 300);
+    aip::profile::recordPhase(Phase::Score, 1000);
+
+    const auto s = aip::profile::collectPhaseStats();
+    EXPECT_EQ(s[Phase::Decode].count, 2u);
+    EXPECT_EQ(s[Phase::Decode].totalNanos, 400u);
+    EXPECT_DOUBLE_EQ(s[Phase::Decode].meanNanos(), 200.0);
+    EXPECT_EQ(s[Phase::Score].count, 1u);
+    EXPECT_EQ(s[Phase::Build].count, 0u);
+    EXPECT_GE(s.threads, 1u);
+}
+
+TEST(PhaseStats, reset_clears_counters) {
+    aip::profile::recordPhase(Phase::Evaluate, 50);
+    aip::profile::resetPhaseStats();
+    const auto s = aip::profile::collectPhaseStats();
+    for (const auto& p : s.phases) EXPECT_EQ(p.count, 0u);
+}
+
+TEST(PhaseStats, percentiles_follow_histogram) {
+    aip::profile::resetPhaseStats();
+    for (int i = 0; i < 99; ++i) aip::profile::recordPhase(Phase::Build, 10);  // корзина [8, 16)
+    aip::profile::recordPhase(Phase::Build, 5000);                           // корзина [4096, 8192)
+
+    const auto b = aip::profile::collectPhaseStats()[Phase::Build];
+    EXPECT_EQ(b.percentileNanos(0.5), 15u);
+    EXPECT_EQ(b.percentileNanos(0.98), 15u);
+    EXPECT_EQ(b.percentileNanos(1.0), 8191u);
+}
+
+TEST(PhaseStats, scoped_phase_records_once) {
+    aip::profile::resetPhaseStats();
+    {
+        aip::profile::ScopedPhase scope(Phase::Chunk);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    const auto c = aip::profile::collectPhaseStats()[Phase::Chunk];
+    EXPECT_EQ(c.count, 1u);
+    EXPECT_GE(c.totalNanos, 200'000u);
+}
+
+TEST(PhaseStats, aggregates_across_threads) {
+    aip::profile::resetPhaseStats();
+    std::vector<std::thread> ts;
+    for (int t = 0; t < 4; ++t)
+        ts.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) aip::profile::recordPhase(Phase::Evaluate, 1);
+        });
+    for (auto& t : ts) t.join();
+
+    const auto s = aip::profile::collectPhaseStats();
+    EXPECT_EQ(s[Phase::Evaluate].count, 4000u);
+    EXPECT_EQ(s[Phase::Evaluate].totalNanos, 4000u);
+    EXPECT_GE(s.threads, 4u);
+}
+
+TEST(PhaseStats, print_skips_idle_phases) {
+    aip::profile::resetPhaseStats();
+    aip::profile::recordPhase(Phase::Score, 42);
+    std::ostringstream os;
+    aip::profile::printPhaseStats(os);
+    EXPECT_NE(os.str().find("score"), std::string::npos);
+    EXPECT_EQ(os.str().find("decode"), std::string::npos);
+}
+
+TEST(PhaseStats, exited_threads_fold_into_totals_and_free_their_slots) {
+    aip::profile::resetPhaseStats();
+    auto& registry = aip::profile::Registry::instance();
+    for (int t = 0; t < 64; ++t) std::thread([] { aip::profile::recordPhase(Phase::Decode, 10); }).join();
+    const std::size_t slots = registry.slotCount();
+
+    // Последовательные потоки занимают один и тот же освободившийся слот.
+    for (int t = 0; t < 64; ++t) std::thread([] { aip::profile::recordPhase(Phase::Decode, 10); }).join();
+    EXPECT_EQ(registry.slotCount(), slots);
+
+    const auto s = aip::profile::collectPhaseStats();
+    EXPECT_EQ(s[Phase::Decode].count, 128u);
+    EXPECT_EQ(s[Phase::Decode].totalNanos, 1280u);
+    EXPECT_EQ(s.threads, 128u);
+
+    aip::profile::resetPhaseStats();
+    EXPECT_EQ(aip::profile::collectPhaseStats()[Phase::Decode].count, 0u);
+}
@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <span>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <vector>
+#include <utility>
+#include <stdexcept>
 
 #include <aip/model/imodel.hpp>
 #include <aip/model/piecewise_model.hpp>
@@ -15,6 +19,12 @@ struct Interval {
     }
 };
 
+template <>
+struct aip::model::IntervalDomainTraits<Interval> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const Interval& d) noexcept { return {d.a, d.b}; }
+};
+
 // Простая модель-наследник IModel
 struct LinearModel final : aip::model::IModel<double, double> {
     double k{}, b{};
@@ -58,3 +68,104 @@ TEST(PiecewiseModel, returns_nan_when_no_segment_matches) {
     const double y = pm(10.0);
     EXPECT_TRUE(std::isnan(y));
 }
+
+// Считает пакетные вызовы: evaluateSorted должен звать модель один раз на серию.
+struct CountingModel final : aip::model::IModel<double, double> {
+    double k{};
+    mutable std::size_t batches{0};
+    explicit CountingModel(double kk) : k(kk) {}
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k * x; }
+    void evaluate(std::span<const double> xs, std::span<double> out) const override {
+        ++batches;
+        for (std::size_t i = 0; i < xs.size(); ++i) out[i] = k * xs[i];
+    }
+};
+
+TEST(PiecewiseModel, evaluate_sorted_batches_runs_and_matches_scalar) {
+    aip::model::PiecewiseModel<double, double, Interval> pm;
+    auto m1 = std::make_shared<CountingModel>(1.0);
+    auto m2 = std::make_shared<CountingModel>(10.0);
+    pm.add(Interval{0.0, 1.0}, m1);
+    pm.add(Interval{0.5, 2.0}, m2);  // пересечение и общий конец 1.0 — у первого
+    pm.add(Interval{3.0, 4.0}, m1);  // пробел (2, 3)
+
+    std::vector<double> xs;
+    for (int i = 0; i <= 500; ++i) xs.push_back(-0.5 + 5.0 * i / 500.0);
+    std::vector<double> out(xs.size());
+    pm.evaluateSorted(xs, out);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        const double y = pm(xs[i]);
+        if (std::isnan(y)) {
+            EXPECT_TRUE(std::isnan(out[i])) << xs[i];
+        } else {
+            EXPECT_DOUBLE_EQ(out[i], y) << xs[i];
+        }
+    }
+    // серии: [0, 1], (1, 2], [3, 4] — по одному пакетному вызову
+    EXPECT_EQ(m1->batches, 2u);
+    EXPECT_EQ(m2->batches, 1u);
+}
+
+TEST(PiecewiseModel, evaluate_sorted_falls_back_on_unsorted_input) {
+    aip::model::PiecewiseModel<double, double, Interval> pm;
+    pm.add(Interval{0.0, 1.0}, std::make_shared<LinearModel>(1.0, 0.0));
+    pm.add(Interval{1.0, 2.0}, std::make_shared<LinearModel>(10.0, 0.0));
+
+    const std::vector<double> xs{1.5, 0.25, 1.0, std::numeric_limits<double>::quiet_NaN(), 0.5, 2.5, -1.0, 1.75};
+    std::vector<double> out(xs.size());
+    pm.evaluateSorted(xs, out);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        const double y = pm(xs[i]);
+        if (std::isnan(y)) {
+            EXPECT_TRUE(std::isnan(out[i])) << i;
+        } else {
+            EXPECT_DOUBLE_EQ(out[i], y) << i;
+        }
+    }
+
+    std::vector<double> small(1);
+    EXPECT_THROW(pm.evaluateSorted(xs, small), std::invalid_argument);
+}
+
+// Интервал, считающий вызовы предиката.
+struct CountingInterval {
+    double a{}, b{};
+    std::size_t* calls{};
+    bool operator()(const double& x) const noexcept {
+        ++*calls;
+        return a <= x && x <= b;
+    }
+};
+
+template <>
+struct aip::model::IntervalDomainTraits<CountingInterval> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const CountingInterval& d) noexcept { return {d.a, d.b}; }
+};
+
+TEST(PiecewiseModel, sorted_cursor_is_reusable_and_does_not_query_domains) {
+    std::size_t calls = 0;
+    aip::model::PiecewiseModel<double, double, CountingInterval> pm;
+    pm.add(CountingInterval{0.0, 1.0, &calls}, std::make_shared<LinearModel>(1.0, 0.0));
+    pm.add(CountingInterval{1.0, 2.0, &calls}, std::make_shared<LinearModel>(10.0, 0.0));
+    pm.add(CountingInterval{3.0, 4.0, &calls}, std::make_shared<LinearModel>(-1.0, 0.0));
+
+    const auto cursor = pm.sortedCursor();
+    calls = 0;
+    for (int pass = 0; pass < 3; ++pass) {
+        std::vector<double> xs;
+        for (int i = 0; i <= 200; ++i) xs.push_back(-0.5 + (5.0 + pass) * i / 200.0);
+        std::vector<double> out(xs.size());
+        cursor.evaluate(xs, out);
+        EXPECT_EQ(calls, 0u);
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            const double y = pm(xs[i]);
+            if (std::isnan(y)) {
+                EXPECT_TRUE(std::isnan(out[i])) << xs[i];
+            } else {
+                EXPECT_DOUBLE_EQ(out[i], y) << xs[i];
+            }
+        }
+        calls = 0;
+    }
+}
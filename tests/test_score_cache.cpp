@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/branch_and_bound.hpp>
+#include <aip/search/score_cache.hpp>
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+    void fingerprint(aip::core::Fingerprinter& f) const { f.add(lo).add(hi); }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+/// Line с версией кода: не constexpr, чтобы в одном бинаре сымитировать пересборку с новой версией.
+struct VersionedLine final : aip::model::IModel<double, double> {
+    static inline std::uint64_t kFingerprintVersion = 1;
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x; }
+};
+
+using Grid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+
+Grid grid(double step = 0.25) {
+    Grid g;
+    g.get<0>() = {-1.0, 1.0, step};
+    g.get<1>() = {-1.0, 1.0, 0.5};
+    return g;
+}
+
+struct TempFile {
+    std::filesystem::path path;
+    explicit TempFile(const std::string& name) : path(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove(path);
+    }
+    ~TempFile() { std::filesystem::remove(path); }
+};
+
+}  // namespace
+
+TEST(Fingerprint, entry_fingerprint_tracks_grid_and_domain) {
+    Orch a, b;
+    a.add(Seg{0.0, 1.0}, grid());
+    a.add(Seg{1.0, 2.0}, grid());
+    b.add(Seg{0.0, 1.0}, grid());
+    b.add(Seg{1.0, 2.0}, grid(0.5));
+
+    ASSERT_TRUE(a[0].fingerprint().has_value());
+    EXPECT_EQ(*a[0].fingerprint(), *b[0].fingerprint());
+    EXPECT_NE(*a[1].fingerprint(), *b[1].fingerprint());  // другой шаг решётки
+    EXPECT_NE(*a[0].fingerprint(), *a[1].fingerprint());  // другой домен
+
+    // -0 и +0 неразличимы
+    EXPECT_EQ(aip::core::fingerprintOf(-0.0), aip::core::fingerprintOf(0.0));
+    EXPECT_NE(aip::core::fingerprintOf(1.0), aip::core::fingerprintOf(2.0));
+}
+
+TEST(Fingerprint, entry_fingerprint_tracks_model_version) {
+    aip::params::ParamGrid<VersionedLine, aip::params::UniformRange, &VersionedLine::k> g;
+    g.get<0>() = {-1.0, 1.0, 0.5};
+    Orch orch;
+    orch.add(Seg{0.0, 1.0}, g);
+
+    const auto v1 = orch[0].fingerprint();
+    VersionedLine::kFingerprintVersion = 2;
+    const auto v2 = orch[0].fingerprint();
+    VersionedLine::kFingerprintVersion = 1;
+
+    ASSERT_TRUE(v1.has_value() && v2.has_value());
+    EXPECT_NE(*v1, *v2);
+    EXPECT_EQ(*orch[0].fingerprint(), *v1);
+}
+
+TEST(Fingerprint, raw_bytes_only_for_unique_object_representations) {
+    struct Packed {
+        std::int32_t a, b;
+    };
+    struct Padded {
+        char c;
+        std::int64_t v;
+    };
+    struct Doubles {
+        double lo, hi;
+    };
+    static int target = 0;
+
+    EXPECT_TRUE(aip::core::fingerprintOf(Packed{1, 2}).has_value());
+    EXPECT_NE(aip::core::fingerprintOf(Packed{1, 2}), aip::core::fingerprintOf(Packed{2, 1}));
+    EXPECT_FALSE(aip::core::fingerprintOf(Padded{'x', 1}).has_value());
+    EXPECT_FALSE(aip::core::fingerprintOf(Doubles{0.0, 1.0}).has_value());
+    EXPECT_FALSE(aip::core::fingerprintOf(&target).has_value());
+
+    // Домен без явного хешера — у сегмента нет отпечатка, кэш для него не используется.
+    struct RawSeg {
+        double lo{}, hi{};
+        constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+    };
+    aip::core::Orchestrator<double, double, RawSeg> raw;
+    raw.add(RawSeg{0.0, 1.0}, grid());
+    EXPECT_FALSE(raw[0].fingerprint().has_value());
+}
+
+TEST(ScoreCache, persists_across_reopen_and_grows) {
+    TempFile tmp("aip_test_score_cache.bin");
+    const aip::core::Fingerprint k1{1, 2}, k2{3, 4};
+    {
+        aip::search::ScoreCache cache(tmp.path, 16);
+        for (std::size_t i = 0; i < 100; ++i) cache.store(k1, i, static_cast<double>(i) * 0.5);
+        cache.store(k2, 7, -1.0);
+        cache.store(k2, 7, -2.0);  // перезапись
+        EXPECT_EQ(cache.size(), 101u);
+        EXPECT_GE(cache.capacity(), 128u);
+        cache.flush();
+    }
+
+    aip::search::ScoreCache cache(tmp.path);
+    EXPECT_EQ(cache.size(), 101u);
+    for (std::size_t i = 0; i < 100; ++i) {
+        const auto v = cache.find(k1, i);
+        ASSERT_TRUE(v.has_value());
+        EXPECT_DOUBLE_EQ(*v, static_cast<double>(i) * 0.5);
+    }
+    EXPECT_DOUBLE_EQ(*cache.find(k2, 7), -2.0);
+    EXPECT_FALSE(cache.find(k2, 8).has_value());
+    EXPECT_FALSE(cache.find(k1, 100).has_value());
+}
+
+TEST(ScoreCache, rejects_foreign_files) {
+    TempFile tmp("aip_test_score_cache_foreign.bin");
+    std::ofstream(tmp.path) << "definitely not a cache file, but long enough to hold a header";
+    EXPECT_THROW(aip::search::ScoreCache{tmp.path}, std::runtime_error);
+}
+
+TEST(ScoreCache, rejects_corrupted_capacity_and_count) {
+    TempFile tmp("aip_test_score_cache_corrupt.bin");
+    // Заголовок: magic[8], version, reserved, capacity (смещение 16), count (смещение 24).
+    const auto patch = [&](std::streamoff offset, std::uint64_t value) {
+        { aip::search::ScoreCache{tmp.path, 16}; }
+        std::fstream f(tmp.path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offset);
+        f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    patch(16, 0);
+    EXPECT_THROW(aip::search::ScoreCache{tmp.path}, std::runtime_error);
+
+    // размер файла согласован с capacity — ловит только проверка степени двойки
+    std::filesystem::remove(tmp.path);
+    patch(16, 12);
+    std::filesystem::resize_file(tmp.path, 32 + 12 * 32);
+    EXPECT_THROW(aip::search::ScoreCache{tmp.path}, std::runtime_error);
+
+    std::filesystem::remove(tmp.path);
+    patch(24, 16);
+    EXPECT_THROW(aip::search::ScoreCache{tmp.path}, std::runtime_error);
+}
+
+TEST(ScoreCache, unchanged_entries_are_not_reevaluated) {
+    TempFile tmp("aip_test_score_cache_bnb.bin");
+
+    std::vector<double> xs, ys;
+    for (int i = 0; i < 200; ++i) {
+        const double x = i * 0.01;
+        xs.push_back(x);
+        ys.push_back(x < 1.0 ? 0.5 * x - 0.5 : -0.25 * x + 1.0);
+    }
+
+    Orch orch;
+    orch.add(Seg{0.0, 1.0}, grid());
+    orch.add(Seg{1.0, 2.0}, grid());
+
+    aip::search::ScoreCache cache(tmp.path);
+    aip::search::BranchAndBoundOptions opt;
+    opt.cache = &cache;
+    opt.threadCount = 2;
+
+    const auto cold = aip::search::branchAndBound(orch, std::span<const double>(xs), std::span<const double>(ys), opt);
+    EXPECT_EQ(cache.size(), orch[0].size() + orch[1].size());
+    EXPECT_EQ(cache.hits(), 0u);
+
+    // тот же запуск: всё из кэша, результат идентичен
+    const auto warm = aip::search::branchAndBound(orch, std::span<const double>(xs), std::span<const double>(ys), opt);
+    EXPECT_EQ(cache.hits(), cache.size());
+    EXPECT_EQ(warm.global, cold.global);
+    EXPECT_DOUBLE_EQ(warm.loss, cold.loss);
+
+    // меняются данные второго сегмента: первый берётся из кэша, второй пересчитывается
+    ys.back() += 1.0;
+    const std::size_t hitsBefore = cache.hits();
+    const auto changed =
+        aip::search::branchAndBound(orch, std::span<const double>(xs), std::span<const double>(ys), opt);
+    EXPECT_EQ(cache.hits() - hitsBefore, orch[0].size());
+    EXPECT_EQ(cache.size(), orch[0].size() + 2 * orch[1].size());
+
+    opt.cache = nullptr;
+    const auto fresh = aip::search::branchAndBound(orch, std::span<const double>(xs), std::span<const double>(ys), opt);
+    EXPECT_EQ(changed.global, fresh.global);
+    EXPECT_DOUBLE_EQ(changed.loss, fresh.loss);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <optional>
+
+#include <aip/model/imodel.hpp>
+#include <aip/params/unit_grid.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/search/enumeration_strategy.hpp>
+#include <aip/search/reverse_enumeration_strategy.hpp>
+
+namespace {
+
+struct Always {
+    constexpr bool operator()(const double&) const noexcept { return true; }
+};
+
+struct M final : aip::model::IModel<double, double> {
+    double a{};
+    double b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return a * x + b; }
+};
+
+using Grid = aip::params::ParamGrid<M, aip::params::UniformRange, &M::a, &M::b>;
+
+/// Только next(): проверяет поэлементный путь сегмента и nextGlobals().
+template <std::size_t N>
+class PlainStrategy {
+   public:
+    using index_type = std::array<std::size_t, N>;
+
+    void reset(const aip::search::IndexSpace<N>& s) noexcept { inner_.reset(s); }
+    [[nodiscard]] std::optional<index_type> next() noexcept { return inner_.next(); }
+
+   private:
+    aip::search::ReverseEnumerationStrategy<N> inner_;
+};
+
+static_assert(aip::search::BatchStrategy<aip::search::EnumerationStrategy<2>, 2>);
+static_assert(aip::search::BatchStrategy<aip::search::ReverseEnumerationStrategy<2>, 2>);
+static_assert(!aip::search::BatchStrategy<PlainStrategy<2>, 2>);
+
+// Сегмент со стратегией без nextBatch() не несёт буфер блока индексов.
+static_assert(sizeof(aip::core::detail::FreeEntry<double, double, Always, Grid, PlainStrategy>) <
+              sizeof(std::array<std::array<std::size_t, 2>, 64>));
+
+Grid grid(double aMax, double bMax) {
+    Grid g;
+    g.get<0>() = {0.0, aMax, 1.0};
+    g.get<1>() = {0.0, bMax, 1.0};
+    return g;
+}
+
+template <class Orch>
+void build(Orch& orch) {
+    orch.add(Always{}, grid(4.0, 1.0));  // 5 x 2
+    orch.add(Always{}, grid(1.0, 2.0));  // 2 x 3
+    orch.add(Always{}, grid(2.0, 0.0));  // 3 x 1
+}
+
+template <template <std::size_t> class S>
+void expectBatchMatchesNext(std::size_t block, std::size_t skip) {
+    const auto space = aip::search::make_index_space(grid(3.0, 4.0));
+    S<2> a, b;
+    a.reset(space);
+    b.reset(space);
+    (void)a.next();
+    (void)b.next();
+    a.skip(skip);
+    b.skip(skip);
+
+    std::vector<std::array<std::size_t, 2>> expected, got;
+    while (auto v = a.next()) expected.push_back(*v);
+
+    std::vector<std::array<std::size_t, 2>> buf(block);
+    for (std::size_t n; (n = b.nextBatch(buf)) > 0;) {
+        got.insert(got.end(), buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+        if (n < block) {
+            EXPECT_EQ(b.nextBatch(buf), 0u);
+        }
+    }
+    EXPECT_EQ(got, expected) << "block=" << block << " skip=" << skip;
+}
+
+template <class Orch>
+std::vector<std::size_t> byOne(Orch& orch) {
+    std::vector<std::size_t> out;
+    orch.reset();
+    while (auto g = orch.nextGlobal()) out.push_back(*g);
+    return out;
+}
+
+template <class Orch>
+std::vector<std::size_t> byBlocks(Orch& orch, std::size_t block) {
+    std::vector<std::size_t> out, buf(block);
+    orch.reset();
+    for (std::size_t n; (n = orch.nextGlobals(buf)) > 0;) out.insert(out.end(), buf.begin(), buf.begin() + n);
+    return out;
+}
+
+template <class Orch>
+void expectBlocksMatch(Orch& orch) {
+    const auto expected = byOne(orch);
+    ASSERT_EQ(expected.size(), orch.size());
+    for (std::size_t block : {1u, 3u, 7u, 10u, 64u, 1000u}) EXPECT_EQ(byBlocks(orch, block), expected) << block;
+}
+
+}  // namespace
+
+TEST(StrategyBatch, next_batch_matches_next) {
+    for (std::size_t block : {1u, 2u, 3u, 5u, 8u, 64u}) {
+        for (std::size_t skip : {0u, 1u, 4u, 11u, 30u}) {
+            expectBatchMatchesNext<aip::search::EnumerationStrategy>(block, skip);
+            expectBatchMatchesNext<aip::search::ReverseEnumerationStrategy>(block, skip);
+        }
+    }
+}
+
+TEST(StrategyBatch, next_globals_matches_next_global) {
+    aip::core::Orchestrator<double, double, Always> fwd;
+    aip::core::Orchestrator<double, double, Always, aip::search::ReverseEnumerationStrategy> rev;
+    aip::core::Orchestrator<double, double, Always, PlainStrategy> plain;
+    build(fwd);
+    build(rev);
+    build(plain);
+
+    expectBlocksMatch(fwd);
+    expectBlocksMatch(rev);
+    expectBlocksMatch(plain);
+}
+
+TEST(StrategyBatch, next_globals_interleaves_with_next) {
+    aip::core::Orchestrator<double, double, Always, aip::search::ReverseEnumerationStrategy> orch;
+    build(orch);
+    const auto expected = byOne(orch);
+
+    std::vector<std::size_t> got, buf(4);
+    orch.reset();
+    for (;;) {
+        auto pm = orch.next();
+        if (!pm) break;
+        got.push_back(expected[got.size()]);
+        EXPECT_DOUBLE_EQ((*pm)(2.0), orch.makePiecewise(got.back())(2.0));
+
+        const std::size_t n = orch.nextGlobals(buf);
+        got.insert(got.end(), buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+        if (n < buf.size()) break;
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_FALSE(orch.nextGlobal().has_value());
+    EXPECT_EQ(orch.nextGlobals(buf), 0u);
+}
+
+TEST(StrategyBatch, single_entry_and_unit_grid) {
+    aip::core::Orchestrator<double, double, Always> one;
+    one.add(Always{}, grid(6.0, 2.0));
+    expectBlocksMatch(one);
+
+    aip::core::Orchestrator<double, double, Always> withUnit;
+    withUnit.add(Always{}, grid(1.0, 1.0));
+    withUnit.addConstrained(Always{}, aip::params::UnitGrid<M>{}, 0.0, 1.0, [](M&, const double&, const double&) {});
+    withUnit.add(Always{}, grid(2.0, 0.0));
+    expectBlocksMatch(withUnit);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <vector>
+#include <algorithm>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/successive_halving.hpp>
+
+namespace {
+
+struct Half {
+    bool left{};
+    constexpr bool operator()(const double& x) const noexcept { return left ? x < 0.0 : x >= 0.0; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+using Grid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+
+}  // namespace
+
+TEST(SuccessiveHalving, stratified_sample_keeps_every_stratum) {
+    std::vector<std::size_t> strata(1000, 0);
+    for (std::size_t i = 990; i < 1000; ++i) strata[i] = 1;  // маленький страт
+
+    const auto s = aip::search::stratifiedSample(strata, 0.01, 3, 42);
+    std::size_t inSmall = 0;
+    for (auto i : s) inSmall += (strata[i] == 1);
+
+    EXPECT_GE(inSmall, 3u);
+    EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+    EXPECT_EQ(s.size(), 10u + inSmall);
+}
+
+TEST(SuccessiveHalving, finds_true_configuration_with_fewer_evaluations) {
+    Grid g;
+    g.get<0>() = {-2.0, 2.0, 0.5};  // 9
+    g.get<1>() = {-1.0, 1.0, 0.5};  // 5
+
+    aip::core::Orchestrator<double, double, Half> orch;
+    orch.add(Half{true}, g);
+    orch.add(Half{false}, g);
+
+    std::vector<double> xs, ys;
+    for (int i = -500; i < 500; ++i) {
+        const double x = i / 100.0;
+        xs.push_back(x);
+        ys.push_back(x < 0.0 ? (1.5 * x - 0.5) : (-1.0 * x + 1.0));
+    }
+
+    aip::search::HalvingOptions opt;
+    opt.initialFraction = 1.0 / 32.0;
+    opt.topK = 3;
+    opt.threadCount = 4;
+
+    const auto res =
+        aip::search::successiveHalving(orch, std::span<const double>(xs), std::span<const double>(ys), opt);
+
+    ASSERT_EQ(res.best.size(), 3u);
+    EXPECT_DOUBLE_EQ(res.best[0].score, 0.0);
+
+    const auto pm = orch.makePiecewise(res.best[0].global);
+    EXPECT_DOUBLE_EQ(pm(-1.0), -2.0);
+    EXPECT_DOUBLE_EQ(pm(2.0), -1.0);
+
+    EXPECT_GT(res.rounds, 1u);
+    EXPECT_LT(res.pointEvaluations, res.fullPointEvaluations);
+    EXPECT_GT(res.fullEvaluationsSaved(), 0.5 * static_cast<double>(res.candidates));
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include <aip/model/imodel.hpp>
+#include <aip/model/piecewise_model.hpp>
+#include <aip/model/tabulated_model.hpp>
+
+namespace {
+
+struct Sine final : aip::model::IModel<double, double> {
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return std::sin(x); }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    double k{}, b{};
+    Line(double kk, double bb) : k(kk), b(bb) {}
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k * x + b; }
+};
+
+/// Полуинтервал [lo, hi) с трейтами интервала.
+struct HalfOpen {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+/// Отрезок [lo, hi] или (lo, hi] — концы решает предикат.
+struct ClosedRight {
+    double lo{}, hi{};
+    bool openLo{false};
+    constexpr bool operator()(const double& x) const noexcept { return (openLo ? x > lo : x >= lo) && x <= hi; }
+};
+
+}  // namespace
+
+template <>
+struct aip::model::IntervalDomainTraits<HalfOpen> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const HalfOpen& d) noexcept { return {d.lo, d.hi}; }
+};
+
+template <>
+struct aip::model::IntervalDomainTraits<ClosedRight> {
+    static constexpr bool enabled = true;
+    static std::pair<double, double> bounds(const ClosedRight& d) noexcept { return {d.lo, d.hi}; }
+};
+
+TEST(TabulatedModel, meets_error_bound_and_cubic_needs_fewer_cells) {
+    const Sine model;
+    const double tol = 1e-7;
+    const auto cubic = aip::model::tabulate(model, 0.0, 10.0, {.maxAbsError = tol});
+    const auto linear = aip::model::tabulate(model, 0.0, 10.0,
+                                             {.maxAbsError = tol, .interpolation = aip::model::Interpolation::Linear});
+
+    EXPECT_TRUE(cubic.withinBound());
+    EXPECT_TRUE(linear.withinBound());
+    EXPECT_LT(cubic.cellCount(), linear.cellCount());
+    EXPECT_LE(cubic.maxError(), tol);
+
+    for (double x = 0.0; x <= 10.0; x += 0.001) {
+        EXPECT_NEAR(cubic(x), model(x), 2 * tol);
+        EXPECT_NEAR(linear(x), model(x), 2 * tol);
+    }
+    EXPECT_NEAR(cubic(10.0), model(10.0), 2 * tol);
+}
+
+TEST(TabulatedModel, piecewise_boundaries_and_gaps_are_exact) {
+    aip::model::PiecewiseModel<double, double, HalfOpen> pm;
+    pm.add(HalfOpen{0.0, 1.0}, std::make_shared<Line>(1.0, 0.0));
+    pm.add(HalfOpen{1.0, 2.0}, std::make_shared<Line>(0.0, 5.0));  // скачок в x = 1
+    pm.add(HalfOpen{3.0, 4.0}, std::make_shared<Line>(-1.0, 0.0));  // пробел [2, 3)
+
+    const auto table = aip::model::tabulate(pm, 0.0, 4.0, {.maxAbsError = 1e-9});
+    EXPECT_TRUE(table.withinBound());
+    EXPECT_NEAR(table(std::nextafter(1.0, 0.0)), 1.0, 1e-9);
+    EXPECT_DOUBLE_EQ(table(1.0), 5.0);
+    EXPECT_TRUE(std::isnan(table(2.5)));
+    EXPECT_NEAR(table(3.5), -3.5, 1e-9);
+    EXPECT_TRUE(std::isnan(table(4.0)));  // [3, 4) не содержит 4
+
+    EXPECT_TRUE(std::isnan(table(-0.1)));
+    EXPECT_TRUE(std::isnan(table(4.1)));
+    EXPECT_TRUE(std::isnan(table(std::numeric_limits<double>::quiet_NaN())));
+}
+
+TEST(TabulatedModel, boundary_points_follow_domain_predicate) {
+    aip::model::PiecewiseModel<double, double, ClosedRight> pm;
+    pm.add(ClosedRight{0.0, 1.0}, std::make_shared<Line>(1.0, 0.0));         // [0, 1]
+    pm.add(ClosedRight{1.0, 2.0, true}, std::make_shared<Line>(0.0, 5.0));   // (1, 2]
+    pm.add(ClosedRight{3.0, 4.0, true}, std::make_shared<Line>(-1.0, 0.0));  // (3, 4], пробел (2, 3]
+
+    const auto table = aip::model::tabulate(pm, 0.0, 4.0, {.maxAbsError = 1e-9});
+    const std::vector<double> xs{0.0, 1.0, std::nextafter(1.0, 2.0), 2.0, 2.5, 3.0, std::nextafter(3.0, 4.0), 4.0};
+    for (const double x : xs) {
+        if (std::isnan(pm(x))) {
+            EXPECT_TRUE(std::isnan(table(x))) << "x = " << x;
+        } else {
+            EXPECT_NEAR(table(x), pm(x), 1e-9) << "x = " << x;
+        }
+    }
+    EXPECT_DOUBLE_EQ(table(1.0), 1.0);  // точка 1 — у [0, 1], а не у правого куска
+    EXPECT_DOUBLE_EQ(table(2.0), 5.0);
+    EXPECT_TRUE(std::isnan(table(3.0)));
+
+    std::vector<double> out(xs.size());
+    table.evaluate(std::span<const double>(xs), std::span<double>(out));
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        if (std::isnan(table(xs[i]))) {
+            EXPECT_TRUE(std::isnan(out[i]));
+        } else {
+            EXPECT_DOUBLE_EQ(out[i], table(xs[i]));
+        }
+    }
+
+    const Line line(1.0, 0.0);
+    const std::vector<aip::model::TabulatedModel<double, double>::Piece> pieces{{0.0, 1.0, &line}};
+    const std::vector<aip::model::TabulatedModel<double, double>::Point> inside{{0.5, nullptr}};
+    EXPECT_THROW((aip::model::TabulatedModel<double, double>(pieces, {}, inside)), std::invalid_argument);
+}
+
+TEST(TabulatedModel, explicit_breaks_become_cell_boundaries) {
+    const Line model(2.0, 1.0);
+    const std::vector<double> breaks{0.3, 7.0, -5.0};  // -5 вне отрезка и игнорируется
+    const auto table = aip::model::tabulate(model, 0.0, 1.0, {}, std::span<const double>(breaks));
+    EXPECT_EQ(table.cellCount(), 2u);  // линейную модель каждый кусок передаёт одной ячейкой
+    EXPECT_NEAR(table(0.3), 1.6, 1e-12);
+}
+
+TEST(TabulatedModel, batch_evaluation_matches_scalar) {
+    const Sine model;
+    const auto table = aip::model::tabulate(model, -3.0, 3.0, {.maxAbsError = 1e-5});
+
+    std::vector<double> xs;
+    for (int i = 0; i < 203; ++i) xs.push_back(std::fmod(i * 0.731, 7.0) - 3.5);  // вперемешку и за краями
+    xs.push_back(std::numeric_limits<double>::quiet_NaN());
+    std::vector<double> out(xs.size());
+    table.evaluate(std::span<const double>(xs), std::span<double>(out));
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        const double s = table(xs[i]);
+        if (std::isnan(s)) {
+            EXPECT_TRUE(std::isnan(out[i]));
+        } else {
+            EXPECT_DOUBLE_EQ(s, out[i]);
+        }
+    }
+
+    std::vector<double> small(1);
+    EXPECT_THROW(table.evaluate(std::span<const double>(xs), std::span<double>(small)), std::invalid_argument);
+}
+
+TEST(TabulatedModel, cell_budget_and_invalid_arguments) {
+    const Sine model;
+    const auto coarse = aip::model::tabulate(model, 0.0, 100.0, {.maxAbsError = 1e-12, .maxCells = 16});
+    EXPECT_LE(coarse.cellCount(), 16u);
+    EXPECT_FALSE(coarse.withinBound());
+    EXPECT_GT(coarse.maxError(), 1e-12);
+
+    EXPECT_THROW(aip::model::tabulate(model, 1.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(aip::model::tabulate(model, 0.0, 1.0, {.maxAbsError = 0.0}), std::invalid_argument);
+}
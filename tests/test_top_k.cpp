@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+
+#include <aip/search/top_k.hpp>
+
+TEST(TopK, keeps_k_smallest_sorted) {
+    aip::search::TopK<double> top(3);
+    const double scores[] = {5.0, 1.0, 4.0, 2.0, 3.0, 0.5};
+    for (std::size_t g = 0; g < 6; ++g) top.push(g, scores[g]);
+
+    const auto out = top.sorted();
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0].global, 5u);
+    EXPECT_EQ(out[1].global, 1u);
+    EXPECT_EQ(out[2].global, 3u);
+    EXPECT_DOUBLE_EQ(top.worst().score, 2.0);
+}
+
+TEST(TopK, greater_keeps_largest_and_ignores_nan) {
+    aip::search::TopK<double, std::greater<double>> top(2);
+    top.push(0, 0.1);
+    top.push(1, std::nan(""));
+    top.push(2, 0.9);
+    top.push(3, 0.5);
+
+    const auto out = top.sorted();
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].global, 2u);
+    EXPECT_EQ(out[1].global, 3u);
+}
+
+TEST(TopK, merge_is_order_independent_on_ties) {
+    aip::search::TopK<double> a(2), b(2);
+    a.push(7, 1.0);
+    a.push(3, 1.0);
+    b.push(1, 1.0);
+    b.push(9, 1.0);
+
+    aip::search::TopK<double> ab = a, ba = b;
+    ab.merge(b);
+    ba.merge(a);
+
+    EXPECT_EQ(ab.sorted(), ba.sorted());
+    EXPECT_EQ(ab.sorted()[0].global, 1u);
+    EXPECT_EQ(ab.sorted()[1].global, 3u);
+}
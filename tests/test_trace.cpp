@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <sstream>
+
+#include <aip/profile/trace.hpp>
+
+namespace {
+
+using aip::profile::TraceChunkScope;
+using aip::profile::TraceOptions;
+using aip::profile::Tracer;
+using aip::profile::TraceScope;
+
+std::size_t countOf(const std::string& s, const std::string& what) {
+    std::size_t n = 0;
+    for (auto p = s.find(what); p != std::string::npos; p = s.find(what, p + 1)) ++n;
+    return n;
+}
+
+}  // namespace
+
+TEST(Trace, inactive_tracer_records_nothing) {
+    auto& t = Tracer::instance();
+    t.start();
+    t.stop();
+    { TraceScope s("build", "model"); }
+    EXPECT_TRUE(t.events().empty());
+}
+
+TEST(Trace, nested_scopes_are_recorded) {
+    auto& t = Tracer::instance();
+    t.start();
+    {
+        TraceScope outer("evaluate", "model");
+        TraceScope inner("score", "model");
+    }
+    t.stop();
+
+    const auto ev = t.events();
+    ASSERT_EQ(ev.size(), 2u);
+    EXPECT_STREQ(ev[0].second.name, "evaluate");  // начался раньше
+    EXPECT_STREQ(ev[1].second.name, "score");
+    EXPECT_LE(ev[0].second.startNanos, ev[1].second.startNanos);
+    EXPECT_GE(ev[0].second.durationNanos, ev[1].second.durationNanos);
+}
+
+TEST(Trace, chunk_sampling_skips_nested_spans) {
+    auto& t = Tracer::instance();
+    t.start(TraceOptions{1024, 4});
+    for (std::size_t c = 0; c < 8; ++c) {
+        TraceChunkScope chunk(c);
+        TraceScope s("evaluate", "model");
+    }
+    { TraceScope merge("merge", "search"); }  // вне чанков пишется всегда
+    t.stop();
+
+    std::size_t chunks = 0, evals = 0, merges = 0;
+    for (const auto& [tid, e] : t.events()) {
+        const std::string n = e.name;
+        if (n == "chunk") {
+            ++chunks;
+            EXPECT_EQ(e.arg % 4, 0);
+        }
+        evals += n == "evaluate";
+        merges += n == "merge";
+    }
+    EXPECT_EQ(chunks, 2u);
+    EXPECT_EQ(evals, 2u);
+    EXPECT_EQ(merges, 1u);
+}
+
+TEST(Trace, ring_buffer_keeps_newest_and_counts_dropped) {
+    auto& t = Tracer::instance();
+    t.start(TraceOptions{16, 1});
+    for (int i = 0; i < 40; ++i) TraceScope s("build", "model");
+    t.stop();
+
+    EXPECT_EQ(t.events().size(), 16u);
+    EXPECT_EQ(t.dropped(), 24u);
+}
+
+TEST(Trace, per_thread_buffers_and_chrome_json) {
+    auto& t = Tracer::instance();
+    t.start();
+    std::vector<std::thread> ts;
+    for (int k = 0; k < 3; ++k)
+        ts.emplace_back([k] {
+            TraceChunkScope chunk(static_cast<std::size_t>(k));
+            TraceScope s("evaluate", "model");
+        });
+    for (auto& th : ts) th.join();
+    t.stop();
+
+    std::ostringstream os;
+    t.writeChromeTrace(os);
+    const std::string json = os.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"X\""), 6u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"M\""), 3u);
+    EXPECT_EQ(countOf(json, "\"args\":{\"index\":"), 3u);
+    EXPECT_NE(json.find("\n]}\n"), std::string::npos);
+}
+
+TEST(Trace, exited_threads_keep_events_and_free_their_buffers) {
+    auto& t = Tracer::instance();
+    t.start();
+    std::thread([] { TraceScope s("build", "model"); }).join();
+    const std::size_t buffers = t.bufferCount();
+    for (int k = 0; k < 31; ++k) std::thread([] { TraceScope s("build", "model"); }).join();
+    t.stop();
+
+    EXPECT_EQ(t.bufferCount(), buffers);
+    const auto events = t.events();
+    ASSERT_EQ(events.size(), 32u);
+    for (std::size_t i = 1; i < events.size(); ++i) EXPECT_LT(events[i - 1].first, events[i].first);  // свой tid
+
+    // События завершившихся потоков сверх retiredCapacity теряются и учитываются в dropped().
+    t.start(TraceOptions{16, 1, 10});
+    for (int k = 0; k < 20; ++k) std::thread([] { TraceScope s("build", "model"); }).join();
+    t.stop();
+    EXPECT_EQ(t.events().size(), 10u);
+    EXPECT_EQ(t.dropped(), 10u);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+#include <aip/core/fixed_string.hpp>
+#include <aip/model/imodel.hpp>
+#include <aip/params/control_param.hpp>
+#include <aip/params/param_grid.hpp>
+#include <aip/params/uniform_range.hpp>
+#include <aip/core/orchestrator.hpp>
+#include <aip/search/parallel_async.hpp>
+#include <aip/search/visited_set.hpp>
+
+namespace {
+
+struct Seg {
+    double lo{}, hi{};
+    constexpr bool operator()(const double& x) const noexcept { return x >= lo && x < hi; }
+};
+
+struct Line final : aip::model::IModel<double, double> {
+    aip::params::ControlParam<double, aip::core::fixed_string{"k"}> k{};
+    aip::params::ControlParam<double, aip::core::fixed_string{"b"}> b{};
+
+    [[nodiscard]] double operator()(const double& x) const noexcept override { return k.value * x + b.value; }
+};
+
+using Grid = aip::params::ParamGrid<Line, aip::params::UniformRange, &Line::k, &Line::b>;
+using Orch = aip::core::Orchestrator<double, double, Seg>;
+
+Grid grid() {
+    Grid g;
+    g.get<0>() = {0.0, 1.0, 0.5};  // 3
+    g.get<1>() = {0.0, 1.0, 1.0};  // 2
+    return g;
+}
+
+}  // namespace
+
+TEST(VisitedSet, bitmap_and_sharded_agree) {
+    aip::search::VisitedSet dense(1000);
+    aip::search::VisitedSet sparse(1000, /*denseLimit=*/10);
+    EXPECT_TRUE(dense.isDense());
+    EXPECT_FALSE(sparse.isDense());
+
+    for (auto* s : {&dense, &sparse}) {
+        EXPECT_TRUE(s->testAndSet(0));
+        EXPECT_TRUE(s->testAndSet(999));
+        EXPECT_FALSE(s->testAndSet(0));
+        EXPECT_TRUE(s->contains(999));
+        EXPECT_FALSE(s->contains(500));
+        EXPECT_EQ(s->count(), 2u);
+        s->clear();
+        EXPECT_EQ(s->count(), 0u);
+    }
+
+    aip::search::VisitedBitmap bm(10);
+    EXPECT_THROW(bm.testAndSet(10), std::out_of_range);
+}
+
+TEST(VisitedSet, concurrent_test_and_set_claims_each_global_once) {
+    constexpr std::size_t n = 10000;
+    aip::search::VisitedBitmap bm(n);
+    std::atomic<std::size_t> claimed{0};
+
+    // каждый global предлагается 4 раза
+    aip::search::parallelForIndicesAsync(
+        0, 4 * n,
+        [&](std::size_t i) {
+            if (bm.testAndSet(i % n)) claimed.fetch_add(1);
+            return 0;
+        },
+        8);
+    EXPECT_EQ(claimed.load(), n);
+    EXPECT_EQ(bm.count(), n);
+}
+
+TEST(ScoreMemo, computes_each_global_exactly_once) {
+    aip::search::ScoreMemo<double> memo;
+    std::atomic<std::size_t> calls{0};
+    auto scorer = aip::search::memoize(
+        [&](std::size_t g) {
+            calls.fetch_add(1);
+            return static_cast<double>(g) * 0.5;
+        },
+        memo);
+
+    const auto scores = aip::search::parallelForIndicesAsync(
+        0, 4000, [&](std::size_t i) { return scorer(i % 100); }, 8);
+    for (std::size_t i = 0; i < scores.size(); ++i) EXPECT_DOUBLE_EQ(scores[i], static_cast<double>(i % 100) * 0.5);
+
+    EXPECT_EQ(calls.load(), 100u);
+    EXPECT_EQ(memo.misses(), 100u);
+    EXPECT_EQ(memo.hits(), 3900u);
+    EXPECT_EQ(memo.size(), 100u);
+    ASSERT_TRUE(memo.find(42).has_value());
+    EXPECT_DOUBLE_EQ(*memo.find(42), 21.0);
+    EXPECT_FALSE(memo.find(100).has_value());
+}
+
+TEST(ScoreMemo, failed_computation_is_retried) {
+    aip::search::ScoreMemo<double> memo;
+    EXPECT_THROW(memo.getOrCompute(1, [](std::size_t) -> double { throw std::runtime_error("boom"); }),
+                 std::runtime_error);
+    EXPECT_EQ(memo.size(), 0u);
+    EXPECT_DOUBLE_EQ(memo.getOrCompute(1, [](std::size_t) { return 7.0; }), 7.0);
+}
+
+TEST(VisitedSet, repeated_strategy_passes_yield_each_global_once) {
+    Orch orch;
+    orch.add(Seg{0.0, 1.0}, grid());
+    orch.add(Seg{1.0, 2.0}, grid());
+
+    // nextGlobal() обходит то же, что next(), и совпадает с makePiecewise(global)
+    std::vector<std::size_t> globals;
+    while (auto g = orch.nextGlobal()) globals.push_back(*g);
+    ASSERT_EQ(globals.size(), orch.size());
+    for (std::size_t i = 0; i < globals.size(); ++i) EXPECT_EQ(globals[i], i);
+
+    aip::search::VisitedSet visited(orch.size());
+    std::vector<std::size_t> seen;
+
+    orch.reset();
+    EXPECT_EQ(aip::search::forEachUnvisited(orch, visited, [&](std::size_t g) { seen.push_back(g); }), orch.size());
+
+    // рестарт стратегии: всё уже посещено
+    orch.reset();
+    EXPECT_EQ(aip::search::forEachUnvisited(orch, visited, [&](std::size_t g) { seen.push_back(g); }), 0u);
+    EXPECT_EQ(seen.size(), orch.size());
+}